@@ -0,0 +1,79 @@
+************************************************************************
+file with basedata            : generated
+initial value random generator: 0
+************************************************************************
+projects                      :  1
+jobs (incl. supersource/sink ):  14
+horizon                       :  100
+RESOURCES
+  - renewable                 :  2   R
+  - nonrenewable              :  2   N
+  - doubly constrained        :  0   D
+************************************************************************
+PROJECT INFORMATION:
+pronr.  #jobs rel.date duedate tardcost  MPM-Time
+    1     12      0       100        0       100
+************************************************************************
+PRECEDENCE RELATIONS:
+jobnr.    #modes  #successors   successors
+   1        1          1          2
+   2        3          2          3   4
+   3        3          2          5   6
+   4        3          2          5   7
+   5        3          2          6   8
+   6        3          1          14
+   7        3          3          8   9   10
+   8        3          2          10   11
+   9        3          1          10
+  10        3          2          12   13
+  11        3          1          14
+  12        3          1          13
+  13        3          1          14
+  14        1          0       
+************************************************************************
+REQUESTS/DURATIONS:
+jobnr. mode duration  R 1  R 2  N 1  N 2
+------------------------------------------------------------------------
+   1      1     0     0     0     0     0
+   2      1     2     8     0     0     0
+          2     6     5     0     0     0
+          3    10     2     0     0     0
+   3      1     1     8     0     5     9
+          2     6     7     0     5     7
+          3     9     4     0     3     3
+   4      1     1     0    10    10     0
+          2     2     0     4     7     0
+          3     8     0     1     3     0
+   5      1     2     7     0     0    10
+          2     8     5     0     0     8
+          3    10     5     0     0     5
+   6      1     2     0    10    10     0
+          2     3     0     5     4     0
+          3    10     0     5     1     0
+   7      1     1     9     4     6     0
+          2     5     8     1     5     0
+          3     6     7     1     3     0
+   8      1     1     0     6     9    10
+          2     6     0     6     3     7
+          3     6     0     1     2     3
+   9      1     5     0     0     0     9
+          2     6     0     0     0     6
+          3     7     0     0     0     4
+  10      1     7     9    10     8     6
+          2     7     6     9     4     6
+          3     7     6     3     1     1
+  11      1     2     0    10     0     0
+          2     7     0     5     0     0
+          3    10     0     4     0     0
+  12      1     3     0     4     0     7
+          2     7     0     4     0     3
+          3     7     0     2     0     1
+  13      1     4     7     0     0     0
+          2     5     3     0     0     0
+          3    10     1     0     0     0
+  14      1     0     0     0     0     0
+************************************************************************
+RESOURCEAVAILABILITIES:
+  R 1  R 2  N 1  N 2
+    8    7   14   18
+************************************************************************
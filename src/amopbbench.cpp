@@ -0,0 +1,142 @@
+#include <vector>
+#include <iostream>
+#include <chrono>
+#include <cstdlib>
+#include "errors.h"
+#include "arguments.h"
+#include "solvingarguments.h"
+#include "smtformula.h"
+
+using namespace std;
+using namespace arguments;
+using namespace smtapi;
+
+
+/*
+ * Enumeration of all the accepted program arguments
+ */
+enum ProgramArg {
+	GROUPS,
+	GROUP_SIZE,
+	MAX_COEF,
+	CAPACITY,
+	SEED,
+	AMOPB
+};
+
+
+/*
+ * Micro-benchmark of the AMO-PB encodings of the totalizer and sorting
+ * network families. Encodes a random constraint sum(Q*X) <= K with each
+ * encoding and reports the number of variables and clauses and the
+ * encoding time, followed by the sizes predicted by the cost model of
+ * AMOPB_AUTO.
+ */
+int main(int argc, char **argv) {
+	Arguments<ProgramArg> * pargs
+	= new Arguments<ProgramArg>(
+
+	//Program arguments
+	{
+	},
+	0,
+
+	//Program options
+	{
+	arguments::iop("n","groups",GROUPS,30,
+	"Number of AMO groups of the constraint. Default 30."),
+	arguments::iop("g","group-size",GROUP_SIZE,4,
+	"Number of terms of each AMO group. Default 4."),
+	arguments::iop("q","max-coef",MAX_COEF,100,
+	"Coefficients are drawn uniformly from [1,max-coef]. Default 100."),
+	arguments::iop("k","capacity",CAPACITY,0,
+	"Capacity K of the constraint. If 0, half of the sum of the largest coefficients of the groups. Default 0."),
+	arguments::iop("","seed",SEED,1,
+	"Seed of the random coefficients. Default 1."),
+	arguments::sop("b","bench-amopb",AMOPB,"all",
+	{"all","gt","ggt","rggt","rggtnor","mto","gmto","sorter","gpw","lpw","auto"},
+	"Encoding to benchmark. Default all.")
+	},
+	"Benchmark the totalizer, modulo totalizer and sorting network encodings of a random AMO-PB constraint."
+	);
+
+	SolvingArguments * sargs = SolvingArguments::readArguments(argc,argv,pargs);
+
+	int n = pargs->getIntOption(GROUPS);
+	int m = pargs->getIntOption(GROUP_SIZE);
+	int maxq = pargs->getIntOption(MAX_COEF);
+	int K = pargs->getIntOption(CAPACITY);
+	if(n < 1 || m < 1 || maxq < 1 || K < 0){
+		cerr << "Error: the number of groups, the group size and the maximum coefficient must be positive" << endl;
+		exit(BADARGUMENTS_ERROR);
+	}
+
+	srand(pargs->getIntOption(SEED));
+	vector<vector<int> > Q(n,vector<int>(m));
+	int summax = 0;
+	for(int i = 0; i < n; i++){
+		int max = 0;
+		for(int j = 0; j < m; j++){
+			Q[i][j] = 1 + rand()%maxq;
+			if(Q[i][j] > max)
+				max = Q[i][j];
+		}
+		summax += max;
+	}
+	if(K==0)
+		K = summax/2;
+
+	vector<pair<string,AMOPBEncoding> > encodings = {
+		{"gt",AMOPB_GT},
+		{"ggt",AMOPB_GGT},
+		{"rggt",AMOPB_RGGT},
+		{"rggtnor",AMOPB_RGGTnoR},
+		{"mto",AMOPB_MTO},
+		{"gmto",AMOPB_GMTO},
+		{"sorter",AMOPB_SORTER},
+		{"gpw",AMOPB_GPW},
+		{"lpw",AMOPB_LPW},
+		{"auto",AMOPB_AUTO}
+	};
+
+	string s_amopb = pargs->getStringOption(AMOPB);
+	cout << "c groups " << n << " size " << m << " K " << K << endl;
+	for(const pair<string,AMOPBEncoding> & enc : encodings){
+		if(s_amopb != "all" && s_amopb != enc.first)
+			continue;
+
+		SMTFormula * f = new SMTFormula();
+		vector<vector<literal> > X(n,vector<literal>(m));
+		for(int i = 0; i < n; i++)
+			for(int j = 0; j < m; j++)
+				X[i][j] = f->newBoolVar();
+		int nvars = f->getNBoolVars();
+
+		chrono::steady_clock::time_point start = chrono::steady_clock::now();
+		f->addAMOPB(Q,X,K,enc.second);
+		long ms = chrono::duration_cast<chrono::milliseconds>(chrono::steady_clock::now()-start).count();
+
+		cout << enc.first << "\tvars " << f->getNBoolVars()-nvars << "\tclauses " << f->getNClauses() << "\ttime " << ms << " ms" << endl;
+		delete f;
+	}
+
+	//Sizes predicted by the cost model, without encoding. They are added to the size of the
+	//preprocessing of the repeated coefficients, which the dry run encodes as the other ones
+	SMTFormula * f = new SMTFormula();
+	vector<vector<literal> > X(n,vector<literal>(m));
+	for(int i = 0; i < n; i++)
+		for(int j = 0; j < m; j++)
+			X[i][j] = f->newBoolVar();
+	int nvars = f->getNBoolVars();
+	f->addAMOPB(Q,X,K,AMOPB_DRYRUN);
+	int prevars = f->getNBoolVars()-nvars;
+	int preclauses = f->getNClauses();
+	for(const pair<const AMOPBEncoding,AMOPBSize> & p : f->getAMOPBPredictions())
+		cout << "c predicted " << SolvingArguments::getAMOPBEncodingName(p.first) << "\tvars " << p.second.vars+prevars
+			<< "\tclauses " << p.second.clauses+preclauses << endl;
+	delete f;
+
+	delete pargs;
+	delete sargs;
+	return 0;
+}
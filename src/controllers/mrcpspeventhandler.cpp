@@ -37,8 +37,7 @@ void MRCPSPEventHandler::afterSatisfiabilityCall(int lb, int ub, Encoder * encod
 		cout << encoder->getNTheoryConflicts() << ";";
 
 		//Preprocessing statistis
-		int total = instance->getNTWIncompatibilities() + instance->getNResourceDisjoints() + instance->getNPrecedenceIncompatibilities() + instance->getNResourceIncompatibilities();
-		cout << instance->getNTWIncompatibilities() << ";";
+		int total = instance->getNResourceDisjoints() + instance->getNPrecedenceIncompatibilities() + instance->getNResourceIncompatibilities();
 		cout << instance->getNResourceDisjoints() << ";";
 		cout << instance->getNPrecedenceIncompatibilities() << ";";
 		cout << instance->getNResourceIncompatibilities() << ";";
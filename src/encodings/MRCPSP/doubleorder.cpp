@@ -16,6 +16,9 @@ SMTFormula * DoubleOrder::encode(int lb, int ub){
 
    SMTFormula * f = new SMTFormula();
 
+	//The renewable resources are only checked where some activity can start
+	vector<bool> startevent;
+	ins->getStartEvents(ub,startevent);
 
 	for(int i=0;i<N+2; i++){
 
@@ -94,8 +97,9 @@ SMTFormula * DoubleOrder::encode(int lb, int ub){
 
       //Create variable x_{i,t,o}
 		for(int t=ESi; t < LCi; t++)
-			for(int m = 0; m < ins->getNModes(i); m++)
-				f->newBoolVar("x",i,t,m);
+			if(startevent[t])
+				for(int m = 0; m < ins->getNModes(i); m++)
+					f->newBoolVar("x",i,t,m);
 
 
 	}
@@ -108,6 +112,8 @@ SMTFormula * DoubleOrder::encode(int lb, int ub){
 	for(int i=0; i < N+2; i++){
 		for(int m = 0; m < ins->getNModes(i); m++){
 			for(int t=ins->ES(i); t < ins->LC(i,ub); t++){
+				if(!startevent[t])
+					continue;
 				boolvar x = f->bvar("x",i,t,m);
 				boolvar o = t <= ins->LS(i,ub) ? f->bvar("o",i,t) : f->trueVar();
 				boolvar o2 = t >= ins->EC(i) ? f->bvar("o'",i,t) : f->falseVar();
@@ -157,6 +163,8 @@ SMTFormula * DoubleOrder::encode(int lb, int ub){
 		vector<set<int> > groups;
 
 		for (int t=0;t<ub;t++) {
+			if(!startevent[t])
+				continue;
 			vector<vector<literal> > vars_group;
 			vector<vector<int> > coefs_group;
 			vector<int> vtasques;
@@ -172,6 +180,7 @@ SMTFormula * DoubleOrder::encode(int lb, int ub){
 				groups.clear();
 				ins->computeMinPathCover(vtasques,groups);
 			}
+			lastvtasques = vtasques;
 
 
 			for (const set<int> & group : groups) {
@@ -259,20 +268,94 @@ void DoubleOrder::setModel(const EncodedFormula & ef, int lb, int ub, const vect
 	}
 }
 
+//The modes and start times of the best known schedule, from which the rest of its variables are propagated
+bool DoubleOrder::getPhase(const EncodedFormula & ef, vector<literal> & phase) const{
+	int N = ins->getNActivities();
+	if(starts.size() != N+2)
+		return false;
+
+	for(int i = 1; i <= N+1; i++){
+		phase.push_back(ef.f->bvar("sm",i,modes[i]));
+		//A schedule found for a larger makespan may start out of the windows of the encoding
+		if(starts[i] < ins->ES(i) || starts[i] > ins->LS(i,ef.UB))
+			continue;
+		if(starts[i] < ins->LS(i,ef.UB))
+			phase.push_back(ef.f->bvar("o",i,starts[i]));
+		if(starts[i] > ins->ES(i))
+			phase.push_back(!ef.f->bvar("o",i,starts[i]-1));
+	}
+	return true;
+}
+
+//The start time window is given by the order variables of its bounds, which exist in [ES,LS]
+bool DoubleOrder::restrictActivity(const EncodedFormula & ef, int i, int mode, int minstart, int maxstart, vector<literal> & lits) const{
+	if(mode >= 0)
+		lits.push_back(ef.f->bvar("sm",i,mode));
+	int ESi = ins->ES(i);
+	int LSi = ins->LS(i,ef.UB);
+	if(minstart > LSi || maxstart < ESi || minstart > maxstart){
+		lits.push_back(ef.f->falseVar());
+		return true;
+	}
+	if(minstart > ESi)
+		lits.push_back(!ef.f->bvar("o",i,minstart-1));
+	if(maxstart < LSi)
+		lits.push_back(ef.f->bvar("o",i,maxstart));
+	return true;
+}
+
 bool DoubleOrder::narrowBounds(const EncodedFormula & ef, int lastLB, int lastUB, int lb, int ub){
 	int N = ins->getNActivities();
 
 	if(ub <= lastUB){
+		if(ub < ins->ES(N+1) || lb > ub){
+			ef.f->addEmptyClause();
+			return true;
+		}
 		ef.f->addClause(ef.f->bvar("o",N+1,ub));
+		if(lb > ins->ES(N+1))
+			ef.f->addClause(!ef.f->bvar("o",N+1,lb-1));
+		vector<bool> startevent;
+		ins->getStartEvents(ef.UB,startevent);
 		for(int i = 1; i <= N; i++)
-			for(int t = ins->LC(i,ub); t < ins->LC(i,lastUB); t++)
-				for(int g = 0; g < ins->getNModes(i); g++)
-					ef.f->addClause(!ef.f->bvar("x",i,t,g));
+			for(int t = max(ins->ES(i),ins->LC(i,ub)); t < ins->LC(i,lastUB); t++)
+				if(startevent[t])
+					for(int g = 0; g < ins->getNModes(i); g++)
+						ef.f->addClause(!ef.f->bvar("x",i,t,g));
 
 		return true;
 	}
 	else return false;
 }
 
+//The makespan is bounded through the order variables of the sink, which exist
+//for every value in [ES(N+1), ef.UB]. Any window inside it is a pair of assumptions
+void DoubleOrder::assumeBounds(const EncodedFormula & ef, int lb, int ub, vector<literal> & assumptions){
+	int N = ins->getNActivities();
+
+	if(ub < ins->ES(N+1) || lb > ub || lb > ef.UB){
+		assumptions.push_back(ef.f->falseVar());
+		return;
+	}
+	if(ub < ef.UB)
+		assumptions.push_back(ef.f->bvar("o",N+1,ub));
+	if(lb > ins->ES(N+1))
+		assumptions.push_back(!ef.f->bvar("o",N+1,lb-1));
+}
+
+//Each activity has started by its latest start time for makespan 'ub'. Windows that
+//are empty or not tighter than the ones of the encoding give false or no literal
+bool DoubleOrder::assumeUpperBound(const EncodedFormula & ef, int ub, vector<literal> & assumptions){
+	int N = ins->getNActivities();
+	for(int i = 1; i <= N+1; i++){
+		int t = ins->LS(i,ub);
+		if(t < ins->ES(i))
+			assumptions.push_back(ef.f->falseVar());
+		else if(t < ins->LS(i,ef.UB))
+			assumptions.push_back(ef.f->bvar("o",i,t));
+	}
+	return true;
+}
+
 DoubleOrder::~DoubleOrder() {
 }
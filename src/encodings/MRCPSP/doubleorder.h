@@ -27,7 +27,11 @@ public:
 
 	SMTFormula * encode(int vMin = INT_MIN, int vMax = INT_MAX);
 	void setModel(const EncodedFormula & ef, int lb, int ub, const vector<bool> & bmodel, const vector<int> & imodel);
+	bool getPhase(const EncodedFormula & ef, vector<literal> & phase) const;
+	bool restrictActivity(const EncodedFormula & ef, int i, int mode, int minstart, int maxstart, vector<literal> & lits) const;
 	bool narrowBounds(const EncodedFormula & ef, int lastLB, int lastUB, int lb, int ub);
+	void assumeBounds(const EncodedFormula & ef, int lb, int ub, vector<literal> & assumptions);
+	bool assumeUpperBound(const EncodedFormula & ef, int ub, vector<literal> & assumptions);
 };
 
 #endif
@@ -7,6 +7,7 @@
 #include "util.h"
 #include "bipgraph.h"
 #include "disjointset.h"
+#include <chrono>
 #include <math.h>
 
 using namespace std;
@@ -20,6 +21,7 @@ MRCPSP::MRCPSP(int nactivities, int nrenewable, int nnonrenewable){
 	this->nresources = nrenewable + nnonrenewable;
 	succs = new vector<int> [nactivities+2];
 	nmodes = new int[nactivities+2];
+	modeids = new vector<int> [nactivities+2];
 
 	duration = new vector<int> [nactivities+2];
 	demand = new vector<int> * [nactivities+2];
@@ -31,46 +33,47 @@ MRCPSP::MRCPSP(int nactivities, int nrenewable, int nnonrenewable){
 	//Prepare preprocessed data
 	extPrecs = new int * [nactivities+2];
 	nSteps = new int * [nactivities+2];
-	resource_incompatibles = new bool * [nactivities+2];
-	tw_incompatibles = new bool * [nactivities+2];
-	resource_disjoints = new bool * [nactivities+2];
+	resource_incompatibles = BitMatrix(nactivities+2,nactivities+2);
+	resource_disjoints = BitMatrix(nactivities+2,nactivities+2);
+	heads = new int[nactivities+2];
+	tails = new int[nactivities+2];
 
 	for(int i = 0; i < nactivities+2; i++){
 		extPrecs[i] = new int[nactivities+2];
 		nSteps[i] = new int[nactivities+2];
-		resource_incompatibles[i] = new bool[nactivities+2];
-		tw_incompatibles[i] = new bool[nactivities+2];
-		resource_disjoints[i] = new bool[nactivities+2];
 	}
 
 	for(int i = 0; i < nactivities+2; i++){
 		for(int j = 0; j < nactivities+2; j++){
 			extPrecs[i][j] = INT_MIN;
 			nSteps[i][j] = INT_MIN;
-			resource_incompatibles[i][j] = false;
-			tw_incompatibles[i][j] = false;
-			resource_disjoints[i][j] = false;
 		}
+		heads[i] = 0;
+		tails[i] = 0;
 	}
 
-	ntwincompatibilities = 0;
 	nresincomps = 0;
 	nenergyprecs = 0;
 	ndisjoints = 0;
 	nreducednrdemands = 0;
+	ntwreductions = 0;
+	nremovedmodes = 0;
+	nremovedresources = 0;
+	nnrprunedmodes = 0;
+	pairwisetime = 0;
+	closurecomputed = false;
+	resincompsvalid = false;
 
 	//Dummies
 	setNModes(0,1);
 	setNModes(nactivities+1,1);
-
-	computeExtPrecs();
-	computeSteps();
 }
 
 MRCPSP::~MRCPSP(){
 
 	//Delete instance data
 	delete [] nmodes;
+	delete [] modeids;
 	delete [] succs;
 	delete [] duration;
 	delete [] capacity;
@@ -83,16 +86,12 @@ MRCPSP::~MRCPSP(){
 	for(int i = 0; i < nactivities+2; i++){
 		delete [] extPrecs[i];
 		delete [] nSteps[i];
-		delete [] resource_incompatibles[i];
-		delete [] tw_incompatibles[i];
-		delete [] resource_disjoints[i];
 	}
 
 	delete [] extPrecs;
 	delete [] nSteps;
-	delete [] resource_incompatibles;
-	delete [] tw_incompatibles;
-	delete [] resource_disjoints;
+	delete [] heads;
+	delete [] tails;
 }
 
 int MRCPSP::getNActivities() const{
@@ -146,6 +145,9 @@ const vector<int> & MRCPSP::getSuccessors(int i) const {
 void MRCPSP::setNModes(int i, int n){
 	nmodes[i]=n;
 	duration[i]=vector<int>(n,0);
+	modeids[i]=vector<int>(n);
+	for(int m = 0; m < n; m++)
+		modeids[i][m]=m;
 	for(int r = 0; r < nresources; r++)
 		demand[i][r]=vector<int>(n,0);
 }
@@ -155,10 +157,257 @@ void MRCPSP::ignoreNR(){
 	this->nresources = this->nrenewable;
 }
 
+//The modes keep their indices. A schedule of the coarse instance, with its start times
+//multiplied by delta, is a schedule of this one: each activity runs inside the rounded
+//duration, so neither the precedences nor the resource profiles get tighter
+MRCPSP * MRCPSP::coarsen(int delta) const{
+	MRCPSP * coarse = new MRCPSP(nactivities,nrenewable,nnonrenewable);
+	for(int i = 0; i < nactivities+2; i++){
+		coarse->setNModes(i,nmodes[i]);
+		coarse->modeids[i] = modeids[i];
+		for(int m = 0; m < nmodes[i]; m++){
+			coarse->setDuration(i,m,(duration[i][m]+delta-1)/delta);
+			for(int r = 0; r < nresources; r++)
+				coarse->setDemand(i,r,m,demand[i][r][m]);
+		}
+		for(int j : succs[i])
+			coarse->addSuccessor(i,j);
+	}
+	for(int r = 0; r < nresources; r++)
+		coarse->setCapacity(r,capacity[r]);
+	return coarse;
+}
+
+//Copies everything but the memoized path covers, which the copy computes again if needed
+MRCPSP * MRCPSP::clone() const{
+	MRCPSP * copy = new MRCPSP(nactivities,nrenewable,nnonrenewable);
+	for(int i = 0; i < nactivities+2; i++){
+		copy->nmodes[i] = nmodes[i];
+		copy->modeids[i] = modeids[i];
+		copy->duration[i] = duration[i];
+		for(int r = 0; r < nresources; r++)
+			copy->demand[i][r] = demand[i][r];
+		copy->succs[i] = succs[i];
+		for(int j = 0; j < nactivities+2; j++){
+			copy->extPrecs[i][j] = extPrecs[i][j];
+			copy->nSteps[i][j] = nSteps[i][j];
+		}
+		copy->heads[i] = heads[i];
+		copy->tails[i] = tails[i];
+	}
+	for(int r = 0; r < nresources; r++)
+		copy->capacity[r] = capacity[r];
+
+	copy->resource_incompatibles = resource_incompatibles;
+	copy->resource_disjoints = resource_disjoints;
+	copy->closurecomputed = closurecomputed;
+	copy->resincompsvalid = resincompsvalid;
+
+	copy->nresincomps = nresincomps;
+	copy->nenergyprecs = nenergyprecs;
+	copy->ndisjoints = ndisjoints;
+	copy->nreducednrdemands = nreducednrdemands;
+	copy->ntwreductions = ntwreductions;
+	copy->nremovedmodes = nremovedmodes;
+	copy->nremovedresources = nremovedresources;
+	copy->nnrprunedmodes = nnrprunedmodes;
+	copy->pairwisetime = pairwisetime;
+	return copy;
+}
+
+void MRCPSP::changeDuration(int i, int mode, int p){
+	int oldmin = getMinDuration(i);
+	duration[i][mode] = p;
+	if(getMinDuration(i) == oldmin)
+		return;
+
+	if(closurecomputed)
+		updatePaths(vector<int>(1,i));
+	if(getMinDuration(i) < oldmin)
+		relaxTimeWindows();
+
+	lock_guard<mutex> guard(pathcoverlock);
+	pathcovers.clear();
+}
+
+void MRCPSP::changeDemand(int i, int r, int mode, int q){
+	vector<int> oldmindems(nrenewable);
+	for(int r2 = 0; r2 < nrenewable; r2++)
+		oldmindems[r2] = getMinDemand(i,r2);
+	int oldmin = getMinDemand(i,r);
+	demand[i][r][mode] = q;
+
+	if(r < nrenewable && getMinDemand(i,r) != oldmin)
+		updateResourceIncompatibilities(i,oldmindems);
+	//The time windows only depend on the minimum renewable demands
+	if(r < nrenewable && getMinDemand(i,r) < oldmin)
+		relaxTimeWindows();
+}
+
+void MRCPSP::changeCapacity(int r, int c){
+	if(c > capacity[r] && r < nrenewable)
+		relaxTimeWindows();
+	if(c != capacity[r] && r < nrenewable)
+		resincompsvalid = false;
+	capacity[r] = c;
+}
+
+bool MRCPSP::addPrecedence(int i, int j){
+	if(i == j)
+		return false;
+
+	if(closurecomputed){
+		if(isPred(j,i))
+			return false;
+	}
+	else{
+		vector<bool> reached(nactivities+2,false);
+		vector<int> stack(1,j);
+		reached[j] = true;
+		while(!stack.empty()){
+			int k = stack.back();
+			stack.pop_back();
+			for(int l : succs[k]){
+				if(!reached[l]){
+					reached[l] = true;
+					stack.push_back(l);
+				}
+			}
+		}
+		if(reached[i])
+			return false;
+	}
+
+	if(find(succs[i].begin(),succs[i].end(),j) != succs[i].end())
+		return true;
+	succs[i].push_back(j);
+	if(closurecomputed)
+		updatePaths(vector<int>(1,i));
+
+	lock_guard<mutex> guard(pathcoverlock);
+	pathcovers.clear();
+	return true;
+}
+
+//An activity left without successors precedes the sink, and one left without predecessors follows the source
+bool MRCPSP::removePrecedence(int i, int j){
+	vector<int>::iterator it = find(succs[i].begin(),succs[i].end(),j);
+	if(i == 0 || j == nactivities+1 || it == succs[i].end())
+		return false;
+	succs[i].erase(it);
+
+	vector<int> changed(1,i);
+	if(succs[i].empty())
+		succs[i].push_back(nactivities+1);
+	bool haspreds = false;
+	for(int k = 0; k < nactivities+2 && !haspreds; k++)
+		haspreds = find(succs[k].begin(),succs[k].end(),j) != succs[k].end();
+	if(!haspreds){
+		succs[0].push_back(j);
+		changed.push_back(0);
+	}
+
+	if(closurecomputed)
+		updatePaths(changed);
+	relaxTimeWindows();
+
+	lock_guard<mutex> guard(pathcoverlock);
+	pathcovers.clear();
+	return true;
+}
+
+//Longest paths in the reverse topological order, from the rows of the successors. The
+//predecessors of the changed activities are the only ones whose paths may go through them,
+//and removing or adding an arc from a changed activity does not change its predecessors
+void MRCPSP::updatePaths(const vector<int> & changed){
+	int N = nactivities+2;
+	vector<bool> affected(N,false);
+	for(int i : changed){
+		affected[i] = true;
+		for(int a = 0; a < N; a++)
+			if(isPred(a,i))
+				affected[a] = true;
+	}
+
+	vector<int> npreds(N,0);
+	for(int i = 0; i < N; i++)
+		for(int j : succs[i])
+			npreds[j]++;
+	vector<int> order;
+	for(int i = 0; i < N; i++)
+		if(npreds[i] == 0)
+			order.push_back(i);
+	for(int k = 0; k < order.size(); k++)
+		for(int j : succs[order[k]])
+			if(--npreds[j] == 0)
+				order.push_back(j);
+
+	for(int k = order.size()-1; k >= 0; k--){
+		int a = order[k];
+		if(!affected[a])
+			continue;
+		int d = getMinDuration(a);
+		for(int b = 0; b < N; b++){
+			extPrecs[a][b] = INT_MIN;
+			nSteps[a][b] = INT_MIN;
+		}
+		for(int s : succs[a]){
+			extPrecs[a][s] = max(extPrecs[a][s],d);
+			nSteps[a][s] = max(nSteps[a][s],1);
+			for(int b = 0; b < N; b++){
+				if(extPrecs[s][b] >= 0)
+					extPrecs[a][b] = max(extPrecs[a][b],d+extPrecs[s][b]);
+				if(nSteps[s][b] >= 0)
+					nSteps[a][b] = max(nSteps[a][b],1+nSteps[s][b]);
+			}
+		}
+	}
+}
+
+//Both sides of the pairs of i, and the number of pairs of each resource, as in computeResourceIncompatibilities
+void MRCPSP::updateResourceIncompatibilities(int i, const vector<int> & oldmindems){
+	if(!resincompsvalid)
+		return;
+	vector<int> mindems(nrenewable);
+	for(int r = 0; r < nrenewable; r++)
+		mindems[r] = getMinDemand(i,r);
+	for(int j = 0; j < nactivities+2; j++){
+		if(j == i)
+			continue;
+		bool incompatible = false;
+		for(int r = 0; r < nrenewable; r++){
+			int min = getMinDemand(j,r);
+			if(oldmindems[r] + min > capacity[r])
+				nresincomps--;
+			if(mindems[r] + min > capacity[r]){
+				nresincomps++;
+				incompatible = true;
+			}
+		}
+		resource_incompatibles.set(i,j,incompatible);
+		resource_incompatibles.set(j,i,incompatible);
+	}
+}
+
+void MRCPSP::relaxTimeWindows(){
+	for(int i = 0; i < nactivities+2; i++){
+		heads[i] = 0;
+		tails[i] = 0;
+	}
+}
+
 int MRCPSP::getNModes(int i) const{
 	return nmodes[i];
 }
 
+int MRCPSP::getModeId(int i, int mode) const{
+	return modeids[i][mode];
+}
+
+bool MRCPSP::hasPrecedenceClosure() const{
+	return closurecomputed;
+}
+
 int MRCPSP::getExtPrec(int i, int j) const{
 	return extPrecs[i][j];
 }
@@ -187,19 +436,53 @@ int MRCPSP::trivialLB() const{
 }
 
 int MRCPSP::ES(int i) const{
-	return extPrecs[0][i] > 0 ? extPrecs[0][i] : 0;
+	int es = extPrecs[0][i] > 0 ? extPrecs[0][i] : 0;
+	return heads[i] > es ? heads[i] : es;
 }
 
 int MRCPSP::LS(int i, int UB) const{
-	return extPrecs[i][nactivities+1] > 0 ? UB - extPrecs[i][nactivities+1] : UB;
+	int tail = extPrecs[i][nactivities+1] > tails[i] ? extPrecs[i][nactivities+1] : tails[i];
+	return tail > 0 ? UB - tail : UB;
 }
 
 int MRCPSP::EC(int i) const{
 	return ES(i) + getMinDuration(i);
 }
 
+//The resource-tightened tails bound the start, and only the precedence tail bounds the
+//completion, so a mode longer than the minimum one may end after LS + the minimum duration
 int MRCPSP::LC(int i, int UB) const{
-	return LS(i,UB) + getMinDuration(i);
+	int lc = INT_MIN;
+	for(int m = 0; m < nmodes[i]; m++)
+		lc = max(lc,LC(i,UB,m));
+	return lc;
+}
+
+int MRCPSP::LC(int i, int UB, int mode) const{
+	int lc = LS(i,UB) + duration[i][mode];
+	if(extPrecs[i][nactivities+1] >= 0)
+		lc = min(lc,UB - extPrecs[i][nactivities+1] + getMinDuration(i));
+	return lc;
+}
+
+//The renewable resource usage can only increase when some activity starts,
+//so the capacities only need to be checked at these time points
+void MRCPSP::getStartEvents(int ub, vector<bool> & events) const{
+	vector<int> diff(ub+1,0);
+	for(int i = 1; i <= nactivities; i++){
+		int es = ES(i);
+		int ls = min(LS(i,ub),ub-1);
+		if(es <= ls){
+			diff[es]++;
+			diff[ls+1]--;
+		}
+	}
+	events.assign(ub,false);
+	int open = 0;
+	for(int t = 0; t < ub; t++){
+		open += diff[t];
+		events[t] = open > 0;
+	}
 }
 
 int MRCPSP::getMostRepDemand(int i, int r) const{
@@ -286,16 +569,24 @@ void MRCPSP::computeSteps(){
 			nSteps[i][j] = 1;
 
 	util::floydWarshall(nSteps,nactivities+2);
+	closurecomputed = true;
+
+	lock_guard<mutex> guard(pathcoverlock);
+	pathcovers.clear();
 }
 
 
+//Pairs of activities whose minimum demands on some renewable resource exceed
+//its capacity. For each resource, the activities j incompatible with i are
+//the ones with a minimum demand of at least capacity-min(i)+1
 void MRCPSP::computeResourceIncompatibilities(){
+	chrono::steady_clock::time_point begin = chrono::steady_clock::now();
 	nresincomps = 0;
+	resource_incompatibles.clear();
 
-	vector<vector<int> > minunits;
-	minunits.resize(nrenewable);
+	vector<int> minunits(nactivities+2);
+	vector<int> thresholds(nactivities+2);
 	for(int r = 0; r < nrenewable; r++){
-		minunits[r].resize(nactivities+2);
 		for (int i=0;i<nactivities+2;i++) {
 			int min = INT_MAX;
 			for(int m = 0; m < nmodes[i]; m++){
@@ -303,65 +594,54 @@ void MRCPSP::computeResourceIncompatibilities(){
 				if(dem < min)
 					min = dem;
 			}
-			minunits[r][i]=min;
-		}
-	}
-
-	for (int k=0;k<nrenewable;k++) {
-		for (int i=0;i<nactivities+1;i++) {
-			for (int j=i+1;j<nactivities+2;j++) {
-				if (minunits[k][i]+minunits[k][j]>capacity[k]){
-					resource_incompatibles[i][j]=true;
-					resource_incompatibles[j][i]=true;
-					nresincomps++;
-				}
-			}
+			minunits[i]=min;
+			thresholds[i]=capacity[r]-min+1;
 		}
+		//Each pair is found from both sides, and counted once for each resource
+		nresincomps += resource_incompatibles.orColumnsAtLeast(minunits,thresholds)/2;
 	}
+	resincompsvalid = true;
+	pairwisetime += chrono::duration<double>(chrono::steady_clock::now()-begin).count();
 }
 
-//A pair of activities i,j are said to be TWincom
-//if i cannot be running during the start time of j
-//due to time windows. TWincomp(i,j) is not the same as TWincomp(j,i)
-void MRCPSP::computeTWIncompatibilities(int UB){
-	ntwincompatibilities = 0;
-	for(int i = 0; i<nactivities+2; i++){
-		int ESi = ES(i);
-		int LCi = LC(i,UB);
-		for(int j=0; j<nactivities+2; j++){
-			int LSj = LS(j,UB);
-			int ESj = ES(j);
-			if(i==j)
-				tw_incompatibles[i][j] = false;
-			else{
-				if(LCi <= ESj || LSj < ESi){
-					tw_incompatibles[i][j]=true;
-					ntwincompatibilities++;
+//Pairs of activities that do not demand any common renewable resource in
+//any of their modes. Row i is the complement of the union of the users of
+//the resources demanded by i
+void MRCPSP::computeResourceDisjoints(){
+	chrono::steady_clock::time_point begin = chrono::steady_clock::now();
+	int N = nactivities+2;
+	BitMatrix users(nrenewable,N);
+	vector<vector<int> > used(N);
+	for(int i = 0; i < N; i++){
+		for(int r = 0; r < nrenewable; r++){
+			for(int m = 0; m < nmodes[i]; m++){
+				if(demand[i][r][m]>0){
+					users.set(r,i);
+					used[i].push_back(r);
+					break;
 				}
-				else
-					tw_incompatibles[i][j]=false;
 			}
 		}
 	}
-}
-
-void MRCPSP::computeResourceDisjoints(){
-	ndisjoints = 0;
-	vector<uint32_t> resource_masks(nactivities+2,0);
-	for(int i = 0; i < nactivities+2; i++)
-		for(int r = 0; r < nrenewable; r++)
-			for(int m = 0; m < nmodes[i]; m++)
-				if(demand[i][r][m]>0)
-					resource_masks[i]|=1<<r;
 
-	for(int i = 0; i < nactivities+1; i++){
-		for(int j = i+1; j <= nactivities+2; j++){
-			if((resource_masks[i] & resource_masks[j]) == 0){
-				resource_disjoints[i][j] = resource_disjoints[j][i] = true;
-				ndisjoints++;
+	int nwords = resource_disjoints.getNWords();
+	uint64_t last = N%64 == 0 ? ~(uint64_t)0 : ((uint64_t)1 << (N%64)) - 1;
+	BitMatrix::forRowBlocks(N,[&](int b, int e){
+		for(int i = b; i < e; i++){
+			uint64_t * row = resource_disjoints.getRow(i);
+			for(int w = 0; w < nwords; w++)
+				row[w] = ~(uint64_t)0;
+			for(int r : used[i]){
+				const uint64_t * u = users.getRow(r);
+				for(int w = 0; w < nwords; w++)
+					row[w] &= ~u[w];
 			}
+			row[nwords-1] &= last;
+			row[i/64] &= ~((uint64_t)1 << (i%64));
 		}
-	}
+	});
+	ndisjoints = resource_disjoints.count()/2;
+	pairwisetime += chrono::duration<double>(chrono::steady_clock::now()-begin).count();
 }
 
 
@@ -411,6 +691,200 @@ void MRCPSP::computeEnergyPrecedences(){
 	delete [] visited;
 }
 
+//Removing modes only tightens the instance, the time windows remain valid
+void MRCPSP::removeMode(int i, int m){
+	int oldmin = getMinDuration(i);
+	vector<int> oldmindems(nrenewable);
+	for(int r = 0; r < nrenewable; r++)
+		oldmindems[r] = getMinDemand(i,r);
+
+	duration[i].erase(duration[i].begin()+m);
+	modeids[i].erase(modeids[i].begin()+m);
+	for(int r = 0; r < nresources; r++)
+		demand[i][r].erase(demand[i][r].begin()+m);
+	nmodes[i]--;
+	nremovedmodes++;
+
+	if(closurecomputed && getMinDuration(i) != oldmin)
+		updatePaths(vector<int>(1,i));
+	updateResourceIncompatibilities(i,oldmindems);
+
+	lock_guard<mutex> guard(pathcoverlock);
+	pathcovers.clear();
+}
+
+void MRCPSP::removeResource(int r){
+	for(int i = 0; i < nactivities+2; i++){
+		for(int r2 = r; r2 < nresources-1; r2++)
+			demand[i][r2]=demand[i][r2+1];
+		demand[i][nresources-1].clear();
+	}
+	for(int r2 = r; r2 < nresources-1; r2++)
+		capacity[r2]=capacity[r2+1];
+	if(r < nrenewable){
+		nrenewable--;
+		resincompsvalid = false;
+	}
+	else
+		nnonrenewable--;
+	nresources--;
+	nremovedresources++;
+}
+
+//Classical mode reduction: remove non-executable modes, redundant non-renewable
+//resources and inefficient modes, repeating until nothing changes.
+bool MRCPSP::reduceModes(){
+	bool changed = true;
+	while(changed){
+		changed = false;
+
+		//Non-executable modes
+		for(int r = 0; r < nresources; r++){
+			int others = 0;
+			if(r >= nrenewable)
+				for(int j = 0; j < nactivities+2; j++)
+					others += getMinDemand(j,r);
+
+			for(int i = 0; i < nactivities+2; i++){
+				int mindem = getMinDemand(i,r);
+				for(int m = nmodes[i]-1; m >= 0; m--){
+					//A mode of duration 0 never uses the renewable resources
+					if(r < nrenewable && duration[i][m] == 0)
+						continue;
+					int dem = demand[i][r][m];
+					if(r >= nrenewable)
+						dem += others - mindem;
+					if(dem > capacity[r]){
+						if(nmodes[i]==1)
+							return false;
+						removeMode(i,m);
+						changed = true;
+					}
+				}
+				if(r >= nrenewable && getMinDemand(i,r) != mindem)
+					others += getMinDemand(i,r) - mindem;
+			}
+		}
+
+		//Redundant non-renewable resources
+		for(int r = nresources-1; r >= nrenewable; r--){
+			int maxdem = 0;
+			for(int i = 0; i < nactivities+2; i++)
+				maxdem += getMaxDemand(i,r);
+			if(maxdem <= capacity[r]){
+				removeResource(r);
+				changed = true;
+			}
+		}
+
+		//Inefficient modes: not faster and not cheaper in any resource than another mode
+		for(int i = 0; i < nactivities+2; i++){
+			for(int m = nmodes[i]-1; m >= 0; m--){
+				for(int m2 = 0; m2 < nmodes[i]; m2++){
+					if(m2 == m || duration[i][m2] > duration[i][m])
+						continue;
+					bool dominated = true;
+					for(int r = 0; r < nresources && dominated; r++)
+						if(demand[i][r][m2] > demand[i][r][m])
+							dominated = false;
+					if(dominated){
+						removeMode(i,m);
+						changed = true;
+						break;
+					}
+				}
+			}
+		}
+	}
+	return true;
+}
+
+//For each activity i, a dynamic program over the remaining activities computes
+//the non-dominated non-renewable demand vectors they can reach within the
+//capacities. A mode of i is removed if no such vector leaves room for it.
+//When the number of states exceeds the bound, pairs of states are merged into
+//their componentwise minimum, which keeps the filter sound.
+bool MRCPSP::filterNRModes(){
+	const int maxstates = 256;
+	int NR = nnonrenewable;
+	if(NR == 0)
+		return true;
+
+	bool changed = true;
+	while(changed){
+		changed = false;
+		for(int i = 1; i <= nactivities; i++){
+			vector<vector<int> > states(1,vector<int>(NR,0));
+			for(int j = 1; j <= nactivities; j++){
+				if(j == i)
+					continue;
+
+				vector<vector<int> > next;
+				for(const vector<int> & st : states){
+					for(int m = 0; m < nmodes[j]; m++){
+						vector<int> v(NR);
+						bool fits = true;
+						for(int r = 0; r < NR && fits; r++){
+							v[r] = st[r] + demand[j][nrenewable+r][m];
+							fits = v[r] <= capacity[nrenewable+r];
+						}
+						if(fits)
+							next.push_back(v);
+					}
+				}
+				if(next.empty())
+					return false;
+
+				sort(next.begin(),next.end());
+				next.erase(unique(next.begin(),next.end()),next.end());
+
+				//Remove dominated states. A state can only be dominated by a lexicographically smaller one
+				states.clear();
+				for(const vector<int> & v : next){
+					bool dominated = false;
+					for(int k = 0; k < states.size() && !dominated; k++){
+						dominated = true;
+						for(int r = 0; r < NR && dominated; r++)
+							if(states[k][r] > v[r])
+								dominated = false;
+					}
+					if(!dominated)
+						states.push_back(v);
+				}
+
+				while(states.size() > maxstates){
+					vector<vector<int> > merged;
+					for(int k = 0; k < states.size(); k+=2){
+						merged.push_back(states[k]);
+						if(k+1 < states.size())
+							for(int r = 0; r < NR; r++)
+								merged.back()[r] = min(merged.back()[r],states[k+1][r]);
+					}
+					states = merged;
+				}
+			}
+
+			for(int m = nmodes[i]-1; m >= 0; m--){
+				bool fits = false;
+				for(int k = 0; k < states.size() && !fits; k++){
+					fits = true;
+					for(int r = 0; r < NR && fits; r++)
+						if(states[k][r] + demand[i][nrenewable+r][m] > capacity[nrenewable+r])
+							fits = false;
+				}
+				if(!fits){
+					if(nmodes[i] == 1)
+						return false;
+					removeMode(i,m);
+					nnrprunedmodes++;
+					changed = true;
+				}
+			}
+		}
+	}
+	return true;
+}
+
 void MRCPSP::reduceNRDemandMin(){
 	for(int r = nrenewable; r < nresources; r++){
 		for(int i = 0; i < nactivities+2; i++){
@@ -440,8 +914,269 @@ void MRCPSP::reduceNRDemandMostFrequent(){
 }
 
 
-int MRCPSP::getNTWIncompatibilities() const{
-	return ntwincompatibilities;
+//Tighten the time windows of the activities for the deadline UB, iterating
+//precedence propagation, detectable precedences between resource incompatible
+//activities, timetabling over the compulsory parts, edge-finding and energetic
+//reasoning until a fixpoint. The resource reasonings use the minimum durations,
+//demands and energies among modes, so they are valid whatever the modes.
+//Heads and tails remain valid for any deadline ub <= UB, since a schedule
+//of makespan ub can always be right-shifted to end at UB.
+bool MRCPSP::computeTimeWindows(int UB){
+	int N = nactivities;
+
+	if(!resincompsvalid)
+		computeResourceIncompatibilities();
+
+	vector<int> pmin(N+2);
+	vector<vector<int> > mindem(N+2,vector<int>(nrenewable));
+	for(int i = 0; i < N+2; i++){
+		pmin[i] = getMinDuration(i);
+		heads[i] = ES(i);
+		tails[i] = UB - LS(i,UB);
+		for(int r = 0; r < nrenewable; r++)
+			mindem[i][r] = getMinDemand(i,r);
+	}
+
+	vector<int> initheads(heads,heads+N+2);
+	vector<int> inittails(tails,tails+N+2);
+
+	vector<vector<int> > profile(nrenewable);
+	vector<int> cs(N+2), ce(N+2);
+
+	bool feasible = true;
+	bool changed = true;
+	while(changed && feasible){
+		changed = false;
+
+		//Precedence propagation
+		for(int i = 0; i < N+2; i++){
+			for(int j = 0; j < N+2; j++){
+				if(i!=j && extPrecs[i][j] > INT_MIN){
+					if(heads[i] + extPrecs[i][j] > heads[j]){
+						heads[j] = heads[i] + extPrecs[i][j];
+						changed = true;
+					}
+					if(extPrecs[i][j] + tails[j] > tails[i]){
+						tails[i] = extPrecs[i][j] + tails[j];
+						changed = true;
+					}
+				}
+			}
+		}
+
+		//Detectable precedences: if i cannot finish before j starts, j precedes i
+		for(int i = 1; i <= N; i++){
+			for(int j = 1; j <= N; j++){
+				if(i!=j && pmin[i] > 0 && pmin[j] > 0 && resource_incompatibles.get(i,j) && !inPath(i,j)
+					&& heads[i] + pmin[i] > UB - tails[j]){
+					if(heads[j] + pmin[j] > heads[i]){
+						heads[i] = heads[j] + pmin[j];
+						changed = true;
+					}
+					if(pmin[j] + tails[i] > tails[j]){
+						tails[j] = pmin[j] + tails[i];
+						changed = true;
+					}
+				}
+			}
+		}
+
+		//Timetabling over the compulsory parts [LS_i, ES_i + pmin_i)
+		for(int r = 0; r < nrenewable; r++)
+			profile[r].assign(UB > 0 ? UB : 0, 0);
+
+		for(int i = 1; i <= N; i++){
+			cs[i] = max(UB - tails[i],0);
+			ce[i] = min(heads[i] + pmin[i],UB);
+			for(int t = cs[i]; t < ce[i]; t++)
+				for(int r = 0; r < nrenewable; r++)
+					profile[r][t] += mindem[i][r];
+		}
+
+		for(int i = 1; i <= N && feasible; i++){
+			if(pmin[i]==0)
+				continue;
+
+			//Push the earliest start to the right
+			int t0 = heads[i];
+			int lsi = UB - tails[i];
+			int t = t0;
+			while(t < t0 + pmin[i] && t0 <= lsi){
+				if(ttConflict(i,t,profile,cs[i],ce[i])){
+					t0 = t+1;
+					t = t0;
+				}
+				else
+					t++;
+			}
+			if(t0 > heads[i]){
+				heads[i] = t0;
+				changed = true;
+			}
+
+			//Push the latest start to the left
+			int t1 = lsi;
+			t = t1 + pmin[i] - 1;
+			while(t >= t1 && t1 >= heads[i]){
+				if(ttConflict(i,t,profile,cs[i],ce[i])){
+					t1 = t - pmin[i];
+					t = t1 + pmin[i] - 1;
+				}
+				else
+					t--;
+			}
+			if(UB - t1 > tails[i]){
+				tails[i] = UB - t1;
+				changed = true;
+			}
+
+			if(heads[i] > UB - tails[i])
+				feasible = false;
+		}
+
+		//Edge-finding and energetic reasoning over the windows [heads_i, UB - tails_i + pmax_i),
+		//which raise the heads, and over their mirror images, whose raised releases are tails
+		if(feasible){
+			vector<int> rel(N+2), dl(N+2), mrel(N+2), mdl(N+2);
+			for(int i = 0; i < N+2; i++){
+				rel[i] = heads[i];
+				dl[i] = UB - tails[i] + getMaxDuration(i);
+				mrel[i] = UB - dl[i];
+				mdl[i] = UB - rel[i];
+			}
+			vector<int> newrel(rel), newmrel(mrel);
+			for(int r = 0; r < nrenewable && feasible; r++)
+				feasible = edgeFinding(r,rel,dl,newrel) && edgeFinding(r,mrel,mdl,newmrel)
+					&& energeticReasoning(r,rel,dl,newrel) && energeticReasoning(r,mrel,mdl,newmrel);
+
+			for(int i = 1; i <= N && feasible; i++){
+				if(newrel[i] > heads[i]){
+					heads[i] = newrel[i];
+					changed = true;
+				}
+				//i ends at most at UB - newmrel_i, so it starts at most at UB - newmrel_i - pmin_i
+				if(newmrel[i] + pmin[i] > tails[i]){
+					tails[i] = newmrel[i] + pmin[i];
+					changed = true;
+				}
+				if(heads[i] > UB - tails[i])
+					feasible = false;
+			}
+		}
+
+		if(heads[N+1] > UB - tails[N+1])
+			feasible = false;
+	}
+
+	ntwreductions = 0;
+	for(int i = 0; i < N+2; i++)
+		ntwreductions += (heads[i] - initheads[i]) + (tails[i] - inittails[i]);
+
+	return feasible;
+}
+
+bool MRCPSP::ttConflict(int i, int t, const vector<vector<int> > & profile, int cs, int ce) const{
+	if(nrenewable == 0 || t < 0 || t >= (int)profile[0].size())
+		return false;
+	for(int r = 0; r < nrenewable; r++){
+		int dem = getMinDemand(i,r);
+		int others = profile[r][t] - (t >= cs && t < ce ? dem : 0);
+		if(others + dem > capacity[r])
+			return true;
+	}
+	return false;
+}
+
+//Edge-finding over the task intervals: the activities j with L <= rel_j and dl_j <= U.
+//If such a set Omega and an activity i outside it cannot fit together in [min(L,rel_i),U),
+//i ends after all of Omega, so Omega runs with at most C - c_i units available from the
+//start of i, and i cannot start before L + ceil((e_Omega - (C - c_i)(U - L)) / c_i)
+bool MRCPSP::edgeFinding(int r, const vector<int> & rel, const vector<int> & dl, vector<int> & newrel) const{
+	int N = nactivities;
+	int C = capacity[r];
+	vector<int> c(N+2), e(N+2);
+	set<int> Ls, Us;
+	for(int i = 1; i <= N; i++){
+		c[i] = getMinDemand(i,r);
+		e[i] = INT_MAX;
+		for(int m = 0; m < nmodes[i]; m++)
+			e[i] = min(e[i],demand[i][r][m]*duration[i][m]);
+		if(e[i] > 0){
+			Ls.insert(rel[i]);
+			Us.insert(dl[i]);
+		}
+	}
+
+	for(int L : Ls){
+		for(int U : Us){
+			if(U <= L)
+				continue;
+			int eOmega = 0;
+			for(int j = 1; j <= N; j++)
+				if(e[j] > 0 && rel[j] >= L && dl[j] <= U)
+					eOmega += e[j];
+			if(eOmega > C*(U-L))
+				return false;
+			for(int i = 1; i <= N; i++){
+				if(c[i] == 0 || (rel[i] >= L && dl[i] <= U))
+					continue;
+				if(eOmega + e[i] > C*(U-min(L,rel[i]))){
+					int rest = eOmega - (C-c[i])*(U-L);
+					if(rest > 0)
+						newrel[i] = max(newrel[i],L + (rest+c[i]-1)/c[i]);
+				}
+			}
+		}
+	}
+	return true;
+}
+
+//Energetic reasoning over the intervals [t1,t2) bounded by the releases, deadlines and
+//compulsory part limits. Each activity uses at least c_i times its minimum intersection
+//with the interval. If the others leave i less room than its left-shifted intersection,
+//i can only use the room left at the end of the interval, from t2 - room/c_i on
+bool MRCPSP::energeticReasoning(int r, const vector<int> & rel, const vector<int> & dl, vector<int> & newrel) const{
+	int N = nactivities;
+	int C = capacity[r];
+	vector<int> c(N+2), p(N+2), w(N+2);
+	set<int> t1s, t2s;
+	for(int i = 1; i <= N; i++){
+		c[i] = getMinDemand(i,r);
+		p[i] = getMinDuration(i);
+		if(c[i] > 0 && p[i] > 0){
+			t1s.insert(rel[i]);
+			t1s.insert(rel[i]+p[i]);
+			t1s.insert(dl[i]-p[i]);
+			t2s.insert(dl[i]);
+			t2s.insert(dl[i]-p[i]);
+			t2s.insert(rel[i]+p[i]);
+		}
+	}
+
+	for(int t1 : t1s){
+		for(int t2 : t2s){
+			if(t2 <= t1)
+				continue;
+			int energy = 0;
+			for(int j = 1; j <= N; j++){
+				w[j] = 0;
+				if(c[j] > 0 && p[j] > 0)
+					w[j] = c[j]*min(min(t2-t1,p[j]),min(max(0,rel[j]+p[j]-t1),max(0,t2-dl[j]+p[j])));
+				energy += w[j];
+			}
+			if(energy > C*(t2-t1))
+				return false;
+			for(int i = 1; i <= N; i++){
+				if(c[i] == 0 || p[i] == 0)
+					continue;
+				int room = C*(t2-t1) - (energy - w[i]);
+				int leftshift = min(t2-t1,min(p[i],max(0,rel[i]+p[i]-t1)));
+				if(c[i]*leftshift > room)
+					newrel[i] = max(newrel[i],t2 - room/c[i]);
+			}
+		}
+	}
+	return true;
 }
 
 int MRCPSP::getNResourceIncompatibilities() const{
@@ -469,6 +1204,26 @@ int MRCPSP::getNReducedNRDemands() const{
 	return nreducednrdemands;
 }
 
+int MRCPSP::getNTimeWindowReductions() const{
+	return ntwreductions;
+}
+
+int MRCPSP::getNRemovedModes() const{
+	return nremovedmodes;
+}
+
+int MRCPSP::getNRemovedResources() const{
+	return nremovedresources;
+}
+
+int MRCPSP::getNNRPrunedModes() const{
+	return nnrprunedmodes;
+}
+
+double MRCPSP::getPairwiseTime() const{
+	return pairwisetime;
+}
+
 
 
 int MRCPSP::next_activity(vector<vector<bool> > & predecessors,set<int> & tots,set<int> & C,vector<vector<int> > & pik,int t, const vector<int> & smodes) {
@@ -581,7 +1336,106 @@ int MRCPSP::computePSS(vector<int> & starts, const vector<int> & smodes){
 	return t;
 }
 
+int MRCPSP::computeMakespan(vector<int> & starts, const vector<int> & modes) const{
+	starts[nactivities+1] = 0;
+	for(int i = 1; i <= nactivities; i++)
+		starts[nactivities+1] = max(starts[nactivities+1],starts[i]+getDuration(i,modes[i]));
+	return starts[nactivities+1];
+}
+
+//A schedule that is still feasible is kept, with the start of the sink updated. Otherwise, a
+//serial schedule generation scheme places the activities in the order of their start times,
+//among the ones whose predecessors are placed, each one at the earliest time after its
+//predecessors where its renewable demands fit. Returns the makespan
+int MRCPSP::repairSchedule(vector<int> & starts, const vector<int> & modes) const{
+	int N = nactivities;
+	for(int r = 0; r < nresources; r++){
+		int used = 0;
+		for(int i = 0; i < N+2; i++){
+			//A mode of duration 0 never uses the renewable resources
+			if(r < nrenewable && duration[i][modes[i]] > 0 && demand[i][r][modes[i]] > capacity[r])
+				return INT_MAX;
+			used += demand[i][r][modes[i]];
+		}
+		if(r >= nrenewable && used > capacity[r])
+			return INT_MAX;
+	}
+
+	vector<vector<int> > profile(nrenewable);
+	auto fits = [&](int i, int t){
+		int d = duration[i][modes[i]];
+		for(int r = 0; r < nrenewable; r++){
+			int q = demand[i][r][modes[i]];
+			for(int u = t; q > 0 && u < t+d && u < (int)profile[r].size(); u++)
+				if(profile[r][u] + q > capacity[r])
+					return false;
+		}
+		return true;
+	};
+	auto place = [&](int i, int t){
+		int d = duration[i][modes[i]];
+		for(int r = 0; r < nrenewable; r++){
+			if((int)profile[r].size() < t+d)
+				profile[r].resize(t+d,0);
+			for(int u = t; u < t+d; u++)
+				profile[r][u] += demand[i][r][modes[i]];
+		}
+	};
+
+	bool feasible = starts[0] == 0;
+	for(int i = 1; i <= N && feasible; i++)
+		feasible = starts[i] >= 0;
+	for(int i = 0; i <= N && feasible; i++)
+		for(int j : succs[i])
+			if(j <= N && starts[j] < starts[i] + duration[i][modes[i]])
+				feasible = false;
+	for(int i = 1; i <= N && feasible; i++){
+		feasible = fits(i,starts[i]);
+		place(i,starts[i]);
+	}
+	if(feasible)
+		return computeMakespan(starts,modes);
+
+	vector<int> npreds(N+2,0);
+	for(int i = 0; i < N+2; i++)
+		for(int j : succs[i])
+			npreds[j]++;
+	vector<int> newstarts(N+2,0);
+	vector<bool> placed(N+2,false);
+	placed[0] = true;
+	for(int j : succs[0])
+		npreds[j]--;
+	for(int r = 0; r < nrenewable; r++)
+		profile[r].clear();
+
+	for(int k = 0; k < N; k++){
+		int i = -1;
+		for(int j = 1; j <= N; j++)
+			if(!placed[j] && npreds[j] == 0 && (i < 0 || starts[j] < starts[i]))
+				i = j;
+		int t = newstarts[i];
+		while(!fits(i,t))
+			t++;
+		newstarts[i] = t;
+		place(i,t);
+		placed[i] = true;
+		for(int j : succs[i]){
+			npreds[j]--;
+			newstarts[j] = max(newstarts[j],t+duration[i][modes[i]]);
+		}
+	}
+
+	starts = newstarts;
+	return computeMakespan(starts,modes);
+}
+
 void MRCPSP::computeMinPathCover(const vector<int> & vtasks, vector<set<int> > & groups){
+  lock_guard<mutex> guard(pathcoverlock);
+  map<vector<int>,vector<set<int> > >::const_iterator it = pathcovers.find(vtasks);
+  if(it != pathcovers.end()){
+    groups.insert(groups.end(),it->second.begin(),it->second.end());
+    return;
+  }
 
   vector<pair<int,int> > matching;
   BipGraph bg(vtasks.size()+1,vtasks.size()+1);
@@ -603,7 +1457,10 @@ void MRCPSP::computeMinPathCover(const vector<int> & vtasks, vector<set<int> > &
   for(const pair<int,int> & edge : matching)
     s.join(edge.first-1,edge.second-1);
 
-  s.getSets(groups,vtasks);
+  vector<set<int> > cover;
+  s.getSets(cover,vtasks);
+  pathcovers[vtasks] = cover;
+  groups.insert(groups.end(),cover.begin(),cover.end());
 }
 
 void MRCPSP::getPossibleParents(int i, int ub, vector<int> & parents){
@@ -626,7 +1483,7 @@ void MRCPSP::printSolution(ostream & os, const vector<int> & starts, const vecto
 		os << "S_" << i << ":" << starts[i] << "; ";
 
 	for(int i = 0; i < modes.size(); i++)
-		os << "M_" << i << ":" << modes[i]+1 << "; ";
+		os << "M_" << i << ":" << modeids[i][modes[i]]+1 << "; ";
 }
 
 ostream &operator << (ostream &output, MRCPSP &m)
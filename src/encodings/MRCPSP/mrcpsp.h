@@ -7,6 +7,8 @@
 #include <vector>
 #include <map>
 #include <set>
+#include <mutex>
+#include "bitmatrix.h"
 
 
 using namespace std;
@@ -26,29 +28,50 @@ private:
 	vector<int> * succs; //List of successors of each activity
 	vector<int> * duration; // Duration of each activity
 	int *nmodes; //Number of modes of the activities
+	vector<int> * modeids; //Original index of each mode, kept across mode reductions
 	int *capacity; //Capacities of the resources
 
 
 	//PREPROCESSED DATA
 	int ** extPrecs; //Extended time lags
 	int ** nSteps; //Minimal number of edges joining two activities
-	bool ** resource_incompatibles;
-	bool ** tw_incompatibles;
-	bool ** resource_disjoints;
+	BitMatrix resource_incompatibles;
+	BitMatrix resource_disjoints;
+	int * heads; //Resource-tightened earliest start times
+	int * tails; //Resource-tightened minimum distances from the start of each activity to the end of the project
+	bool closurecomputed; //extPrecs and nSteps are the closure of the precedences (computeSteps has run), and the edits keep them so
+	bool resincompsvalid; //resource_incompatibles is up to date, and the edits keep it so
 
 
 	//Statistics
-	int ntwincompatibilities;
 	int nresincomps;
 	int nenergyprecs;
 	int ndisjoints;
 	int nreducednrdemands;
+	int ntwreductions;
+	int nremovedmodes;
+	int nremovedresources;
+	int nnrprunedmodes;
+	double pairwisetime; //Seconds spent computing the incompatibility and disjointness matrices
+
+	//Minimum path covers already computed, by set of activities. They only depend on the
+	//precedences and the minimum durations, and are shared by the encodings of the instance
+	map<vector<int>,vector<set<int> > > pathcovers;
+	mutex pathcoverlock;
 
 
 
 
 
 	int getMostRepDemand(int i, int r) const; //Most repeated demand of activity i over resource r
+	void removeMode(int i, int m);
+	void removeResource(int r);
+	void updatePaths(const vector<int> & changed); //Recomputes the rows of extPrecs and nSteps of the changed activities and their predecessors
+	void updateResourceIncompatibilities(int i, const vector<int> & oldmindems); //Recomputes the incompatibilities of i, given its previous minimum renewable demands
+	void relaxTimeWindows(); //Discards the resource-tightened heads and tails, after an edit that may admit new schedules
+	bool ttConflict(int i, int t, const vector<vector<int> > & profile, int cs, int ce) const; //True if i cannot run at t given the compulsory parts profile
+	bool edgeFinding(int r, const vector<int> & rel, const vector<int> & dl, vector<int> & newrel) const; //Raise the releases by edge-finding on renewable r, given the windows [rel,dl). False if infeasible
+	bool energeticReasoning(int r, const vector<int> & rel, const vector<int> & dl, vector<int> & newrel) const; //Raise the releases by energetic reasoning on renewable r, given the windows [rel,dl). False if infeasible
 	int next_activity(vector<vector<bool> > & predecessors,set<int> & tots,set<int> & C,vector<vector<int> > & pik,int t, const vector<int> & smodes);
 
 public:
@@ -75,9 +98,23 @@ public:
 
 	int getNModes(int i) const;
 	void setNModes(int i, int n);
+	int getModeId(int i, int mode) const; //Original index of a mode, before the mode reductions
 
 	void ignoreNR(); //Make this instance have 0 non-renewable resources
-
+	MRCPSP * coarsen(int delta) const; //Copy of the instance data with the durations rounded up to multiples of delta, in units of delta
+	MRCPSP * clone() const; //Copy of the instance data and the preprocessed data
+
+	//Edits of a preprocessed instance, in its current modes and resources. They keep the
+	//precedence closure and the resource incompatibilities up to date, and the time windows
+	//valid: edits that may admit new schedules discard the resource-tightened ones, to be
+	//tightened again by computeTimeWindows
+	void changeDuration(int i, int mode, int p);
+	void changeDemand(int i, int r, int mode, int q);
+	void changeCapacity(int r, int c);
+	bool addPrecedence(int i, int j); //False if j precedes i
+	bool removePrecedence(int i, int j); //False if there is no such arc, or it is an arc of a dummy activity
+
+	bool hasPrecedenceClosure() const; //extPrecs and nSteps have been computed
 	int getExtPrec(int i, int j) const;
 	int getNSteps(int i, int j) const;
 	int trivialUB() const;
@@ -85,7 +122,9 @@ public:
 	int ES(int i) const;
 	int LS(int i, int ub) const;
 	int EC(int i) const;
-	int LC(int i, int ub) const;
+	int LC(int i, int ub) const; //Latest completion in any mode
+	int LC(int i, int ub, int mode) const; //Latest completion in the given mode
+	void getStartEvents(int ub, vector<bool> & events) const; //events[t] iff some non-dummy activity can start at t, for t in [0,ub)
 	bool inPath(int i, int j) const;
 	bool isPred(int i, int j) const;
 
@@ -101,23 +140,31 @@ public:
 	void computeExtPrecs();
 	void recomputeExtPrecs();
 	void computeSteps();
-	void computeTWIncompatibilities(int UB);
 	void computeResourceDisjoints();
 	void computeResourceIncompatibilities();
 	void computeEnergyPrecedences();
+	bool computeTimeWindows(int UB); //Tighten ES/LS by resource propagation. Valid for any ub <= UB. False if infeasible at UB
+	bool reduceModes(); //Remove non-executable and inefficient modes and redundant non-renewable resources until a fixpoint. False if some activity has no executable mode
+	bool filterNRModes(); //Remove modes not extendable to a mode assignment within the non-renewable capacities. False if there is none
 	void reduceNRDemandMin();
 	void reduceNRDemandMostFrequent();
 	int computePSS(vector<int> & starts, const vector<int> & modes);
+	int computeMakespan(vector<int> & starts, const vector<int> & modes) const; //Sets the start of the sink to the completion of the last activity, and returns it
+	int repairSchedule(vector<int> & starts, const vector<int> & modes) const; //Makes a schedule feasible keeping its modes, see the definition. INT_MAX if the modes exceed some capacity
 	void computeMinPathCover(const vector<int> & vasks, vector<set<int> > & groups);
 	void getPossibleParents(int i, int ub, vector<int> & parents);
 
 	//Statistics
-	int getNTWIncompatibilities() const;
 	int getNResourceIncompatibilities() const;
 	int getNPrecedenceIncompatibilities() const;
 	int getNEnergyPrecedences() const;
 	int getNResourceDisjoints() const;
 	int getNReducedNRDemands() const;
+	int getNTimeWindowReductions() const;
+	int getNRemovedModes() const;
+	int getNRemovedResources() const;
+	int getNNRPrunedModes() const;
+	double getPairwiseTime() const;
 
 	void printSolution(ostream & os, const vector<int> & starts, const vector<int> & modes) const;
 	friend ostream &operator <<(ostream &, MRCPSP &);
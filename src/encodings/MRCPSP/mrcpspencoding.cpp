@@ -1,5 +1,7 @@
 #include "mrcpspencoding.h"
+#include "errors.h"
 #include <limits.h>
+#include <iostream>
 
 
 MRCPSPEncoding::MRCPSPEncoding(MRCPSP * instance) : Encoding() {
@@ -30,7 +32,62 @@ void MRCPSPEncoding::getStartsAndModes(vector<int> &starts, vector<int> &modes){
 		starts[i]=this->starts[i];
 }
 
+void MRCPSPEncoding::setStartsAndModes(const vector<int> &starts, const vector<int> &modes){
+	this->starts = starts;
+	this->modes = modes;
+}
+
 bool MRCPSPEncoding::printSolution(ostream & os) const{
 	ins->printSolution(os,starts,modes);
 	return true;
 }
+
+bool MRCPSPEncoding::getStartVar(const EncodedFormula & ef, int i, intvar & s) const{
+	return false;
+}
+
+literal MRCPSPEncoding::getModeLiteral(const EncodedFormula & ef, int i, int mode) const{
+	std::cerr << "Error: the encoding has no mode literals" << std::endl;
+	exit(SOLVING_ERROR);
+}
+
+bool MRCPSPEncoding::getPhase(const EncodedFormula & ef, vector<literal> & phase) const{
+	int N = ins->getNActivities();
+	intvar s;
+	if(starts.size() != N+2 || !getStartVar(ef,0,s))
+		return false;
+
+	for(int i = 1; i <= N+1; i++){
+		getStartVar(ef,i,s);
+		phase.push_back(getModeLiteral(ef,i,modes[i]));
+		phase.push_back(s <= starts[i]);
+		phase.push_back(s >= starts[i]);
+	}
+	return true;
+}
+
+bool MRCPSPEncoding::restrictActivity(const EncodedFormula & ef, int i, int mode, int minstart, int maxstart, vector<literal> & lits) const{
+	intvar s;
+	if(!getStartVar(ef,i,s))
+		return false;
+	if(mode >= 0)
+		lits.push_back(getModeLiteral(ef,i,mode));
+	if(minstart > INT_MIN)
+		lits.push_back(s >= minstart);
+	if(maxstart < INT_MAX)
+		lits.push_back(s <= maxstart);
+	return true;
+}
+
+bool MRCPSPEncoding::assumeUpperBound(const EncodedFormula & ef, int ub, vector<literal> & assumptions){
+	int N = ins->getNActivities();
+	intvar s;
+	if(!getStartVar(ef,0,s))
+		return false;
+	for(int i = 1; i <= N+1; i++)
+		if(ins->LS(i,ub) < ins->LS(i,ef.UB)){
+			getStartVar(ef,i,s);
+			assumptions.push_back(s <= ins->LS(i,ub));
+		}
+	return true;
+}
@@ -18,13 +18,29 @@ protected:
   vector<int> modes;
   MRCPSP * ins;
 
+	//Integer start time variable and mode literals of activity i, in the encodings that have them.
+	//getPhase, restrictActivity and assumeUpperBound are built on them. False if there are none
+	virtual bool getStartVar(const EncodedFormula & ef, int i, intvar & s) const;
+	virtual literal getModeLiteral(const EncodedFormula & ef, int i, int mode) const;
+
 public:
 
 	MRCPSPEncoding(MRCPSP * instance);
 	int getObjective() const;
 	void getModes(vector<int> &modes);
 	void getStartsAndModes(vector<int> &starts, vector<int> &modes);
+	void setStartsAndModes(const vector<int> &starts, const vector<int> &modes); //Best known schedule, found outside the encoding
 	bool printSolution(ostream & os) const;
+
+	//The modes and start times of the best known schedule
+	bool getPhase(const EncodedFormula & ef, vector<literal> & phase) const;
+
+	//Adds to 'lits' literals that restrict activity i to mode 'mode', if not negative, and to a start
+	//time in [minstart,maxstart]. False if not supported
+	virtual bool restrictActivity(const EncodedFormula & ef, int i, int mode, int minstart, int maxstart, vector<literal> & lits) const;
+
+	//Latest start times of a makespan at most 'ub', that are tighter than the ones of the encoding
+	bool assumeUpperBound(const EncodedFormula & ef, int ub, vector<literal> & assumptions);
 	virtual ~MRCPSPEncoding();
 };
 
@@ -0,0 +1,274 @@
+#include "mrcpspgenerator.h"
+#include <algorithm>
+#include <cstdlib>
+#include <iomanip>
+#include "errors.h"
+
+using namespace std;
+
+MRCPSPGenerator::MRCPSPGenerator(int nactivities, int nrenewable, int nnonrenewable, int nmodes,
+		int complexity, int resourcefactor, int resourcestrength, int nrstrength,
+		int maxduration, int maxdemand, int seed) : rng(seed){
+	if(nactivities < 1 || nrenewable < 0 || nnonrenewable < 0 || nmodes < 1 || maxduration < 1 || maxdemand < 1){
+		cerr << "Error: invalid instance size" << endl;
+		exit(BADARGUMENTS_ERROR);
+	}
+	this->nactivities = nactivities;
+	this->nrenewable = nrenewable;
+	this->nnonrenewable = nnonrenewable;
+	this->nmodes = nmodes;
+
+	generateNetwork(complexity);
+	generateModes(resourcefactor,maxduration,maxdemand);
+	generateCapacities(resourcestrength,nrstrength);
+}
+
+int MRCPSPGenerator::uniform(int min, int max){
+	return uniform_int_distribution<int>(min,max)(rng);
+}
+
+int MRCPSPGenerator::windowStart(int j) const{
+	//A window proportional to the number of activities keeps the depth of the network constant
+	int window = max(3,nactivities/10);
+	return max(1,j-window);
+}
+
+void MRCPSPGenerator::generateNetwork(int complexity){
+	int N = nactivities;
+	succs.assign(N+2,vector<int>());
+	vector<int> npreds(N+2,0);
+
+	nstarts = max(1,N/10);
+	for(int j = nstarts+1; j <= N; j++){
+		int i = uniform(windowStart(j),j-1);
+		succs[i].push_back(j);
+		npreds[j]++;
+	}
+
+	//Arcs between activities, plus the ones from the source and to the sink
+	int narcs = 0;
+	for(int i = 1; i <= N; i++)
+		narcs += succs[i].size() + (succs[i].empty() ? 1 : 0) + (npreds[i]==0 ? 1 : 0);
+
+	long long target = (long long)complexity*(N+2)/100;
+	long long attempts = 20*target;
+	while(narcs < target && attempts-- > 0 && N > nstarts){
+		int j = uniform(nstarts+1,N);
+		int i = uniform(windowStart(j),j-1);
+		if(find(succs[i].begin(),succs[i].end(),j) != succs[i].end())
+			continue;
+		//The arc replaces the one of i to the sink and the one of the source to j, if any
+		narcs += 1 - (succs[i].empty() ? 1 : 0) - (npreds[j]==0 ? 1 : 0);
+		succs[i].push_back(j);
+		npreds[j]++;
+	}
+
+	for(int i = 1; i <= N; i++){
+		sort(succs[i].begin(),succs[i].end());
+		if(npreds[i]==0)
+			succs[0].push_back(i);
+		if(succs[i].empty())
+			succs[i].push_back(N+1);
+	}
+}
+
+void MRCPSPGenerator::generateModes(int resourcefactor, int maxduration, int maxdemand){
+	int N = nactivities;
+	int R = nrenewable + nnonrenewable;
+	durations.assign(N+2,vector<int>());
+	demands.assign(N+2,vector<vector<int> >());
+
+	//Dummies
+	durations[0] = durations[N+1] = vector<int>(1,0);
+	demands[0] = demands[N+1] = vector<vector<int> >(1,vector<int>(R,0));
+
+	for(int i = 1; i <= N; i++){
+		durations[i].resize(nmodes);
+		for(int m = 0; m < nmodes; m++)
+			durations[i][m] = uniform(1,maxduration);
+		sort(durations[i].begin(),durations[i].end());
+
+		demands[i].assign(nmodes,vector<int>(R,0));
+		vector<bool> used(R);
+		bool any = false;
+		for(int r = 0; r < R; r++){
+			used[r] = uniform(1,100) <= resourcefactor;
+			any = any || used[r];
+		}
+		//Every activity uses at least one resource
+		if(!any && R > 0)
+			used[uniform(0,R-1)] = true;
+
+		for(int r = 0; r < R; r++){
+			if(!used[r])
+				continue;
+			vector<int> d(nmodes);
+			for(int m = 0; m < nmodes; m++)
+				d[m] = uniform(1,maxdemand);
+			sort(d.begin(),d.end(),greater<int>());
+			for(int m = 0; m < nmodes; m++)
+				demands[i][m][r] = d[m];
+		}
+	}
+}
+
+void MRCPSPGenerator::generateCapacities(int resourcestrength, int nrstrength){
+	int N = nactivities;
+	capacities.assign(nrenewable+nnonrenewable,0);
+
+	//Earliest start schedule with the shortest modes. Activities are numbered in topological order
+	vector<int> es(N+2,0);
+	for(int i = 0; i < N+2; i++)
+		for(int j : succs[i])
+			es[j] = max(es[j],es[i]+durations[i][0]);
+
+	for(int r = 0; r < nrenewable; r++){
+		int kmin = 0;
+		vector<int> profile(es[N+1]+1,0);
+		for(int i = 0; i < N+2; i++){
+			int dmin = demands[i][0][r];
+			for(const vector<int> & d : demands[i])
+				dmin = min(dmin,d[r]);
+			kmin = max(kmin,dmin);
+			for(int t = es[i]; t < es[i]+durations[i][0]; t++)
+				profile[t] += demands[i][0][r];
+		}
+		int kmax = *max_element(profile.begin(),profile.end());
+		kmax = max(kmax,kmin);
+		capacities[r] = kmin + (int)((long long)resourcestrength*(kmax-kmin)/100);
+	}
+
+	for(int r = nrenewable; r < nrenewable+nnonrenewable; r++){
+		long long kmin = 0, kmax = 0;
+		for(int i = 0; i < N+2; i++){
+			int dmin = demands[i][0][r], dmax = demands[i][0][r];
+			for(const vector<int> & d : demands[i]){
+				dmin = min(dmin,d[r]);
+				dmax = max(dmax,d[r]);
+			}
+			kmin += dmin;
+			kmax += dmax;
+		}
+		capacities[r] = (int)(kmin + (long long)nrstrength*(kmax-kmin)/100);
+	}
+}
+
+int MRCPSPGenerator::getNActivities() const{
+	return nactivities;
+}
+
+int MRCPSPGenerator::getNArcs() const{
+	int narcs = 0;
+	for(const vector<int> & s : succs)
+		narcs += s.size();
+	return narcs;
+}
+
+MRCPSP * MRCPSPGenerator::build() const{
+	MRCPSP * instance = new MRCPSP(nactivities,nrenewable,nnonrenewable);
+	for(int i = 0; i < nactivities+2; i++){
+		instance->setNModes(i,durations[i].size());
+		for(int m = 0; m < durations[i].size(); m++){
+			instance->setDuration(i,m,durations[i][m]);
+			for(int r = 0; r < nrenewable+nnonrenewable; r++)
+				instance->setDemand(i,r,m,demands[i][m][r]);
+		}
+		for(int j : succs[i])
+			instance->addSuccessor(i,j);
+	}
+	for(int r = 0; r < nrenewable+nnonrenewable; r++)
+		instance->setCapacity(r,capacities[r]);
+	return instance;
+}
+
+void MRCPSPGenerator::printMM(ostream & output) const{
+	int N = nactivities;
+	int horizon = 0;
+	for(const vector<int> & d : durations)
+		horizon += d.back();
+
+	string stars(72,'*');
+	output << stars << endl;
+	output << "file with basedata            : generated" << endl;
+	output << "initial value random generator: 0" << endl;
+	output << stars << endl;
+	output << "projects                      :  1" << endl;
+	output << "jobs (incl. supersource/sink ):  " << N+2 << endl;
+	output << "horizon                       :  " << horizon << endl;
+	output << "RESOURCES" << endl;
+	output << "  - renewable                 :  " << nrenewable << "   R" << endl;
+	output << "  - nonrenewable              :  " << nnonrenewable << "   N" << endl;
+	output << "  - doubly constrained        :  0   D" << endl;
+	output << stars << endl;
+	output << "PROJECT INFORMATION:" << endl;
+	output << "pronr.  #jobs rel.date duedate tardcost  MPM-Time" << endl;
+	output << "    1     " << N << "      0       " << horizon << "        0       " << horizon << endl;
+	output << stars << endl;
+	output << "PRECEDENCE RELATIONS:" << endl;
+	output << "jobnr.    #modes  #successors   successors" << endl;
+	for(int i = 0; i < N+2; i++){
+		output << setw(4) << i+1 << setw(9) << durations[i].size() << setw(11) << succs[i].size() << "       ";
+		for(int j : succs[i])
+			output << "   " << j+1;
+		output << endl;
+	}
+	output << stars << endl;
+	output << "REQUESTS/DURATIONS:" << endl;
+	output << "jobnr. mode duration";
+	for(int r = 0; r < nrenewable; r++)
+		output << "  R " << r+1;
+	for(int r = 0; r < nnonrenewable; r++)
+		output << "  N " << r+1;
+	output << endl;
+	output << string(72,'-') << endl;
+	for(int i = 0; i < N+2; i++){
+		for(int m = 0; m < durations[i].size(); m++){
+			if(m==0)
+				output << setw(4) << i+1;
+			else
+				output << "    ";
+			output << setw(7) << m+1 << setw(6) << durations[i][m];
+			for(int d : demands[i][m])
+				output << setw(6) << d;
+			output << endl;
+		}
+	}
+	output << stars << endl;
+	output << "RESOURCEAVAILABILITIES:" << endl;
+	for(int r = 0; r < nrenewable; r++)
+		output << "  R " << r+1;
+	for(int r = 0; r < nnonrenewable; r++)
+		output << "  N " << r+1;
+	output << endl;
+	for(int c : capacities)
+		output << setw(5) << c;
+	output << endl;
+	output << stars << endl;
+}
+
+void MRCPSPGenerator::printRCP(ostream & output) const{
+	if(nmodes > 1 || nnonrenewable > 0){
+		cerr << "Error: the RCP format only has single mode instances without non-renewable resources" << endl;
+		exit(BADARGUMENTS_ERROR);
+	}
+
+	output << (nactivities+2) << "\t" << nrenewable << endl;
+
+	for(int r = 0; r < nrenewable; r++)
+		output << capacities[r] << "\t";
+	output << endl;
+
+	for(int i = 0; i < nactivities+2; i++){
+		output << durations[i][0] << "\t";
+
+		for(int r = 0; r < nrenewable; r++)
+			output << demands[i][0][r] << "\t";
+
+		output << succs[i].size() << "\t";
+
+		for(int j : succs[i])
+			output << (j+1) << "\t";
+
+		output << endl;
+	}
+}
@@ -0,0 +1,77 @@
+#ifndef MRCPSPGENERATOR_H
+#define MRCPSPGENERATOR_H
+
+#include <iostream>
+#include <vector>
+#include <random>
+#include "mrcpsp.h"
+
+using namespace std;
+
+/*
+ * Random MRCPSP instances with the controls of ProGen:
+ *  - Network complexity: arcs per activity, counting the arcs of the dummy
+ *    source and sink. Each activity gets a predecessor among a window of the
+ *    previous ones, and random arcs inside the window are added until the
+ *    complexity is reached. Redundant (transitive) arcs are not filtered.
+ *  - Resource factor: probability that an activity uses each resource.
+ *  - Resource strength: renewable capacities between the largest minimum
+ *    demand (0) and the peak demand of the earliest start schedule with the
+ *    shortest modes (100).
+ *  - Non-renewable strength: non-renewable capacities between the sum of the
+ *    minimum demands (0) and the sum of the maximum demands (100).
+ * Mode durations increase and demands decrease with the mode index, so no
+ * mode is trivially inefficient. The instance is generated at construction
+ * and kept apart from MRCPSP, so it can be written without preprocessing it.
+ */
+class MRCPSPGenerator
+{
+
+private:
+
+	int nactivities; //Number of non-dummy activites
+	int nrenewable;
+	int nnonrenewable;
+	int nmodes;
+
+	mt19937 rng;
+
+	vector<vector<int> > succs;
+	vector<vector<int> > durations; //Duration of each mode of each activity
+	vector<vector<vector<int> > > demands; //Demand of each mode of each activity on each resource
+	vector<int> capacities;
+
+	int uniform(int min, int max);
+
+	//Window of the predecessors of activity j, and number of activities only preceded by the source
+	int windowStart(int j) const;
+	int nstarts;
+
+	void generateNetwork(int complexity);
+	void generateModes(int resourcefactor, int maxduration, int maxdemand);
+	void generateCapacities(int resourcestrength, int nrstrength);
+
+public:
+
+	//Complexity in hundredths of arc per activity, factor and strengths in percentage
+	MRCPSPGenerator(int nactivities, int nrenewable, int nnonrenewable, int nmodes,
+		int complexity, int resourcefactor, int resourcestrength, int nrstrength,
+		int maxduration, int maxdemand, int seed);
+
+	int getNActivities() const;
+
+	//Number of arcs, including the ones of the dummy activities
+	int getNArcs() const;
+
+	//New MRCPSP instance with the generated data
+	MRCPSP * build() const;
+
+	//Writes the instance in the PSPLIB multi-mode format
+	void printMM(ostream & output) const;
+
+	//Writes the instance in the RCP format. It must be single mode without non-renewable resources
+	void printRCP(ostream & output) const;
+
+};
+
+#endif
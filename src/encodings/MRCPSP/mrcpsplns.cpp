@@ -0,0 +1,239 @@
+#include "mrcpsplns.h"
+#include <thread>
+#include <chrono>
+#include <algorithm>
+#include "encoder.h"
+
+using namespace std;
+
+
+MRCPSPNeighbourhood::MRCPSPNeighbourhood(MRCPSPEncoding * enc, const vector<int> & fixedmodes, const vector<int> & minstarts, const vector<int> & maxstarts) : Encoding(){
+	this->enc = enc;
+	this->fixedmodes = fixedmodes;
+	this->minstarts = minstarts;
+	this->maxstarts = maxstarts;
+}
+
+SMTFormula * MRCPSPNeighbourhood::encode(int lb, int ub){
+	SMTFormula * f = enc->encode(lb,ub);
+	EncodedFormula ef(f,lb,ub);
+	vector<literal> lits;
+	for(int i = 0; i < fixedmodes.size(); i++)
+		enc->restrictActivity(ef,i,fixedmodes[i],minstarts[i],maxstarts[i],lits);
+	for(const literal & l : lits)
+		f->addClause(l);
+	return f;
+}
+
+void MRCPSPNeighbourhood::setModel(const EncodedFormula & ef, int lb, int ub, const vector<bool> & bmodel, const vector<int> & imodel){
+	enc->setModel(ef,lb,ub,bmodel,imodel);
+}
+
+bool MRCPSPNeighbourhood::getPhase(const EncodedFormula & ef, vector<literal> & phase) const{
+	return enc->getPhase(ef,phase);
+}
+
+bool MRCPSPNeighbourhood::getModelVars(const EncodedFormula & ef, vector<int> & ivars, vector<int> & bvars) const{
+	return enc->getModelVars(ef,ivars,bvars);
+}
+
+bool MRCPSPNeighbourhood::narrowBounds(const EncodedFormula & ef, int lastLB, int lastUB, int lb, int ub){
+	return enc->narrowBounds(ef,lastLB,lastUB,lb,ub);
+}
+
+void MRCPSPNeighbourhood::assumeBounds(const EncodedFormula & ef, int LB, int UB, vector<literal> & assumptions){
+	enc->assumeBounds(ef,LB,UB,assumptions);
+}
+
+bool MRCPSPNeighbourhood::assumeUpperBound(const EncodedFormula & ef, int UB, vector<literal> & assumptions){
+	return enc->assumeUpperBound(ef,UB,assumptions);
+}
+
+int MRCPSPNeighbourhood::getObjective() const{
+	return enc->getObjective();
+}
+
+
+MRCPSPLNS::MRCPSPLNS(MRCPSP * instance, SolvingArguments * sargs, function<MRCPSPEncoding *(MRCPSP *)> newEncoding,
+		int nthreads, int size, float probetime, int seed) : rng(seed){
+	this->ins = instance;
+	this->sargs = sargs;
+	this->newEncoding = newEncoding;
+	this->nthreads = max(1,nthreads);
+	this->size = max(1,min(size,instance->getNActivities()));
+	this->probetime = probetime;
+	nrounds = 0;
+	nimprovements = 0;
+
+	int N = ins->getNActivities();
+	preds.assign(N+2,vector<int>());
+	for(int i = 0; i < N+2; i++)
+		for(int j : ins->getSuccessors(i))
+			preds[j].push_back(i);
+}
+
+//Activities running in [a,b), with b extended until there are 'size' of them or the makespan is reached
+void MRCPSPLNS::timeWindowNeighbourhood(const vector<int> & starts, const vector<int> & modes, vector<bool> & freed){
+	int N = ins->getNActivities();
+	int C = starts[N+1];
+	int a = uniform_int_distribution<int>(0,max(0,C-1))(rng);
+
+	int nfreed = 0;
+	for(int b = a+1; nfreed < size && b <= C; b++){
+		for(int i = 1; i <= N; i++){
+			if(!freed[i] && starts[i] < b && max(starts[i]+ins->getDuration(i,modes[i]),starts[i]+1) > a){
+				freed[i] = true;
+				nfreed++;
+			}
+		}
+	}
+}
+
+//Breadth-first search over predecessors and successors from a random activity
+void MRCPSPLNS::precedenceNeighbourhood(vector<bool> & freed){
+	int N = ins->getNActivities();
+	int seed = uniform_int_distribution<int>(1,N)(rng);
+
+	vector<int> queue(1,seed);
+	freed[seed] = true;
+	for(int k = 0; k < queue.size() && queue.size() < size; k++){
+		vector<int> next = ins->getSuccessors(queue[k]);
+		next.insert(next.end(),preds[queue[k]].begin(),preds[queue[k]].end());
+		shuffle(next.begin(),next.end(),rng);
+		for(int j : next){
+			if(1 <= j && j <= N && !freed[j] && queue.size() < size){
+				freed[j] = true;
+				queue.push_back(j);
+			}
+		}
+	}
+}
+
+int MRCPSPLNS::solveNeighbourhood(const vector<int> & starts, const vector<int> & modes, const vector<bool> & freed,
+		int lb, int ub, float seconds, vector<int> & newstarts, vector<int> & newmodes, bool & timedout){
+	int N = ins->getNActivities();
+
+	//Activities starting before the freed ones keep their start times, the later ones may start earlier
+	int a = INT_MAX;
+	for(int i = 1; i <= N; i++)
+		if(freed[i])
+			a = min(a,starts[i]);
+
+	vector<int> fixedmodes(N+2,-1);
+	vector<int> minstarts(N+2,INT_MIN);
+	vector<int> maxstarts(N+2,INT_MAX);
+	for(int i = 1; i <= N; i++){
+		if(freed[i])
+			continue;
+		fixedmodes[i] = modes[i];
+		maxstarts[i] = starts[i];
+		if(starts[i] < a)
+			minstarts[i] = starts[i];
+	}
+
+	MRCPSPEncoding * enc = newEncoding(ins);
+	enc->setStartsAndModes(starts,modes);
+	MRCPSPNeighbourhood neighbourhood(enc,fixedmodes,minstarts,maxstarts);
+	Encoder * e = sargs->getEncoder(&neighbourhood);
+	e->setProduceModels(true);
+	e->setTimeLimit(seconds);
+	Optimizer * opti = sargs->getOptimizer();
+
+	int makespan = INT_MAX;
+	int opt = opti->minimize(e,lb,ub,sargs->getBoolOption(USE_ASSUMPTIONS),sargs->getBoolOption(NARROW_BOUNDS));
+	timedout = opti->isInterrupted();
+	if(opt != INT_MIN){
+		enc->getStartsAndModes(newstarts,newmodes);
+		makespan = ins->computeMakespan(newstarts,newmodes);
+	}
+
+	delete opti;
+	delete e;
+	delete enc;
+	return makespan;
+}
+
+int MRCPSPLNS::run(int lb, int UB, vector<int> & starts, vector<int> & modes, float seconds, bool stats, ostream & os){
+	int N = ins->getNActivities();
+	chrono::steady_clock::time_point begin = chrono::steady_clock::now();
+
+	if(starts.empty()){
+		MRCPSPEncoding * enc = newEncoding(ins);
+		Encoder * e = sargs->getEncoder(enc);
+		e->setProduceModels(true);
+		e->setProbeTimeLimit(seconds);
+		if(e->checkSAT(lb,UB-1) && !e->timedOut())
+			enc->getStartsAndModes(starts,modes);
+		delete e;
+		delete enc;
+		if(starts.empty())
+			return UB;
+	}
+
+	int best = ins->computeMakespan(starts,modes);
+	if(stats)
+		os << "c lns initial makespan " << best << std::endl;
+
+	while(best > lb){
+		float remaining = seconds - chrono::duration<float>(chrono::steady_clock::now()-begin).count();
+		if(remaining <= 0)
+			break;
+		nrounds++;
+
+		vector<vector<bool> > freed(nthreads,vector<bool>(N+2,false));
+		for(int k = 0; k < nthreads; k++){
+			if((k+nrounds)%2==0)
+				timeWindowNeighbourhood(starts,modes,freed[k]);
+			else
+				precedenceNeighbourhood(freed[k]);
+		}
+
+		vector<vector<int> > newstarts(nthreads), newmodes(nthreads);
+		vector<int> makespans(nthreads);
+		vector<char> timedout(nthreads,false);
+		vector<thread> threads;
+		for(int k = 0; k < nthreads; k++)
+			threads.push_back(thread([&,k](){
+				bool to;
+				makespans[k] = solveNeighbourhood(starts,modes,freed[k],lb,best-1,min(probetime,remaining),newstarts[k],newmodes[k],to);
+				timedout[k] = to;
+			}));
+		for(thread & th : threads)
+			th.join();
+
+		int kbest = -1;
+		int ntimedout = 0;
+		for(int k = 0; k < nthreads; k++){
+			if(timedout[k])
+				ntimedout++;
+			if(makespans[k] < best && (kbest < 0 || makespans[k] < makespans[kbest]))
+				kbest = k;
+		}
+
+		if(kbest >= 0){
+			starts = newstarts[kbest];
+			modes = newmodes[kbest];
+			best = makespans[kbest];
+			nimprovements++;
+			if(stats)
+				os << "c lns round " << nrounds << " makespan " << best << std::endl;
+		}
+		else if(ntimedout == 0){
+			if(size == N) //Nothing larger to search
+				break;
+			size = min(N,size+max(1,size/2));
+		}
+		else if(ntimedout == nthreads)
+			size = max(1,size*2/3);
+	}
+
+	return best;
+}
+
+int MRCPSPLNS::getNRounds() const{
+	return nrounds;
+}
+
+int MRCPSPLNS::getNImprovements() const{
+	return nimprovements;
+}
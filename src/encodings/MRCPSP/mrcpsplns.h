@@ -0,0 +1,96 @@
+#ifndef MRCPSPLNS_DEFINITION
+#define MRCPSPLNS_DEFINITION
+
+#include <vector>
+#include <random>
+#include <functional>
+#include "mrcpsp.h"
+#include "mrcpspencoding.h"
+#include "solvingarguments.h"
+
+using namespace std;
+
+/*
+ * Encoding of a neighbourhood of a schedule: the formula of an existing
+ * encoding with unit clauses that restrict the mode and the start time of
+ * the activities outside the neighbourhood (see
+ * MRCPSPEncoding::restrictActivity). Models and phases are the ones of the
+ * wrapped encoding.
+ */
+class MRCPSPNeighbourhood : public Encoding {
+
+private:
+
+	MRCPSPEncoding * enc;
+	vector<int> fixedmodes; //Mode of each activity, negative if free
+	vector<int> minstarts;
+	vector<int> maxstarts;
+
+public:
+
+	MRCPSPNeighbourhood(MRCPSPEncoding * enc, const vector<int> & fixedmodes, const vector<int> & minstarts, const vector<int> & maxstarts);
+
+	SMTFormula * encode(int lb = INT_MIN, int ub = INT_MAX);
+	void setModel(const EncodedFormula & ef, int lb, int ub, const vector<bool> & bmodel, const vector<int> & imodel);
+	bool getPhase(const EncodedFormula & ef, vector<literal> & phase) const;
+	bool getModelVars(const EncodedFormula & ef, vector<int> & ivars, vector<int> & bvars) const;
+	bool narrowBounds(const EncodedFormula & ef, int lastLB, int lastUB, int lb, int ub);
+	void assumeBounds(const EncodedFormula & ef, int LB, int UB, vector<literal> & assumptions);
+	bool assumeUpperBound(const EncodedFormula & ef, int UB, vector<literal> & assumptions);
+	int getObjective() const;
+};
+
+
+/*
+ * Large neighbourhood search around an incumbent schedule. Each round
+ * optimizes several neighbourhoods in parallel, each with its own encoding,
+ * optimizer and SAT solver, a time budget and the makespan bounded by the
+ * incumbent one minus one. A neighbourhood frees a set of activities, either the ones running in
+ * a random time window of the incumbent or a precedence-connected set grown
+ * from a random activity. The activities that start before the freed ones
+ * keep their modes and start times, and the later ones keep their modes and
+ * may only start earlier. The best improving schedule of a round becomes the
+ * incumbent. The number of freed activities grows when every neighbourhood is
+ * proved without improvements, and shrinks when all of them time out.
+ */
+class MRCPSPLNS {
+
+private:
+
+	MRCPSP * ins;
+	SolvingArguments * sargs;
+	function<MRCPSPEncoding *(MRCPSP *)> newEncoding;
+
+	int nthreads;
+	int size; //Number of freed activities
+	float probetime;
+	mt19937 rng;
+	vector<vector<int> > preds; //Direct predecessors of each activity
+
+	int nrounds;
+	int nimprovements;
+
+	void timeWindowNeighbourhood(const vector<int> & starts, const vector<int> & modes, vector<bool> & freed);
+	void precedenceNeighbourhood(vector<bool> & freed);
+
+	//Optimizes a neighbourhood for makespans in [lb,ub] within 'seconds'. Returns the makespan of the best
+	//schedule found, or INT_MAX if there is none. 'timedout' is set if the optimization was interrupted
+	int solveNeighbourhood(const vector<int> & starts, const vector<int> & modes, const vector<bool> & freed,
+		int lb, int ub, float seconds, vector<int> & newstarts, vector<int> & newmodes, bool & timedout);
+
+public:
+
+	//'newEncoding' creates an encoding of the given instance, to be deleted by the caller
+	MRCPSPLNS(MRCPSP * instance, SolvingArguments * sargs, function<MRCPSPEncoding *(MRCPSP *)> newEncoding,
+		int nthreads, int size, float probetime, int seed);
+
+	//Searches for 'seconds' or until the makespan reaches 'lb'. If starts is empty, the initial
+	//schedule is the one of a first probe of the full encoding with makespan below UB. Returns the
+	//makespan of the best schedule, left in starts and modes, or UB if there is none. Statistics go to 'os'
+	int run(int lb, int UB, vector<int> & starts, vector<int> & modes, float seconds, bool stats, ostream & os = cout);
+
+	int getNRounds() const;
+	int getNImprovements() const;
+};
+
+#endif
@@ -16,10 +16,15 @@ SMTFormula * OMTSoftPBEncoding::encode(int lb, int ub){
 
 	SMTFormula * f = new SMTFormula();
 
-	//Start time integer variables
-	vector<intvar> S(N+1);
-	for (int i=0;i<=N+1;i++)
+	//Start time integer variables, within the time windows that bound the x_i,t,o variables
+	vector<intvar> S(N+2);
+	for (int i=0;i<=N+1;i++){
 		S[i]=f->newIntVar("S",i);
+		if(1 <= i && i <= N){
+			f->addClause(S[i] >= ins->ES(i));
+			f->addClause(S[i] <= ins->LS(i,ub));
+		}
+	}
 
 	//Activity 0 starts at time 0
 	f->addClause(S[0] == 0);
@@ -68,7 +73,7 @@ SMTFormula * OMTSoftPBEncoding::encode(int lb, int ub){
 	//Definition of x_i,t,o
 	for (int i=1;i<=N;i++) {
 		for (int g=0;g<ins->getNModes(i);g++) {
-			for (int t=ins->ES(i);t<ins->LC(i,ub);t++) {
+			for (int t=ins->ES(i);t<ins->LC(i,ub,g);t++) {
 				boolvar x = f->newBoolVar("x",i,t,g);
 				boolvar sm = f->bvar("sm",i,g);
 				literal geSi = S[i] <= t;
@@ -90,7 +95,7 @@ SMTFormula * OMTSoftPBEncoding::encode(int lb, int ub){
 				if (t>=ins->ES(i) && t<ins->LC(i,ub)){
 					for(int g=0;g<ins->getNModes(i);g++) {
 						int weight=ins->getDemand(i,r,g);
-						if (weight!=0)
+						if (weight!=0 && t<ins->LC(i,ub,g))
 							f->addSoftClauseWithVar(!f->bvar("x",i,t,g),weight,sum);
 					}
 				}
@@ -0,0 +1,324 @@
+#include "smteventencoding.h"
+#include "util.h"
+#include "smtapi.h"
+
+using namespace smtapi;
+
+SMTEventEncoding::SMTEventEncoding(MRCPSP * instance, SolvingArguments * sargs, bool omt) : MRCPSPEncoding(instance)  {
+	this->omt = omt;
+	this->sargs = sargs;
+}
+
+//In a schedule, number the distinct start times of the non-dummy activities in increasing
+//order and place the events at them, followed by the unused ones. A predecessor with positive
+//duration starts at a strictly earlier event, so the events are bounded by the longest chains
+void SMTEventEncoding::computeEventWindows(){
+	int N = ins->getNActivities();
+	firstevent.assign(N+2,0);
+	lastevent.assign(N+2,N-1);
+
+	bool changed = true;
+	while(changed){
+		changed = false;
+		for(int i = 1; i <= N; i++){
+			if(ins->getMinDuration(i) == 0)
+				continue;
+			for(int j : ins->getSuccessors(i)){
+				if(j > N)
+					continue;
+				if(firstevent[j] < firstevent[i]+1){
+					firstevent[j] = firstevent[i]+1;
+					changed = true;
+				}
+				if(lastevent[i] > lastevent[j]-1){
+					lastevent[i] = lastevent[j]-1;
+					changed = true;
+				}
+			}
+		}
+	}
+}
+
+//Activity i has started at the date of event e
+literal SMTEventEncoding::st(SMTFormula * f, int i, int e) const{
+	if(e < firstevent[i])
+		return f->falseVar();
+	if(e >= lastevent[i])
+		return f->trueVar();
+	return f->bvar("st",i,e);
+}
+
+//Activity i has finished at the date of event e. It cannot finish at its start event unless it has a mode of duration 0
+literal SMTEventEncoding::en(SMTFormula * f, int i, int e) const{
+	if(e < firstevent[i] + (ins->getMinDuration(i) > 0 ? 1 : 0))
+		return f->falseVar();
+	return f->bvar("en",i,e);
+}
+
+
+SMTFormula * SMTEventEncoding::encode(int lb, int ub){
+
+	int N = ins->getNActivities();
+	int N_RR = ins->getNRenewable();
+	int N_NR = ins->getNNonRenewable();
+	int N_R = ins->getNResources();
+	int K = N; //Number of events
+
+	SMTFormula * f = new SMTFormula();
+
+	computeEventWindows();
+	for (int i=1;i<=N;i++){
+		if(firstevent[i] > lastevent[i]){
+			f->addEmptyClause();
+			return f;
+		}
+	}
+
+	//Execution modes of the activities
+	for (int i=0;i<=N+1;i++) {
+		vector<literal> vmodes;
+		for (int o=0;o<ins->getNModes(i);o++)
+			vmodes.push_back(f->newBoolVar("sm",i,o));
+
+		f->addEO(vmodes); //Each activity has exactly one execution mode
+	}
+
+	//Creation of st_i,e, en_i,e and x_i,e,o
+	for (int i=1;i<=N;i++){
+		for (int e=firstevent[i];e<lastevent[i];e++)
+			f->newBoolVar("st",i,e);
+		for (int e=firstevent[i] + (ins->getMinDuration(i) > 0 ? 1 : 0);e<K;e++)
+			f->newBoolVar("en",i,e);
+		for (int e=firstevent[i];e<K;e++)
+			for (int o=0;o<ins->getNModes(i);o++)
+				f->newBoolVar("x",i,e,o);
+	}
+
+
+	//Start time integer variables
+	vector<intvar> S(N+2);
+	for (int i=0;i<=N+1;i++){
+		S[i]=f->newIntVar("S",i);
+		if(1 <= i && i <= N){
+			f->addClause(S[i] >= ins->ES(i));
+			f->addClause(S[i] <= ins->LS(i,ub));
+		}
+	}
+
+	//Event dates, strictly increasing
+	vector<intvar> T(K);
+	for (int e=0;e<K;e++){
+		T[e]=f->newIntVar("T",e);
+		if(e==0)
+			f->addClause(T[e] >= 0);
+		else
+			f->addClause(T[e] - T[e-1] >= 1);
+	}
+
+	//Activity 0 starts at time 0
+	f->addClause(S[0] == 0);
+
+	//Set bounds on makespan
+	f->addClause(S[N+1] >= lb);
+	f->addClause(S[N+1] <= ub);
+
+	//Objective function if using OMT
+	if(omt)
+		f->minimize(S[N+1]);
+
+	//Definition of st_i,e and en_i,e
+	for (int i=1;i<=N;i++){
+		int firstend = firstevent[i] + (ins->getMinDuration(i) > 0 ? 1 : 0);
+		for (int e=0;e<K;e++){
+			literal s = st(f,i,e);
+			literal c = en(f,i,e);
+
+			if(firstevent[i] <= e && e < lastevent[i]){
+				f->addClause(!s | S[i] - T[e] <= 0);
+				f->addClause(s | S[i] - T[e] > 0);
+			}
+			else if(e == lastevent[i])
+				f->addClause(S[i] - T[e] <= 0);
+			else if(e == firstevent[i]-1)
+				f->addClause(S[i] - T[e] > 0);
+
+			//Each activity starts at the date of the first event where it has started
+			if(firstevent[i] <= e && e <= lastevent[i])
+				f->addClause(!s | st(f,i,e-1) | S[i] - T[e] >= 0);
+
+			if(e >= firstend){
+				for (int o=0;o<ins->getNModes(i);o++){
+					boolvar sm = f->bvar("sm",i,o);
+					f->addClause(!sm | !c | S[i] - T[e] <= -ins->getDuration(i,o));
+					f->addClause(!sm | c | S[i] - T[e] > -ins->getDuration(i,o));
+				}
+				if(e+1 < K)
+					f->addClause(!c | en(f,i,e+1));
+				f->addClause(!c | st(f,i,firstend > firstevent[i] ? e-1 : e));
+			}
+
+			if(e+1 < K && firstevent[i] <= e && e < lastevent[i])
+				f->addClause(!s | st(f,i,e+1));
+		}
+	}
+
+	//Definition of x_i,e,o: activity i runs in mode o at the date of event e
+	for (int i=1;i<=N;i++){
+		for (int e=firstevent[i];e<K;e++){
+			literal s = st(f,i,e);
+			literal c = en(f,i,e);
+			for (int o=0;o<ins->getNModes(i);o++){
+				boolvar x = f->bvar("x",i,e,o);
+				boolvar sm = f->bvar("sm",i,o);
+				f->addClause(!s | c | !sm | x);
+				f->addClause(!x | sm);
+				f->addClause(!x | s);
+				f->addClause(!x | !c);
+			}
+		}
+	}
+
+	//Precedence constraints
+	for (int i=0;i<=N+1;i++) {
+		for (int j=0;j<=N+1;j++) {
+			//Extended precedences. Implied constraint
+			if(ins->isPred(i,j))
+				f->addClause(S[j] - S[i] >= ins->getExtPrec(i,j));
+		}
+
+		for (int j : ins->getSuccessors(i)) {
+			int min=ins->getMinDuration(i);
+			for (int k=0;k<ins->getNModes(i);k++) {
+				if (min<ins->getDuration(i,k))
+					f->addClause(!f->bvar("sm",i,k) | S[j] - S[i] >= ins->getDuration(i,k));
+			}
+
+			//If j has started at an event, i has finished. Implied constraint
+			if(1 <= i && i <= N && j <= N)
+				for (int e=firstevent[j];e<K;e++)
+					f->addClause(!st(f,j,e) | en(f,i,e));
+		}
+	}
+
+
+	//Renewable resource constraints, at each event
+	vector<int> vtasques;
+	vector<set<int> > groups;
+	for (int i=1;i<=N;i++)
+		vtasques.push_back(i);
+	if(!vtasques.empty())
+		ins->computeMinPathCover(vtasques,groups);
+
+	for (int r=0;r<N_RR;r++) {
+		for (int e=0;e<K;e++) {
+			vector<vector<literal> > X;
+			vector<vector<int> > Q;
+
+			for (const set<int> & group : groups) {
+				vector<literal> vars_part;
+				vector<int> coefs_part;
+
+				for(int i : group){
+					if(firstevent[i] > e)
+						continue;
+					for (int o=0;o<ins->getNModes(i);o++) {
+						int q = ins->getDemand(i,r,o);
+						if(q!=0){
+							vars_part.push_back(f->bvar("x",i,e,o));
+							coefs_part.push_back(q);
+						}
+					}
+				}
+
+				if(!coefs_part.empty()){
+					X.push_back(vars_part);
+					Q.push_back(coefs_part);
+				}
+			}
+
+			util::sortCoefsDecreasing(Q,X);
+
+			if(!X.empty())
+				f->addAMOPB(Q,X,ins->getCapacity(r),sargs->getAMOPBEncoding());
+		}
+	}
+
+
+	//Non-renewable resource constraints
+	for (int r=N_RR;r<N_R;r++) {
+
+		vector<vector<literal> > X;
+		vector<vector<int> > Q;
+		for (int j=1;j<=N;j++) {
+			vector<literal> vars_part;
+			vector<int> coefs_part;
+			for (int g=0;g<ins->getNModes(j);g++) {
+				vars_part.push_back(f->bvar("sm",j,g));
+				coefs_part.push_back(ins->getDemand(j,r,g));
+			}
+			X.push_back(vars_part);
+			Q.push_back(coefs_part);
+		}
+
+		f->addAMOPB(Q,X,ins->getCapacity(r),sargs->getAMOPBEncoding());
+
+	}
+
+	return f;
+}
+
+void SMTEventEncoding::setModel(const EncodedFormula & ef, int lb, int ub, const vector<bool> & bmodel, const vector<int> & imodel){
+	int N = ins->getNActivities();
+
+	this->starts=vector<int>(N+2);
+	this->modes=vector<int>(N+2);
+	for (int i=0;i<=N+1;i++){
+		this->starts[i]=SMTFormula::getIValue(ef.f->ivar("S",i),imodel);
+		for (int p=0;p<ins->getNModes(i);p++){
+			if(SMTFormula::getBValue(ef.f->bvar("sm",i,p),bmodel)){
+				this->modes[i]=p;
+				break;
+			}
+		}
+	}
+}
+
+bool SMTEventEncoding::getModelVars(const EncodedFormula & ef, vector<int> & ivars, vector<int> & bvars) const{
+	int N = ins->getNActivities();
+	for (int i=0;i<=N+1;i++){
+		ivars.push_back(ef.f->ivar("S",i).id);
+		for (int p=0;p<ins->getNModes(i);p++)
+			bvars.push_back(ef.f->bvar("sm",i,p).id);
+	}
+	return true;
+}
+
+bool SMTEventEncoding::narrowBounds(const EncodedFormula & ef, int lastLB, int lastUB, int lb, int ub){
+	int N = ins->getNActivities();
+
+	if(ub <= lastUB){
+		ef.f->addClause(ef.f->ivar("S",N+1) <= ub);
+		ef.f->addClause(ef.f->ivar("S",N+1) >= lb);
+		return true;
+	}
+	else return false;
+}
+
+void SMTEventEncoding::assumeBounds(const EncodedFormula & ef, int lb, int ub, vector<literal> & assumptions){
+	int N = ins->getNActivities();
+	assumptions.push_back(ef.f->ivar("S",N+1) <= ub);
+	assumptions.push_back(ef.f->ivar("S",N+1) >= lb);
+}
+
+bool SMTEventEncoding::getStartVar(const EncodedFormula & ef, int i, intvar & s) const{
+	s = ef.f->ivar("S",i);
+	return true;
+}
+
+literal SMTEventEncoding::getModeLiteral(const EncodedFormula & ef, int i, int mode) const{
+	return ef.f->bvar("sm",i,mode);
+}
+
+SMTEventEncoding::~SMTEventEncoding() {
+
+}
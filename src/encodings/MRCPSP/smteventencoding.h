@@ -0,0 +1,59 @@
+#ifndef SMTEVENTENCODING_DEFINITION
+#define SMTEVENTENCODING_DEFINITION
+
+
+#include <vector>
+
+#include <sstream>
+#include <stdio.h>
+#include <iostream>
+#include "mrcpspencoding.h"
+#include "solvingarguments.h"
+
+using namespace std;
+
+/*
+ * On/off event-based encoding. There are N events with strictly increasing
+ * integer dates T_e, and every non-dummy activity starts at the date of some
+ * event. st_{i,e} holds iff S_i <= T_e, and en_{i,e} iff S_i + p_i <= T_e, so
+ * activity i is in process at event e iff st_{i,e} and not en_{i,e}. The
+ * renewable resources are checked at each event, which suffices because the
+ * usage can only increase at start times. The size of the formula depends on
+ * the number of activities and modes, but not on the upper bound.
+ */
+class SMTEventEncoding : public MRCPSPEncoding {
+
+private:
+
+	bool omt;
+	SolvingArguments *sargs;
+
+	//Events where each activity can start at the earliest, and must have started at the latest
+	vector<int> firstevent;
+	vector<int> lastevent;
+	void computeEventWindows();
+
+	literal st(SMTFormula * f, int i, int e) const;
+	literal en(SMTFormula * f, int i, int e) const;
+
+
+protected:
+
+	bool getStartVar(const EncodedFormula & ef, int i, intvar & s) const;
+	literal getModeLiteral(const EncodedFormula & ef, int i, int mode) const;
+
+public:
+
+	SMTEventEncoding(MRCPSP * instance, SolvingArguments *sargs, bool omt);
+	SMTFormula * encode(int lb = INT_MIN, int ub = INT_MAX);
+	void setModel(const EncodedFormula & ef, int lb, int ub, const vector<bool> & bmodel, const vector<int> & imodel);
+	bool getModelVars(const EncodedFormula & ef, vector<int> & ivars, vector<int> & bvars) const;
+	bool narrowBounds(const EncodedFormula & ef, int lastLB, int lastUB, int lb, int ub);
+	void assumeBounds(const EncodedFormula & ef, int LB, int ub, vector<literal> & assumptions);
+
+	~SMTEventEncoding();
+
+};
+
+#endif
+
@@ -136,12 +136,12 @@ SMTFormula * SMTTaskEncoding::encode(int lb, int ub){
 				Q.push_back(coefs_part);
 			}
 
-			//Get the terms for activity 'j'
+			//Get the terms for activity 'j'. A mode of duration 0 does not use the resource at its start
 			vector<literal> vars_part;
 			vector<int> coefs_part;
 			int minCoef = INT_MAX;
 			for (int o=0;o<ins->getNModes(j);o++) {
-				int q = ins->getDemand(j,r,o);
+				int q = ins->getDuration(j,o) == 0 ? 0 : ins->getDemand(j,r,o);
 				if(q < minCoef)
 					minCoef=q;
 				coefs_part.push_back(q);
@@ -199,6 +199,16 @@ void SMTTaskEncoding::setModel(const EncodedFormula & ef, int lb, int ub, const
 	}
 }
 
+bool SMTTaskEncoding::getModelVars(const EncodedFormula & ef, vector<int> & ivars, vector<int> & bvars) const{
+	int N = ins->getNActivities();
+	for (int i=0;i<=N+1;i++){
+		ivars.push_back(ef.f->ivar("S",i).id);
+		for (int p=0;p<ins->getNModes(i);p++)
+			bvars.push_back(ef.f->bvar("sm",i,p).id);
+	}
+	return true;
+}
+
 bool SMTTaskEncoding::narrowBounds(const EncodedFormula & ef, int lastLB, int lastUB, int lb, int ub){
 	int N = ins->getNActivities();
 
@@ -216,6 +226,15 @@ void SMTTaskEncoding::assumeBounds(const EncodedFormula & ef, int lb, int ub, ve
 	assumptions.push_back(ef.f->ivar("S",N+1) >= lb);
 }
 
+bool SMTTaskEncoding::getStartVar(const EncodedFormula & ef, int i, intvar & s) const{
+	s = ef.f->ivar("S",i);
+	return true;
+}
+
+literal SMTTaskEncoding::getModeLiteral(const EncodedFormula & ef, int i, int mode) const{
+	return ef.f->bvar("sm",i,mode);
+}
+
 SMTTaskEncoding::~SMTTaskEncoding() {
 
 }
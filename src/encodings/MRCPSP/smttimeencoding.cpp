@@ -20,6 +20,10 @@ SMTFormula * SMTTimeEncoding::encode(int lb, int ub){
 
 	SMTFormula * f = new SMTFormula();
 
+	//The renewable resources are only checked where some activity can start
+	vector<bool> startevent;
+	ins->getStartEvents(ub,startevent);
+
 	//Execution modes of the activities
 	for (int i=0;i<=N+1;i++) {
 		vector<literal> vmodes;
@@ -32,8 +36,9 @@ SMTFormula * SMTTimeEncoding::encode(int lb, int ub){
 	//Creation of x_i,t,o
 	for (int i=0;i<=N+1;i++)
 		for (int g=0;g<ins->getNModes(i);g++)
-			for (int t=ins->ES(i);t<ins->LC(i,ub);t++)
-				f->newBoolVar("x",i,t,g);
+			for (int t=ins->ES(i);t<ins->LC(i,ub,g);t++)
+				if(startevent[t])
+					f->newBoolVar("x",i,t,g);
 
 
 	//Start time integer variables
@@ -60,7 +65,9 @@ SMTFormula * SMTTimeEncoding::encode(int lb, int ub){
 	//Definition of x_i,t,o
 	for (int i=1;i<=N;i++) {
 		for (int g=0;g<ins->getNModes(i);g++) {
-			for (int t=ins->ES(i);t<ins->LC(i,ub);t++) {
+			for (int t=ins->ES(i);t<ins->LC(i,ub,g);t++) {
+				if(!startevent[t])
+					continue;
 				boolvar x = f->bvar("x",i,t,g);
 				boolvar sm = f->bvar("sm",i,g);
 				literal geSi = S[i] <= t;
@@ -105,6 +112,8 @@ SMTFormula * SMTTimeEncoding::encode(int lb, int ub){
 	for (int r=0;r<N_RR;r++) {
 
 		for (int t=0;t<ub;t++) {
+			if(!startevent[t])
+				continue;
 			vector<vector<literal> > X;
 			vector<vector<int> > Q;
 
@@ -128,6 +137,8 @@ SMTFormula * SMTTimeEncoding::encode(int lb, int ub){
 
 				for(int i : group){
 					for (int g=0;g<ins->getNModes(i);g++) {
+						if(t >= ins->LC(i,ub,g))
+							continue;
 						vars_part.push_back(f->bvar("x",i,t,g));
 						coefs_part.push_back(ins->getDemand(i,r,g));
 					}
@@ -183,16 +194,29 @@ void SMTTimeEncoding::setModel(const EncodedFormula & ef, int lb, int ub, const
 	}
 }
 
+bool SMTTimeEncoding::getModelVars(const EncodedFormula & ef, vector<int> & ivars, vector<int> & bvars) const{
+	int N = ins->getNActivities();
+	for (int i=0;i<=N+1;i++){
+		ivars.push_back(ef.f->ivar("S",i).id);
+		for (int p=0;p<ins->getNModes(i);p++)
+			bvars.push_back(ef.f->bvar("sm",i,p).id);
+	}
+	return true;
+}
+
 bool SMTTimeEncoding::narrowBounds(const EncodedFormula & ef, int lastLB, int lastUB, int lb, int ub){
 	int N = ins->getNActivities();
 
 	if(ub <= lastUB){
 		ef.f->addClause(ef.f->ivar("S",N+1) <= ub);
 		ef.f->addClause(ef.f->ivar("S",N+1) >= lb);
+		vector<bool> startevent;
+		ins->getStartEvents(ef.UB,startevent);
 		for(int i = 1; i <= N; i++)
-			for(int t = max(ins->ES(i),ins->LC(i,ub)); t < ins->LC(i,lastUB); t++)
-				for(int g = 0; g < ins->getNModes(i); g++)
-					ef.f->addClause(!ef.f->bvar("x",i,t,g));
+			for(int g = 0; g < ins->getNModes(i); g++)
+				for(int t = max(ins->ES(i),ins->LC(i,ub,g)); t < ins->LC(i,lastUB,g); t++)
+					if(startevent[t])
+						ef.f->addClause(!ef.f->bvar("x",i,t,g));
 
 		return true;
 	}
@@ -205,6 +229,15 @@ void SMTTimeEncoding::assumeBounds(const EncodedFormula & ef, int lb, int ub, ve
 	assumptions.push_back(ef.f->ivar("S",N+1) >= lb);
 }
 
+bool SMTTimeEncoding::getStartVar(const EncodedFormula & ef, int i, intvar & s) const{
+	s = ef.f->ivar("S",i);
+	return true;
+}
+
+literal SMTTimeEncoding::getModeLiteral(const EncodedFormula & ef, int i, int mode) const{
+	return ef.f->bvar("sm",i,mode);
+}
+
 SMTTimeEncoding::~SMTTimeEncoding() {
 
 }
@@ -20,11 +20,17 @@ private:
 	SolvingArguments *sargs;
 
 
+protected:
+
+	bool getStartVar(const EncodedFormula & ef, int i, intvar & s) const;
+	literal getModeLiteral(const EncodedFormula & ef, int i, int mode) const;
+
 public:
 
 	SMTTimeEncoding(MRCPSP * instance, SolvingArguments *sargs, bool omt);
 	SMTFormula * encode(int lb = INT_MIN, int ub = INT_MAX);
 	void setModel(const EncodedFormula & ef, int lb, int ub, const vector<bool> & bmodel, const vector<int> & imodel);
+	bool getModelVars(const EncodedFormula & ef, vector<int> & ivars, vector<int> & bvars) const;
 	bool narrowBounds(const EncodedFormula & ef, int lastLB, int lastUB, int lb, int ub);
 	void assumeBounds(const EncodedFormula & ef, int LB, int ub, vector<literal> & assumptions);
 
@@ -1,4 +1,7 @@
 #include "parser.h"
+#include <csignal>
+#include <mutex>
+#include <sys/stat.h>
 #include "errors.h"
 #include "encoder.h"
 #include "solvingarguments.h"
@@ -8,30 +11,140 @@
 #include "mrcpspencoding.h"
 #include "smttimeencoding.h"
 #include "smttaskencoding.h"
+#include "smteventencoding.h"
 #include "order.h"
 #include "doubleorder.h"
 #include "omtsatpbencoding.h"
 #include "omtsoftpbencoding.h"
 #include "mrcpspsatencoding.h"
+#include "formulasimplifier.h"
+#include "mrcpsplns.h"
+#include "solverdaemon.h"
 
 
+//Encoder running the search, and the SIGINT/SIGTERM handler that cancels it
+static Encoder * runningEncoder = NULL;
+
+static void cancelSearch(int){
+	if(runningEncoder != NULL)
+		runningEncoder->cancel();
+}
+
 /*
  * Enumeration of all the accepted program arguments
  */
 enum ProgramArg {
 	COMPUTE_UB,
+	MODE_REDUCTION,
+	NR_FILTER,
+	TIME_WINDOWS,
+	COARSENING,
+	LNS_TIME,
+	LNS_THREADS,
+	LNS_SIZE,
+	LNS_PROBE,
+	LNS_SEED,
+	DAEMON,
+	DAEMON_WORKERS,
+	DAEMON_CACHE,
 	ENCODING
 };
 
+static MRCPSPEncoding * newEncoding(const string & s_encoding, MRCPSP * instance, SolvingArguments * sargs){
+	if(s_encoding=="smttime")
+		return new SMTTimeEncoding(instance,sargs,false);
+	else if(s_encoding=="smttask")
+		return new SMTTaskEncoding(instance,sargs,false);
+	else if(s_encoding=="smtevent")
+		return new SMTEventEncoding(instance,sargs,false);
+	else if(s_encoding=="doubleorder")
+		return new DoubleOrder(instance, sargs->getAMOPBEncoding(), false);
+	else if(s_encoding=="omtsatpb")
+		return new OMTSATPBEncoding(instance);
+	else if(s_encoding=="omtsoftpb")
+		return new OMTSoftPBEncoding(instance);
+	return NULL;
+}
 
-int main(int argc, char **argv) {
+//Prints a schedule found outside the optimizer, as the ones found by it
+static void printSchedule(MRCPSP * instance, const vector<int> & starts, const vector<int> & modes, SolvingArguments * sargs, ostream & os){
+	if(sargs->getBoolOption(PRODUCE_MODELS) && sargs->getBoolOption(PRINT_NOOPTIMAL_SOLUTIONS)){
+		os << "v ";
+		instance->printSolution(os,starts,modes);
+		os << std::endl;
+	}
+}
+
+/*
+ * Coarse-to-fine upper bounds. Each level optimizes the instance with the durations
+ * rounded up to multiples of delta (see MRCPSP::coarsen), with delta halved after
+ * each level while it is even, so it divides the one of the previous level. The best
+ * schedule of a level, with its start times scaled, is a schedule of the next level,
+ * and bounds its makespan. The coarse levels only give upper bounds: their optima
+ * are not lower bounds of the original instance.
+ * Returns the makespan of the best schedule of 'instance' if it is below UB, and leaves
+ * it in starts and modes. Otherwise returns UB and leaves them empty.
+ */
+static int coarseToFine(MRCPSP * instance, int delta, int UB, const string & s_encoding, SolvingArguments * sargs, bool stats, ostream & os, vector<int> & starts, vector<int> & modes){
+	int N = instance->getNActivities();
+	int lastdelta = 1;
 
-	Arguments<ProgramArg> * pargs
-	= new Arguments<ProgramArg>(
+	for(; delta > 1; delta = delta%2==0 ? delta/2 : 1){
+		MRCPSP * coarse = instance->coarsen(delta);
+		coarse->computeExtPrecs();
+		coarse->computeSteps();
+
+		int cUB = coarse->trivialUB();
+		if(!starts.empty()){
+			for(int i = 0; i <= N; i++)
+				starts[i] *= lastdelta/delta;
+			cUB = min(cUB,coarse->computeMakespan(starts,modes));
+		}
+
+		if(coarse->computeTimeWindows(cUB-1)){
+			MRCPSPEncoding * encoding = newEncoding(s_encoding,coarse,sargs);
+			if(!starts.empty())
+				encoding->setStartsAndModes(starts,modes);
+			Optimizer * opti = sargs->getOptimizer();
+			Encoder * e = sargs->getEncoder(encoding);
+			int opt = opti->minimize(e,0,cUB-1,sargs->getBoolOption(USE_ASSUMPTIONS),sargs->getBoolOption(NARROW_BOUNDS));
+			if(opt!=INT_MIN){
+				encoding->getStartsAndModes(starts,modes);
+				cUB = coarse->computeMakespan(starts,modes);
+			}
+			delete opti;
+			delete e;
+			delete encoding;
+		}
+		lastdelta = delta;
+		delete coarse;
+
+		if(stats)
+			os << "c coarsening " << delta << " ub " << (starts.empty() ? UB : delta*cUB) << std::endl;
+	}
+
+	if(starts.empty())
+		return UB;
+
+	for(int i = 0; i <= N; i++)
+		starts[i] *= lastdelta;
+	int makespan = instance->computeMakespan(starts,modes);
+	if(makespan >= UB){
+		starts.clear();
+		modes.clear();
+		return UB;
+	}
+	return makespan;
+}
+
+
+
+static Arguments<ProgramArg> * newProgramArguments(){
+	return new Arguments<ProgramArg>(
 
 	//Program arguments
 	{
-	arguments::arg("filename","Instance file name.")
+	arguments::arg("filename","Instance file name, or the socket path with --daemon=1.")
 	},
 	1,
 
@@ -41,39 +154,144 @@ int main(int argc, char **argv) {
 	//Problem specific preprocessing
 	arguments::bop("U","upper",COMPUTE_UB,true,
 	"If 1, compute a better upper bound than the trivial one using a greedy heuristic. If an upper bound is specified with -u, upper is set to 0. Default: 1."),
+	arguments::bop("M","mode-reduction",MODE_REDUCTION,true,
+	"If 1, remove non-executable and inefficient modes and redundant non-renewable resources before encoding. Default: 1."),
+	arguments::bop("D","nr-filter",NR_FILTER,true,
+	"If 1, remove the modes that cannot be combined with modes of the other activities within the non-renewable capacities. Default: 1."),
+	arguments::bop("T","time-windows",TIME_WINDOWS,true,
+	"If 1, tighten the time windows of the activities by resource propagation before encoding. Default: 1."),
+	arguments::iop("C","coarsening",COARSENING,1,
+	"If greater than 1, before the exact search, optimize coarser instances with the durations rounded up to multiples of this factor, and then of its halves while it is even. Their schedules give upper bounds and initial phases to the finer levels. Default: 1."),
+	arguments::iop("","lns-time",LNS_TIME,0,
+	"Seconds of large neighbourhood search around the best known schedule before the exact search, which starts from its makespan. 0 disables it. Default: 0."),
+	arguments::iop("","lns-threads",LNS_THREADS,4,
+	"Neighbourhoods solved in parallel in each round of the neighbourhood search. Default: 4."),
+	arguments::iop("","lns-size",LNS_SIZE,8,
+	"Initial number of activities freed by each neighbourhood. It adapts to the outcome of the rounds. Default: 8."),
+	arguments::iop("","lns-probe",LNS_PROBE,2,
+	"Seconds of each neighbourhood probe. Default: 2."),
+	arguments::iop("","lns-seed",LNS_SEED,1,
+	"Seed of the choice of the neighbourhoods. Default: 1."),
+	arguments::bop("","daemon",DAEMON,false,
+	"If 1, serve solving requests on the Unix domain socket given as file name, keeping the preprocessed instances and their best schedules across requests. Default: 0."),
+	arguments::iop("","daemon-workers",DAEMON_WORKERS,2,
+	"Requests served concurrently by the daemon. Default: 2."),
+	arguments::iop("","daemon-cache",DAEMON_CACHE,32,
+	"Instances kept by the daemon. The least recently requested ones are discarded beyond it, and those of a modified file on its next request. Default: 32."),
 	//Encoding parameters
 	arguments::sop("E","encoding",ENCODING,"smttime",
-	{"smttime","smttask","omtsatpb","omtsoftpb","order","doubleorder"},
-	"Encoding of the problem. SMT-based require an SMT solver. Default: smttime.")
+	{"smttime","smttask","smtevent","omtsatpb","omtsoftpb","order","doubleorder"},
+	"Encoding of the problem. SMT-based require an SMT solver. smtevent has a size independent of the upper bound, for long durations. Default: smttime.")
 	},
 	"Solve the Multi-mode Resource-Constrained Project Scheduling Problem (MRCPSP)."
 	);
+}
 
+//Preprocessing that does not depend on the upper bound. False if the instance is infeasible
+static bool preprocess(MRCPSP * instance, Arguments<ProgramArg> * pargs, bool stats, ostream & os){
+	if(pargs->getBoolOption(MODE_REDUCTION)){
+		if(!instance->reduceModes())
+			return false;
+		if(stats)
+			os << "c removed modes " << instance->getNRemovedModes() << " resources " << instance->getNRemovedResources() << std::endl;
+	}
 
-	SolvingArguments * sargs = SolvingArguments::readArguments(argc,argv,pargs);
+	if(pargs->getBoolOption(NR_FILTER)){
+		if(!instance->filterNRModes())
+			return false;
+		if(stats)
+			os << "c non-renewable pruned modes " << instance->getNNRPrunedModes() << std::endl;
+	}
 
-	MRCPSP * instance = parser::parseMRCPSP(pargs->getArgument(0));
+	//The closure of an edited instance is kept up to date by the mode reductions
+	if(!instance->hasPrecedenceClosure()){
+		instance->computeExtPrecs();
+		instance->computeSteps();
+	}
+	return true;
+}
+
+/*
+ * Solves a preprocessed instance, writing the output to 'os'. If starts is not empty, it is a
+ * schedule of makespan UB, used as the initial phase. Otherwise UB is only an upper bound.
+ * Returns the best makespan, with its schedule left in starts and modes if one was found, and
+ * sets 'optimal' if it is proved optimal. 'setRunning' is called with the encoder of the exact
+ * search before it starts, and with NULL when it finishes.
+ */
+static int solve(MRCPSP * instance, Arguments<ProgramArg> * pargs, SolvingArguments * sargs, int UB,
+		vector<int> & starts, vector<int> & modes, bool & optimal, ostream & os, function<void(Encoder *)> setRunning){
+
+	bool output = sargs->getBoolOption(OUTPUT_ENCODING);
+	bool stats = sargs->getBoolOption(PRINT_CHECKS_STATISTICS) && !output;
+	optimal = false;
 
-	MRCPSPEncoding * encoding = NULL;
 	string s_encoding = pargs->getStringOption(ENCODING);
 
-	if(s_encoding=="smttime")
-		encoding = new SMTTimeEncoding(instance,sargs,false);
-	else if(s_encoding=="smttask")
-		encoding = new SMTTaskEncoding(instance,sargs,false);
-	else if(s_encoding=="doubleorder")
-		encoding = new DoubleOrder(instance, sargs->getAMOPBEncoding(), false);
-	else if(s_encoding=="omtsatpb")
-		encoding = new OMTSATPBEncoding(instance);
-	else if(s_encoding=="omtsoftpb")
-		encoding = new OMTSoftPBEncoding(instance);
+	//Upper bound and initial schedule from coarser time scales
+	if(pargs->getIntOption(COARSENING) > 1 && starts.empty() && !output && sargs->getAMOPBEncoding()!=AMOPB_DRYRUN){
+		UB = coarseToFine(instance,pargs->getIntOption(COARSENING),UB,s_encoding,sargs,stats,os,starts,modes);
+		if(!starts.empty())
+			printSchedule(instance,starts,modes,sargs,os);
+	}
 
-	int UB = sargs->getIntOption(UPPER_BOUND);
+	//Windows are tightened for the largest makespan that will be encoded
+	if(pargs->getBoolOption(TIME_WINDOWS) && !instance->computeTimeWindows(output ? UB : UB-1)){
+		if(output)
+			BasicController::onProvedUNSAT(os);
+		else{ //No schedule better than the one of makespan UB
+			BasicController::onProvedOptimum(UB,os);
+			optimal = true;
+		}
+		return UB;
+	}
+	if(pargs->getBoolOption(TIME_WINDOWS) && stats)
+		os << "c time window reductions " << instance->getNTimeWindowReductions() << std::endl;
+	if(stats)
+		os << "c pairwise preprocessing time " << instance->getPairwiseTime() << std::endl;
+
+	//Large neighbourhood search around the best known schedule
+	if(pargs->getIntOption(LNS_TIME) > 0 && !output && sargs->getAMOPBEncoding()!=AMOPB_DRYRUN){
+		MRCPSPLNS lns(instance,sargs,[&](MRCPSP * ins){return newEncoding(s_encoding,ins,sargs);},
+			pargs->getIntOption(LNS_THREADS),pargs->getIntOption(LNS_SIZE),
+			pargs->getIntOption(LNS_PROBE),pargs->getIntOption(LNS_SEED));
+		int makespan = lns.run(instance->trivialLB(),UB,starts,modes,pargs->getIntOption(LNS_TIME),stats,os);
+		if(stats)
+			os << "c lns rounds " << lns.getNRounds() << " improvements " << lns.getNImprovements() << std::endl;
+		if(makespan < UB){
+			UB = makespan;
+			printSchedule(instance,starts,modes,sargs,os);
+			if(pargs->getBoolOption(TIME_WINDOWS) && !instance->computeTimeWindows(UB-1)){
+				BasicController::onProvedOptimum(UB,os);
+				optimal = true;
+				return UB;
+			}
+		}
+	}
 
-	if(sargs->getBoolOption(OUTPUT_ENCODING)){
+	MRCPSPEncoding * encoding = newEncoding(s_encoding,instance,sargs);
+	if(!starts.empty())
+		encoding->setStartsAndModes(starts,modes);
+
+	if(sargs->getAMOPBEncoding()==AMOPB_DRYRUN){
+		//Formula at the largest makespan, with the predicted sizes of its AMO-PB constraints
+		SMTFormula * f = encoding->encode(0,UB);
+		os << "c formula without amopb vars " << f->getNBoolVars() << " clauses " << f->getNClauses() << std::endl;
+		for(const std::pair<const AMOPBEncoding,AMOPBSize> & p : f->getAMOPBPredictions())
+			os << "c amopb " << SolvingArguments::getAMOPBEncodingName(p.first)
+				<< " vars " << p.second.vars << " clauses " << p.second.clauses << std::endl;
+		for(const std::pair<const AMOPBEncoding,int> & p : f->getAMOPBChoices())
+			os << "c amopb auto chooses " << SolvingArguments::getAMOPBEncodingName(p.first) << " " << p.second << std::endl;
+		delete f;
+	}
+	else if(output){
 		FileEncoder * e = sargs->getFileEncoder(encoding);
 		SMTFormula * f = encoding->encode(0,UB);
-		e->createFile(std::cout,f);
+		if(sargs->getBoolOption(SIMPLIFY) && f->getType()==SATFORMULA){
+			FormulaSimplifier s(f);
+			e->createFile(os,s.getFormula());
+		}
+		else
+			e->createFile(os,f);
 		delete e;
 		delete f;
 	}
@@ -83,35 +301,399 @@ int main(int argc, char **argv) {
 		Encoder * e = sargs->getEncoder(encoding);
 
 		if(sargs->getBoolOption(PRINT_CHECKS_STATISTICS)){
-			opti->setAfterSatisfiabilityCall([=](int lb, int ub, Encoder * encoder){BasicController::afterSatisfiabilityCall(lb,ub,encoder);});
-			opti->setAfterNativeOptimizationCall([=](int lb, int ub, Encoder * encoder){BasicController::afterNativeOptimizationCall(lb,ub,encoder);});
+			opti->setAfterSatisfiabilityCall([&](int lb, int ub, Encoder * encoder){BasicController::afterSatisfiabilityCall(lb,ub,encoder,os);});
+			opti->setAfterNativeOptimizationCall([&](int lb, int ub, Encoder * encoder){BasicController::afterNativeOptimizationCall(lb,ub,encoder,os);});
 		}
 
 		if(sargs->getBoolOption(PRINT_CHECKS))
-			opti->setOnNewBoundsProved([=](int lb, int ub){BasicController::onNewBoundsProved(lb,ub);});
+			opti->setOnNewBoundsProved([&](int lb, int ub){BasicController::onNewBoundsProved(lb,ub,os);});
 		
 		if(sargs->getBoolOption(PRODUCE_MODELS) && sargs->getBoolOption(PRINT_NOOPTIMAL_SOLUTIONS))
-			opti->setOnSATSolutionFound([=](int & lb, int & ub, int & obj_val){BasicController::onSATSolutionFound(lb,ub,obj_val,encoding);});
+			opti->setOnSATSolutionFound([&](int & lb, int & ub, int & obj_val){BasicController::onSATSolutionFound(lb,ub,obj_val,encoding,os);});
 		
 		UB--; //Solution for UB already found, start with next value
-		
+
+		//On timeout or cancellation, report the best makespan and the proved lower bound
+		int provedLB = 0;
+		opti->setOnBudgetExhausted([&](int lb, int ub, int obj_val){provedLB = lb;});
+
+		setRunning(e);
 		int opt = opti->minimize(e,0,UB,sargs->getBoolOption(USE_ASSUMPTIONS),sargs->getBoolOption(NARROW_BOUNDS));
+		setRunning(NULL);
 
 		if(opt==INT_MIN) //If no better solution found than the one found in the greedy heuristic, that is the objective
 			opt = UB+1;
+		else if(sargs->getBoolOption(PRODUCE_MODELS))
+			encoding->getStartsAndModes(starts,modes);
 
-		BasicController::onProvedOptimum(opt);
+		if(opti->isInterrupted())
+			BasicController::onBudgetExhausted(provedLB,opt,opt,os);
+		else{
+			BasicController::onProvedOptimum(opt,os);
+			optimal = true;
+		}
+		UB = opt;
 
 		delete opti;
 		delete e;
 
 	}
 
+	delete encoding;
+	return UB;
+}
+
+
+/*
+ * State of the daemon for an instance file, with the modifications of its request and the
+ * preprocessing options. Requests on the same instance are served one at a time, and share
+ * its preprocessing (including the time windows, tightened for the best known makespan) and
+ * its best schedule, which is the initial upper bound and phase of the next requests.
+ * An instance with more modifications derives from the unreduced one of the longest prefix
+ * of its modifications, and starts from the repair of its best schedule.
+ * Only the instances not in use by any request are discarded (see releaseCachedInstance).
+ */
+struct CachedInstance{
+	mutex lock;
+	string filename;
+	time_t mtime;
+	int users; //Requests using it, also as a base, under cachelock
+	unsigned long lastuse; //Request count at its last use, under cachelock
+	MRCPSP * original; //Modified instance with its precedence closure and without mode reductions. Immutable once set, under cachelock
+	MRCPSP * instance; //Preprocessed instance, NULL until the first request
+	bool feasible;
+	int makespan; //Best known makespan, INT_MAX if none
+	vector<int> starts;
+	vector<int> modes;
+	bool optimal; //The schedule is optimal
+};
+
+static map<string,CachedInstance *> cachedInstances;
+static mutex cachelock;
+static unsigned long cacheRequests = 0;
+static int cacheLimit = 32;
+
+static void deleteCachedInstance(CachedInstance * c){
+	delete c->original;
+	delete c->instance;
+	delete c;
+}
+
+//Ends the use of an instance by a request, and discards the unused instances of older versions
+//of its file and the least recently used ones beyond the limit
+static void releaseCachedInstance(CachedInstance * c){
+	lock_guard<mutex> lock(cachelock);
+	c->users--;
+	for(map<string,CachedInstance *>::iterator it = cachedInstances.begin(); it != cachedInstances.end();){
+		if(it->second->users == 0 && it->second->filename == c->filename && it->second->mtime != c->mtime){
+			deleteCachedInstance(it->second);
+			it = cachedInstances.erase(it);
+		}
+		else
+			++it;
+	}
+	while(cachedInstances.size() > cacheLimit){
+		map<string,CachedInstance *>::iterator lru = cachedInstances.end();
+		for(map<string,CachedInstance *>::iterator it = cachedInstances.begin(); it != cachedInstances.end(); ++it)
+			if(it->second->users == 0 && (lru == cachedInstances.end() || it->second->lastuse < lru->second->lastuse))
+				lru = it;
+		if(lru == cachedInstances.end())
+			break;
+		deleteCachedInstance(lru->second);
+		cachedInstances.erase(lru);
+	}
+}
+
+//Use of an instance by a request until the end of the scope
+struct CachedInstanceUse{
+	CachedInstance * c;
+	CachedInstanceUse(CachedInstance * c) : c(c) {}
+	~CachedInstanceUse(){ if(c != NULL) releaseCachedInstance(c); }
+};
+
+//Key of an instance file with the first n modifications of a request
+static string cacheKey(const string & filename, const struct stat & st, Arguments<ProgramArg> * pargs, const vector<string> & deltas, int n){
+	ostringstream key;
+	key << filename << "\n" << st.st_mtime << "\n" << pargs->getBoolOption(MODE_REDUCTION) << pargs->getBoolOption(NR_FILTER)
+		<< pargs->getBoolOption(TIME_WINDOWS);
+	for(int k = 0; k < n; k++)
+		key << "\n" << deltas[k];
+	return key.str();
+}
+
+//Applies a modification of an unreduced instance, in the numbering of the printed schedules (activities
+//from 0, modes and resources from 1). False and 'error' set if it is not valid
+static bool applyDelta(MRCPSP * instance, const string & delta, string & error){
+	istringstream is(delta);
+	string op;
+	int i, m, r, v;
+	is >> op;
+	if(op == "capacity" && is >> r >> v && r >= 1 && r <= instance->getNResources() && v >= 0)
+		instance->changeCapacity(r-1,v);
+	else if(op == "duration" && is >> i >> m >> v && i >= 0 && i <= instance->getNActivities()+1
+			&& m >= 1 && m <= instance->getNModes(i) && v >= 0)
+		instance->changeDuration(i,m-1,v);
+	else if(op == "demand" && is >> i >> m >> r >> v && i >= 0 && i <= instance->getNActivities()+1
+			&& m >= 1 && m <= instance->getNModes(i) && r >= 1 && r <= instance->getNResources() && v >= 0)
+		instance->changeDemand(i,r-1,m-1,v);
+	else if(op == "precedence" && is >> i >> m && i >= 0 && i <= instance->getNActivities()+1
+			&& m >= 0 && m <= instance->getNActivities()+1 && i != m){
+		if(!instance->addPrecedence(i,m)){
+			error = "precedence closes a cycle: " + delta;
+			return false;
+		}
+	}
+	else if(op == "no-precedence" && is >> i >> m && i >= 0 && i <= instance->getNActivities()+1
+			&& m >= 0 && m <= instance->getNActivities()+1){
+		if(!instance->removePrecedence(i,m)){
+			error = "no removable precedence: " + delta;
+			return false;
+		}
+	}
+	else{
+		error = "invalid modification: " + delta;
+		return false;
+	}
+	return true;
+}
+
+/*
+ * Serves a daemon request: the options and the instance file as in the command line, followed
+ * by modifications of the instance (see applyDelta). Errors in the request are reported to the
+ * client instead of exiting.
+ */
+static void serveRequest(const SolverDaemon::Request & request, ostream & os, function<void(Encoder *)> setRunning){
+	vector<string> args(1,"mrcpsp2smt");
+	args.insert(args.end(),request.args.begin(),request.args.end());
+	vector<char *> argv;
+	for(string & a : args)
+		argv.push_back(&a[0]);
+
+	string error;
+	Arguments<ProgramArg> * pargs = newProgramArguments();
+	SolvingArguments * sargs = SolvingArguments::parseArguments(argv.size(),argv.data(),pargs,error);
+	bool output = sargs != NULL && sargs->getBoolOption(OUTPUT_ENCODING);
+	string filename;
+	struct stat st;
+
+	if(sargs == NULL)
+		;
+	else if(pargs->getBoolOption(DAEMON))
+		error = "a request cannot start a daemon";
+	else if(!output && sargs->getAMOPBEncoding()!=AMOPB_DRYRUN && !sargs->checkEncoder(error))
+		;
+	else{
+		filename = pargs->getArgument(0);
+		string extension = filename.substr(filename.rfind(".")+1);
+		transform(extension.begin(),extension.end(),extension.begin(),::tolower);
+		if(extension!="mm" && extension!="sm" && extension!="mm2" && extension!="rcp" && extension!="prb" && extension!="data")
+			error = "bad input file extension";
+		else if(stat(filename.c_str(),&st)!=0 || !ifstream(filename).is_open())
+			error = "could not open file " + filename;
+	}
+	if(!error.empty()){
+		os << "c error: " << error << std::endl;
+		delete sargs;
+		delete pargs;
+		return;
+	}
+
+	bool stats = sargs->getBoolOption(PRINT_CHECKS_STATISTICS) && !output;
+
+	//Same file, modifications and preprocessing options, same instance
+	string key = cacheKey(filename,st,pargs,request.data,request.data.size());
+
+	CachedInstance * c;
+	{
+		lock_guard<mutex> lock(cachelock);
+		map<string,CachedInstance *>::iterator it = cachedInstances.find(key);
+		if(it == cachedInstances.end()){
+			c = new CachedInstance();
+			c->filename = filename;
+			c->mtime = st.st_mtime;
+			c->users = 0;
+			c->original = NULL;
+			c->instance = NULL;
+			c->feasible = true;
+			c->makespan = INT_MAX;
+			c->optimal = false;
+			cachedInstances[key] = c;
+		}
+		else
+			c = it->second;
+		c->users++;
+		c->lastuse = ++cacheRequests;
+	}
+	//Released after its lock
+	CachedInstanceUse use(c);
+	lock_guard<mutex> lock(c->lock);
+
+	if(c->instance == NULL){
+		CachedInstance * base = NULL;
+		int nbase = request.data.size();
+		{
+			lock_guard<mutex> lock(cachelock);
+			while(base == NULL && nbase > 0){
+				nbase--;
+				map<string,CachedInstance *>::iterator it = cachedInstances.find(cacheKey(filename,st,pargs,request.data,nbase));
+				if(it != cachedInstances.end() && it->second->original != NULL)
+					base = it->second;
+			}
+			if(base != NULL)
+				base->users++;
+		}
+		CachedInstanceUse baseuse(base);
+
+		//Best schedule of the base instance, with the original indices of its modes. It is skipped if a request is using it
+		vector<int> warmstarts, warmmodes;
+		if(base != NULL && base->lock.try_lock()){
+			if(!base->starts.empty()){
+				warmstarts = base->starts;
+				for(int i = 0; i < base->modes.size(); i++)
+					warmmodes.push_back(base->instance->getModeId(i,base->modes[i]));
+			}
+			base->lock.unlock();
+		}
+
+		MRCPSP * original;
+		if(base != NULL){
+			original = base->original->clone();
+			if(stats)
+				os << "c daemon derives the instance from the one with " << nbase << " modifications" << std::endl;
+		}
+		else{
+			original = parser::parseMRCPSP(filename);
+			original->computeExtPrecs();
+			original->computeSteps();
+		}
+		for(int k = nbase; k < request.data.size(); k++){
+			if(!applyDelta(original,request.data[k],error)){
+				os << "c error: " << error << std::endl;
+				delete original;
+				delete sargs;
+				delete pargs;
+				return;
+			}
+		}
+
+		MRCPSP * instance = original->clone();
+		c->feasible = preprocess(instance,pargs,stats,os);
+		c->instance = instance;
+		{
+			lock_guard<mutex> lock(cachelock);
+			c->original = original;
+		}
+
+		//A mode of the schedule removed by the reductions is replaced by the first remaining one
+		if(c->feasible && !warmstarts.empty()){
+			vector<int> modes(warmmodes.size(),0);
+			for(int i = 0; i < modes.size(); i++)
+				for(int m = 0; m < instance->getNModes(i); m++)
+					if(instance->getModeId(i,m) == warmmodes[i])
+						modes[i] = m;
+			int makespan = instance->repairSchedule(warmstarts,modes);
+			if(stats)
+				os << "c daemon repaired schedule makespan " << (makespan == INT_MAX ? -1 : makespan) << std::endl;
+			if(makespan != INT_MAX){
+				c->makespan = makespan;
+				c->starts = warmstarts;
+				c->modes = modes;
+			}
+		}
+	}
+	else if(stats)
+		os << "c daemon reuses the preprocessed instance" << std::endl;
+
+	if(!c->feasible)
+		BasicController::onProvedUNSAT(os);
+	else if(c->optimal && !output && sargs->getAMOPBEncoding()!=AMOPB_DRYRUN){
+		printSchedule(c->instance,c->starts,c->modes,sargs,os);
+		BasicController::onProvedOptimum(c->makespan,os);
+	}
+	else{
+		//The time windows of a given upper bound, that may be below the optimum, are only valid for this request
+		bool givenUB = sargs->getIntOption(UPPER_BOUND)!=INT_MIN;
+		MRCPSP * instance = c->instance;
+		if(givenUB)
+			instance = c->instance->clone();
+
+		int UB = givenUB ? sargs->getIntOption(UPPER_BOUND) : instance->trivialUB();
+		vector<int> starts, modes;
+		if(c->makespan < UB && !output){
+			UB = c->makespan;
+			starts = c->starts;
+			modes = c->modes;
+			if(!starts.empty())
+				printSchedule(instance,starts,modes,sargs,os);
+		}
+
+		bool optimal;
+		int makespan = solve(instance,pargs,sargs,UB,starts,modes,optimal,os,setRunning);
+
+		if(!starts.empty() && instance->computeMakespan(starts,modes) < c->makespan){
+			c->makespan = instance->computeMakespan(starts,modes);
+			c->starts = starts;
+			c->modes = modes;
+		}
+		//Only an optimizer proves the optimum (a single check does not), and only a known
+		//schedule of that makespan is reused as the answer of the next requests
+		if(optimal && !givenUB && sargs->getStringOption(OPTIMIZER) != "check"
+				&& !c->starts.empty() && c->makespan == makespan)
+			c->optimal = true;
+		if(givenUB)
+			delete instance;
+	}
+
+	delete sargs;
+	delete pargs;
+}
+
+
+int main(int argc, char **argv) {
+
+	Arguments<ProgramArg> * pargs = newProgramArguments();
+
+	SolvingArguments * sargs = SolvingArguments::readArguments(argc,argv,pargs);
+
+	if(pargs->getBoolOption(DAEMON)){
+		cacheLimit = max(1,pargs->getIntOption(DAEMON_CACHE));
+		SolverDaemon daemon(pargs->getArgument(0),pargs->getIntOption(DAEMON_WORKERS),serveRequest);
+		bool ok = daemon.run();
+		for(const pair<const string,CachedInstance *> & p : cachedInstances)
+			deleteCachedInstance(p.second);
+		delete pargs;
+		delete sargs;
+		return ok ? 0 : BADARGUMENTS_ERROR;
+	}
+
+	MRCPSP * instance = parser::parseMRCPSP(pargs->getArgument(0));
+
+	bool output = sargs->getBoolOption(OUTPUT_ENCODING);
+	bool stats = sargs->getBoolOption(PRINT_CHECKS_STATISTICS) && !output;
+
+	if(!preprocess(instance,pargs,stats,std::cout)){
+		BasicController::onProvedUNSAT();
+		delete instance;
+		delete pargs;
+		delete sargs;
+		return 0;
+	}
+
+	int UB = sargs->getIntOption(UPPER_BOUND);
+	if(UB==INT_MIN)
+		UB = instance->trivialUB();
+
+	vector<int> starts, modes;
+	bool optimal;
+	solve(instance,pargs,sargs,UB,starts,modes,optimal,std::cout,[](Encoder * e){
+		runningEncoder = e;
+		signal(SIGINT,e != NULL ? cancelSearch : SIG_DFL);
+		signal(SIGTERM,e != NULL ? cancelSearch : SIG_DFL);
+	});
+
 	delete instance;
 	delete pargs;
 	delete sargs;
-	delete encoding;
 
 	return 0;
 }
-
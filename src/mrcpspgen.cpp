@@ -0,0 +1,91 @@
+#include <iostream>
+#include "errors.h"
+#include "arguments.h"
+#include "solvingarguments.h"
+#include "mrcpspgenerator.h"
+
+using namespace std;
+using namespace arguments;
+
+
+/*
+ * Enumeration of all the accepted program arguments
+ */
+enum ProgramArg {
+	ACTIVITIES,
+	RENEWABLE,
+	NONRENEWABLE,
+	MODES,
+	COMPLEXITY,
+	RESOURCE_FACTOR,
+	RESOURCE_STRENGTH,
+	NR_STRENGTH,
+	MAX_DURATION,
+	MAX_DEMAND,
+	SEED,
+	FORMAT
+};
+
+
+/*
+ * Generator of random MRCPSP instances (see MRCPSPGenerator), written
+ * in stdout in the PSPLIB multi-mode format or in the RCP format.
+ */
+int main(int argc, char **argv) {
+	Arguments<ProgramArg> * pargs
+	= new Arguments<ProgramArg>(
+
+	//Program arguments
+	{
+	},
+	0,
+
+	//Program options
+	{
+	arguments::iop("n","activities",ACTIVITIES,30,
+	"Number of non-dummy activities. Default 30."),
+	arguments::iop("R","renewable",RENEWABLE,2,
+	"Number of renewable resources. Default 2."),
+	arguments::iop("N","nonrenewable",NONRENEWABLE,2,
+	"Number of non-renewable resources. Default 2."),
+	arguments::iop("M","modes",MODES,3,
+	"Number of modes of each activity. Default 3."),
+	arguments::iop("c","complexity",COMPLEXITY,150,
+	"Network complexity, as hundredths of arc per activity (including the arcs of the dummy activities). Default 150."),
+	arguments::iop("","rf",RESOURCE_FACTOR,50,
+	"Resource factor: percentage of the resources used by each activity. Default 50."),
+	arguments::iop("","rs",RESOURCE_STRENGTH,25,
+	"Resource strength of the renewable resources, in percentage from the largest minimum demand to the peak of the earliest start schedule. Default 25."),
+	arguments::iop("","nrs",NR_STRENGTH,50,
+	"Resource strength of the non-renewable resources, in percentage from the sum of the minimum demands to the sum of the maximum demands. Default 50."),
+	arguments::iop("d","max-duration",MAX_DURATION,10,
+	"Durations are drawn uniformly from [1,max-duration]. Default 10."),
+	arguments::iop("q","max-demand",MAX_DEMAND,10,
+	"Demands are drawn uniformly from [1,max-demand]. Default 10."),
+	arguments::iop("","seed",SEED,1,
+	"Seed of the generator. Default 1."),
+	arguments::sop("","format",FORMAT,"mm",
+	{"mm","rcp"},
+	"Output format. The RCP format requires single mode instances without non-renewable resources. Default mm.")
+	},
+	"Generate a random MRCPSP instance with ProGen-like controls."
+	);
+
+	SolvingArguments * sargs = SolvingArguments::readArguments(argc,argv,pargs);
+
+	MRCPSPGenerator gen(pargs->getIntOption(ACTIVITIES),pargs->getIntOption(RENEWABLE),
+		pargs->getIntOption(NONRENEWABLE),pargs->getIntOption(MODES),
+		pargs->getIntOption(COMPLEXITY),pargs->getIntOption(RESOURCE_FACTOR),
+		pargs->getIntOption(RESOURCE_STRENGTH),pargs->getIntOption(NR_STRENGTH),
+		pargs->getIntOption(MAX_DURATION),pargs->getIntOption(MAX_DEMAND),
+		pargs->getIntOption(SEED));
+
+	if(pargs->getStringOption(FORMAT)=="rcp")
+		gen.printRCP(cout);
+	else
+		gen.printMM(cout);
+
+	delete pargs;
+	delete sargs;
+	return 0;
+}
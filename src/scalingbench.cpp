@@ -0,0 +1,202 @@
+#include <vector>
+#include <iostream>
+#include <chrono>
+#include <climits>
+#include <sys/resource.h>
+#include "errors.h"
+#include "arguments.h"
+#include "solvingarguments.h"
+#include "smtformula.h"
+#include "mrcpsp.h"
+#include "mrcpspgenerator.h"
+#include "mrcpspencoding.h"
+#include "smttimeencoding.h"
+#include "smttaskencoding.h"
+#include "smteventencoding.h"
+#include "doubleorder.h"
+
+using namespace std;
+using namespace arguments;
+using namespace smtapi;
+
+
+/*
+ * Enumeration of all the accepted program arguments
+ */
+enum ProgramArg {
+	MIN_ACTIVITIES,
+	MAX_ACTIVITIES,
+	RENEWABLE,
+	NONRENEWABLE,
+	MODES,
+	COMPLEXITY,
+	RESOURCE_FACTOR,
+	RESOURCE_STRENGTH,
+	NR_STRENGTH,
+	SEED,
+	BUDGET,
+	MEMORY_BUDGET,
+	ENCODE,
+	SOLVE,
+	ENCODING
+};
+
+static double secondsSince(const chrono::steady_clock::time_point & start){
+	return chrono::duration<double>(chrono::steady_clock::now()-start).count();
+}
+
+//Peak resident memory of the process so far, in MB
+static long peakMemory(){
+	struct rusage usage;
+	getrusage(RUSAGE_SELF,&usage);
+	return usage.ru_maxrss/1024;
+}
+
+
+/*
+ * Scaling benchmark on generated instances (see MRCPSPGenerator). The
+ * number of activities is doubled from the minimum to the maximum, and for
+ * each size it reports the time of the generation, of building the
+ * MRCPSP instance, of the preprocessing of mrcpsp2smt (mode reduction,
+ * non-renewable filter, extended precedences and time windows), of the
+ * encoding at the trivial upper bound with its size, and optionally of the
+ * optimization with the given solving options, together with the peak
+ * memory of the process. The sweep stops after the first size that
+ * exceeds the time or the memory budget.
+ */
+int main(int argc, char **argv) {
+	Arguments<ProgramArg> * pargs
+	= new Arguments<ProgramArg>(
+
+	//Program arguments
+	{
+	},
+	0,
+
+	//Program options
+	{
+	arguments::iop("n","min-activities",MIN_ACTIVITIES,30,
+	"Number of non-dummy activities of the first instance. Default 30."),
+	arguments::iop("x","max-activities",MAX_ACTIVITIES,10000,
+	"Largest number of non-dummy activities. Default 10000."),
+	arguments::iop("R","renewable",RENEWABLE,2,
+	"Number of renewable resources. Default 2."),
+	arguments::iop("N","nonrenewable",NONRENEWABLE,2,
+	"Number of non-renewable resources. Default 2."),
+	arguments::iop("M","modes",MODES,3,
+	"Number of modes of each activity. Default 3."),
+	arguments::iop("c","complexity",COMPLEXITY,150,
+	"Network complexity, as hundredths of arc per activity. Default 150."),
+	arguments::iop("","rf",RESOURCE_FACTOR,50,
+	"Resource factor, in percentage. Default 50."),
+	arguments::iop("","rs",RESOURCE_STRENGTH,25,
+	"Resource strength of the renewable resources, in percentage. Default 25."),
+	arguments::iop("","nrs",NR_STRENGTH,50,
+	"Resource strength of the non-renewable resources, in percentage. Default 50."),
+	arguments::iop("","seed",SEED,1,
+	"Seed of the generator. Default 1."),
+	arguments::iop("b","budget",BUDGET,600,
+	"Seconds after which no larger instance is tried. Default 600."),
+	arguments::iop("","memory-budget",MEMORY_BUDGET,1024,
+	"Peak memory in MB after which no larger instance is tried. The next size usually needs several times more. Default 1024."),
+	arguments::bop("","encode",ENCODE,true,
+	"If 0, the instances are only preprocessed, to scale the preprocessing alone to larger sizes. Default 1."),
+	arguments::bop("","solve",SOLVE,false,
+	"If 1, also optimize each instance with the solving options (e.g. -s=glucose -t=60 in a GLUCOSE=1 build). Default 0."),
+	arguments::sop("E","encoding",ENCODING,"doubleorder",
+	{"smttime","smttask","smtevent","doubleorder"},
+	"Encoding of the problem. Default: doubleorder.")
+	},
+	"Measure how preprocessing, encoding and solving scale with the number of activities of generated MRCPSP instances."
+	);
+
+	SolvingArguments * sargs = SolvingArguments::readArguments(argc,argv,pargs);
+
+	int minn = pargs->getIntOption(MIN_ACTIVITIES);
+	int maxn = pargs->getIntOption(MAX_ACTIVITIES);
+	if(minn < 1 || maxn < minn){
+		cerr << "Error: the number of activities must be positive, and the minimum at most the maximum" << endl;
+		exit(BADARGUMENTS_ERROR);
+	}
+
+	string s_encoding = pargs->getStringOption(ENCODING);
+	cout << "n\tarcs\tgenerate\tbuild\tpreprocess\tencode\tvars\tclauses\tsolve\tresult\tmemoryMB" << endl;
+
+	for(int n = minn; ; n = min(2*n,maxn)){
+		chrono::steady_clock::time_point start = chrono::steady_clock::now();
+
+		chrono::steady_clock::time_point t = chrono::steady_clock::now();
+		MRCPSPGenerator gen(n,pargs->getIntOption(RENEWABLE),pargs->getIntOption(NONRENEWABLE),
+			pargs->getIntOption(MODES),pargs->getIntOption(COMPLEXITY),
+			pargs->getIntOption(RESOURCE_FACTOR),pargs->getIntOption(RESOURCE_STRENGTH),
+			pargs->getIntOption(NR_STRENGTH),10,10,pargs->getIntOption(SEED));
+		double tgenerate = secondsSince(t);
+
+		t = chrono::steady_clock::now();
+		MRCPSP * instance = gen.build();
+		double tbuild = secondsSince(t);
+
+		t = chrono::steady_clock::now();
+		int UB = instance->trivialUB();
+		bool feasible = instance->reduceModes() && instance->filterNRModes();
+		bool optimal = false;
+		if(feasible){
+			instance->computeExtPrecs();
+			instance->computeSteps();
+			optimal = !instance->computeTimeWindows(UB-1);
+		}
+		double tpreprocess = secondsSince(t);
+
+		cout << n << "\t" << gen.getNArcs() << "\t" << tgenerate << "\t" << tbuild << "\t" << tpreprocess;
+
+		if(!feasible)
+			cout << "\t-\t-\t-\t-\tinfeasible";
+		else if(!pargs->getBoolOption(ENCODE))
+			cout << "\t-\t-\t-\t-\t" << (optimal ? "opt " + to_string(UB) : "-");
+		else{
+			MRCPSPEncoding * encoding = NULL;
+			if(s_encoding=="smttime")
+				encoding = new SMTTimeEncoding(instance,sargs,false);
+			else if(s_encoding=="smttask")
+				encoding = new SMTTaskEncoding(instance,sargs,false);
+			else if(s_encoding=="smtevent")
+				encoding = new SMTEventEncoding(instance,sargs,false);
+			else
+				encoding = new DoubleOrder(instance, sargs->getAMOPBEncoding(), false);
+
+			t = chrono::steady_clock::now();
+			SMTFormula * f = encoding->encode(0,UB);
+			double tencode = secondsSince(t);
+			cout << "\t" << tencode << "\t" << f->getNBoolVars() << "\t" << f->getNClauses();
+			delete f;
+
+			if(optimal)
+				cout << "\t-\topt " << UB;
+			else if(pargs->getBoolOption(SOLVE)){
+				Optimizer * opti = sargs->getOptimizer();
+				Encoder * e = sargs->getEncoder(encoding);
+				t = chrono::steady_clock::now();
+				int opt = opti->minimize(e,0,UB-1,sargs->getBoolOption(USE_ASSUMPTIONS),sargs->getBoolOption(NARROW_BOUNDS));
+				double tsolve = secondsSince(t);
+				if(opt==INT_MIN)
+					opt = UB;
+				cout << "\t" << tsolve << "\t" << (opti->isInterrupted() ? "ub " : "opt ") << opt;
+				delete opti;
+				delete e;
+			}
+			else
+				cout << "\t-\t-";
+			delete encoding;
+		}
+		delete instance;
+
+		cout << "\t" << peakMemory() << endl;
+
+		if(n == maxn || secondsSince(start) > pargs->getIntOption(BUDGET) || peakMemory() > pargs->getIntOption(MEMORY_BUDGET))
+			break;
+	}
+
+	delete pargs;
+	delete sargs;
+	return 0;
+}
@@ -0,0 +1,326 @@
+#include "amopbcost.h"
+#include "valueset.h"
+#include "comparatornetwork.h"
+#include "util.h"
+#include "errors.h"
+#include <iostream>
+#include <algorithm>
+#include <math.h>
+
+using namespace smtapi;
+
+
+const std::vector<AMOPBEncoding> & AMOPBCost::getPredictedEncodings(){
+	static const std::vector<AMOPBEncoding> encodings = {
+		AMOPB_AMOMDD,
+		AMOPB_GSWC,
+		AMOPB_GGT,
+		AMOPB_GMTO,
+		AMOPB_GGPW,
+		AMOPB_SORTER
+	};
+	return encodings;
+}
+
+const std::vector<AMOPBEncoding> & AMOPBCost::getAutoEncodings(){
+	static const std::vector<AMOPBEncoding> encodings = {
+		AMOPB_AMOMDD,
+		AMOPB_GSWC,
+		AMOPB_GGT,
+		AMOPB_GGPW,
+		AMOPB_SORTER
+	};
+	return encodings;
+}
+
+AMOPBSize AMOPBCost::predict(const std::vector<std::vector<int> > & Q, int K, AMOPBEncoding encoding){
+	switch(encoding){
+		case AMOPB_AMOMDD:
+			return predictMDD(Q,K);
+		case AMOPB_GSWC:
+			return predictSWC(Q,K);
+		case AMOPB_GGT:
+			return predictGT(Q,K);
+		case AMOPB_GMTO:
+			return predictMTO(Q,K);
+		case AMOPB_GGPW:
+			return predictPW(Q,K);
+		case AMOPB_SORTER:
+			return predictSorter(Q,K);
+		default:
+			std::cerr << "No size prediction for this kind of AMOPB encoding" << std::endl;
+			exit(SOLVING_ERROR);
+	}
+}
+
+AMOPBEncoding AMOPBCost::select(const std::vector<std::vector<int> > & Q, int K, AMOPBSize & size){
+	AMOPBEncoding best = AMOPB_AMOMDD;
+	bool first = true;
+	for(AMOPBEncoding enc : getAutoEncodings()){
+		AMOPBSize s = predict(Q,K,enc);
+		if(first || s.cost() < size.cost()){
+			best = enc;
+			size = s;
+			first = false;
+		}
+	}
+	return best;
+}
+
+AMOPBSize AMOPBCost::predictMDD(const std::vector<std::vector<int> > & Q, int K){
+	//Same order of the groups as AMOPB_AMOMDD, a stable sort by decreasing first coefficient
+	std::vector<int> order(Q.size());
+	for(int i = 0; i < Q.size(); i++)
+		order[i] = i;
+	std::stable_sort(order.begin(),order.end(),[&](int a, int b){return Q[a][0] > Q[b][0];});
+
+	int n = Q.size();
+
+	//Nodes of layer i are at most the distinct prefix sums <= K of the groups
+	//before i, and at most the intervals between the distinct suffix sums < K+1
+	//of the groups from i, as the remaining ones are the true node
+	std::vector<int> nsuffix(n);
+	ValueSet suffix(K+1), group(K+1), aux(K+1);
+	suffix.insert(0);
+	int maxsuffix = 0;
+	for(int i = n-1; i >= 0; i--){
+		group.clear();
+		group.insert(0);
+		int max = 0;
+		for(int q : Q[order[i]]){
+			group.insert(q);
+			max = std::max(max,q);
+		}
+		aux.sum(suffix,group);
+		suffix = aux;
+		maxsuffix += max;
+		int s = suffix.rank(std::min(maxsuffix,K+1));
+		nsuffix[i] = s;
+	}
+
+	AMOPBSize size;
+	ValueSet prefix(K+1);
+	prefix.insert(0);
+	for(int i = 0; i < n; i++){
+		int nprefix = prefix.rank(K+1);
+		long long nodes = std::min(nprefix,nsuffix[i]);
+		size.vars += nodes;
+		size.clauses += nodes * (1 + Q[order[i]].size());
+
+		group.clear();
+		group.insert(0);
+		for(int q : Q[order[i]])
+			group.insert(q);
+		aux.sum(prefix,group);
+		prefix = aux;
+	}
+	size.clauses++;
+	return size;
+}
+
+AMOPBSize AMOPBCost::predictSWC(const std::vector<std::vector<int> > & Q, int K){
+	int N = Q.size();
+	AMOPBSize size;
+	size.vars = (long long)(N-1)*K;
+	size.clauses = (long long)std::max(N-2,0)*K;
+	for(int i = 0; i < N; i++){
+		for(int q : Q[i]){
+			if(i < N-1)
+				size.clauses += q;
+			if(i > 0 && i < N-1)
+				size.clauses += K-q;
+			if(i > 0)
+				size.clauses++;
+		}
+	}
+	return size;
+}
+
+AMOPBSize AMOPBCost::predictGT(const std::vector<std::vector<int> > & Q, int K){
+	int n = Q.size();
+
+	//Same tree as AMOPB_GGT, a heap with the groups as leaves
+	std::vector<ValueSet> tree(2*n-1,ValueSet(K+1));
+	for(int i = 0; i < n; i++){
+		int idx = n-1+i;
+		tree[idx].insert(0);
+		for(int q : Q[i])
+			tree[idx].insert(q);
+	}
+
+	AMOPBSize size;
+	for(int i = n-2; i > 0; i--){
+		const ValueSet & l = tree[2*i+1];
+		const ValueSet & r = tree[2*i+2];
+		tree[i].sum(l,r);
+		size.vars += tree[i].size()-1;
+		size.clauses += (long long)l.size()*r.size()-1;
+	}
+
+	//The root only has the variable of K+1, defined by the pairs adding up to more than K
+	const ValueSet & l = tree[1];
+	const ValueSet & r = tree[2];
+	size.vars++;
+	for(int v = l.next(0); v != -1; v = l.next(v+1))
+		size.clauses += r.size() - r.rank(std::max(K+1-v,0));
+	size.clauses++;
+	return size;
+}
+
+AMOPBSize AMOPBCost::predictMTO(const std::vector<std::vector<int> > & Q, int K){
+	std::vector<int> moduli;
+	SMTFormula::baseSelectionMTO(Q,K,moduli);
+	int ndigits = moduli.size()+1;
+
+	//Number of non-zero values and largest value of each digit at each node.
+	//At inner nodes, the values of a digit come from the pairs of values of
+	//the children, plus one with the carry of the previous digit, and are
+	//bounded by the modulus of the digit
+	int n = Q.size();
+	std::vector<std::vector<long long> > nvals(2*n-1,std::vector<long long>(ndigits,0));
+	std::vector<std::vector<long long> > maxval(2*n-1,std::vector<long long>(ndigits,0));
+	AMOPBSize size;
+	for(int i = 0; i < n; i++){
+		int mp = 1;
+		for(int h = 0; h < ndigits; h++){
+			std::vector<int> digits;
+			for(int q : Q[i]){
+				int d = q / mp;
+				if(h < moduli.size())
+					d %= moduli[h];
+				if(d != 0)
+					digits.push_back(d);
+			}
+			std::sort(digits.begin(),digits.end());
+			int distinct = std::unique(digits.begin(),digits.end()) - digits.begin();
+			nvals[n-1+i][h] = distinct;
+			maxval[n-1+i][h] = distinct > 0 ? digits[distinct-1] : 0;
+			//Half-reified variables of repeated digits
+			size.vars += digits.size() - distinct;
+			size.clauses += digits.size() - distinct;
+			if(h < moduli.size())
+				mp *= moduli[h];
+		}
+	}
+	for(int i = n-2; i >= 0; i--){
+		for(int h = 0; h < ndigits; h++){
+			int l = 2*i+1, r = 2*i+2;
+			long long pairs = (nvals[l][h]+1)*(nvals[r][h]+1);
+			long long carries = h > 0 ? 2 : 1;
+			long long maxsum = maxval[l][h]+maxval[r][h]+carries-1;
+			if(h < moduli.size()){
+				maxval[i][h] = std::min(maxsum,(long long)moduli[h]-1);
+				size.vars++; //Carry
+			}
+			else
+				maxval[i][h] = maxsum;
+			nvals[i][h] = std::min(maxval[i][h],pairs*carries-1);
+			size.vars += nvals[i][h];
+			size.clauses += pairs*carries-1;
+		}
+	}
+
+	//Comparison of the root with the digits of K
+	for(int h = 0; h < ndigits; h++)
+		size.clauses += nvals[0][h];
+	return size;
+}
+
+AMOPBSize AMOPBCost::predictPW(const std::vector<std::vector<int> > & Q, int K){
+	int n = Q.size();
+	AMOPBSize size;
+
+	//This encoding is for < K instead of <= K
+	K+=1;
+
+	int max = 0;
+	for(const std::vector<int> & q : Q)
+		for(int qi : q)
+			max = std::max(max,qi);
+
+	int p = (int)floor(log2(max));
+	int p2 = (int) exp2(p);
+	int m = K / p2;
+	if(K%p2 != 0)
+		m++;
+	int T = (m*p2) - K;
+
+	//Buckets, with one auxiliary variable for each group with the bit in several coefficients
+	std::vector<int> B(p+1,0);
+	for(int k = 0; k <= p; k++){
+		for(int i = 0; i < n; i++){
+			int count = 0;
+			for(int q : Q[i])
+				if(util::nthBit(q,k))
+					count++;
+			if(count > 0)
+				B[k]++;
+			if(count > 1){
+				size.vars++;
+				size.clauses += count;
+			}
+		}
+	}
+
+	//Totalizers of the buckets and quadratic merges with the halved previous sums
+	int S = 0, Shalf = 0;
+	for(int i = 0; i <= p; i++){
+		int b = B[i];
+		if(b > 1){
+			std::vector<long long> tree(2*b-1,1);
+			for(int j = b-2; j >= 0; j--){
+				long long ls = tree[2*j+1];
+				long long rs = tree[2*j+2];
+				tree[j] = ls+rs;
+				size.vars += ls+rs;
+				size.clauses += ls*rs + ls + rs;
+			}
+		}
+		if(i==0)
+			S = b;
+		else{
+			if(b > 0 && Shalf > 0){
+				size.vars += b + Shalf;
+				size.clauses += (long long)b*Shalf + b + Shalf;
+			}
+			S = b + Shalf;
+		}
+		if(util::nthBit(T,i))
+			S++;
+		Shalf = S/2;
+	}
+	size.clauses++;
+	size.truevar = T > 0;
+	return size;
+}
+
+AMOPBSize AMOPBCost::predictSorter(const std::vector<std::vector<int> > & Q, int K){
+	AMOPBSize size;
+	std::vector<int> orders;
+	for(const std::vector<int> & q : Q){
+		int maxq = *(std::max_element(q.begin(),q.end()));
+		size.vars += maxq;
+		size.clauses += maxq - 1 + q.size();
+		orders.push_back(maxq);
+	}
+
+	//Same merges as AMOPB_SORTER, two smallest orders first, counted on the cached networks
+	while(orders.size()>1){
+		std::sort(orders.begin(),orders.end());
+		const ComparatorNetwork & net = ComparatorNetwork::simplifiedMerge(orders[0],orders[1],K+1);
+		for(const Comparator & c : net.getComparators()){
+			if(c.out2 >= 0){
+				size.vars += 2;
+				size.clauses += 3;
+			}
+			else{
+				size.vars++;
+				size.clauses += 2;
+			}
+		}
+		orders.push_back(net.getOutputs().size());
+		orders.erase(orders.begin(),orders.begin()+2);
+	}
+	size.clauses++;
+	return size;
+}
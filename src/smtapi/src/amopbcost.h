@@ -0,0 +1,55 @@
+#ifndef AMOPBCOST_DEFINITION
+#define AMOPBCOST_DEFINITION
+
+#include <vector>
+#include "smtformula.h"
+
+
+namespace smtapi{
+
+/*
+ * Cost model of the AMO-PB encodings. Predicts the number of variables and
+ * clauses of encoding sum(Q*X) <= K without generating them, from the
+ * coefficients and K only. The constraint must be preprocessed as in
+ * SMTFormula::addAMOPB: at least two groups, distinct positive
+ * coefficients in each group, all of them at most K, and a sum of the
+ * group maxima greater than K.
+ * The predictions of SWC, the global polynomial watchdog, the sorter and
+ * the generalized totalizer are exact, and the one of the MDD is an upper
+ * bound. The watchdog may also use the true variable of the formula, which
+ * is flagged instead of counted (see AMOPBSize). They take time linear in
+ * the number of terms, times K/64 for the value sets of the MDD and the
+ * totalizer. The prediction of MTO is only an estimate of the digit sizes.
+ */
+class AMOPBCost{
+
+private:
+
+	static AMOPBSize predictMDD(const std::vector<std::vector<int> > & Q, int K);
+	static AMOPBSize predictSWC(const std::vector<std::vector<int> > & Q, int K);
+	static AMOPBSize predictGT(const std::vector<std::vector<int> > & Q, int K);
+	static AMOPBSize predictMTO(const std::vector<std::vector<int> > & Q, int K);
+	static AMOPBSize predictPW(const std::vector<std::vector<int> > & Q, int K);
+	static AMOPBSize predictSorter(const std::vector<std::vector<int> > & Q, int K);
+
+public:
+
+	//Encodings with a prediction
+	static const std::vector<AMOPBEncoding> & getPredictedEncodings();
+
+	//Encodings considered by AMOPB_AUTO. MTO is left out because, unlike the
+	//other ones, its unit propagation does not enforce arc consistency
+	static const std::vector<AMOPBEncoding> & getAutoEncodings();
+
+	//Predicted size of encoding sum(Q*X) <= K with 'encoding'
+	static AMOPBSize predict(const std::vector<std::vector<int> > & Q, int K, AMOPBEncoding encoding);
+
+	//Encoding of AMOPB_AUTO for sum(Q*X) <= K: the one with the smallest
+	//predicted number of variables plus clauses. Its size is stored in 'size'
+	static AMOPBEncoding select(const std::vector<std::vector<int> > & Q, int K, AMOPBSize & size);
+
+};
+
+}
+
+#endif
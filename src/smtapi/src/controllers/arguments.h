@@ -9,6 +9,7 @@
 #include <set>
 #include <iostream>
 #include "errors.h"
+#include "util.h"
 
 
 namespace arguments{
@@ -165,6 +166,7 @@ public:
 	void setOption(OptionT option, int value);
 	void setOption(OptionT option, bool value);
 	void setOption(OptionT option, const std::string & value);
+	bool setOption(const std::string & name, const std::string & value, std::string & error); //Option 'name' parsed from 'value'. False and 'error' set if not valid
 	int getIntOption(OptionT option) const;
 	bool getBoolOption(OptionT option) const;
 	std::string getStringOption(OptionT option) const;
@@ -293,6 +295,43 @@ void Arguments<OptionT>::setOption(OptionT option, const std::string & value){
 	stringOptions[option]=value;
 }
 
+template<class OptionT>
+bool Arguments<OptionT>::setOption(const std::string & name, const std::string & value, std::string & error){
+	OptionT option = getOptionRef(name);
+	switch(getOptionType(option)){
+		case INT_TYPE:
+			if(!util::isInteger(value)){
+				error = name + " must be an integer value, received: " + value;
+				return false;
+			}
+			setOption(option,stoi(value));
+			break;
+
+		case BOOL_TYPE:
+			if(!util::boolstring(value)){
+				error = name + " must be either 0 or 1, received: " + value;
+				return false;
+			}
+			setOption(option,value == "1");
+			break;
+
+		case STRING_TYPE:{
+			const std::vector<std::string> & values = option_svalues.find(option)->second;
+			if(!values.empty() && find(values.begin(),values.end(),value) == values.end()){
+				error = "Unsupported option value '" + value + "'";
+				return false;
+			}
+			setOption(option,value);
+			break;
+		}
+
+		default:
+			error = "Undefined type for option " + name;
+			return false;
+	}
+	return true;
+}
+
 template<class OptionT>
 int Arguments<OptionT>::getIntOption(OptionT option) const{
 	return intOptions.find(option)->second;
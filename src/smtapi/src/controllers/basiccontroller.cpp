@@ -2,6 +2,7 @@
 #include <limits.h>
 #include "dimacsfileencoder.h"
 #include "smtlib2fileencoder.h"
+#include "formulasimplifier.h"
 #include "basiceventhandler.h"
 #include "errors.h"
 
@@ -31,7 +32,12 @@ void BasicController::run() {
 	if(sargs->getBoolOption(OUTPUT_ENCODING)){
 		FileEncoder * e = sargs->getFileEncoder(encoding);
 		SMTFormula * f = encoding->encode(LB,UB);
-		e->createFile(std::cout,f);
+		if(sargs->getBoolOption(SIMPLIFY) && f->getType()==SATFORMULA){
+			FormulaSimplifier s(f);
+			e->createFile(std::cout,s.getFormula());
+		}
+		else
+			e->createFile(std::cout,f);
 		delete e;
 		delete f;
 	}
@@ -51,6 +57,7 @@ void BasicController::run() {
 		opti->setOnProvedOptimum([=](int opt){this->onProvedOptimum(opt);});
 		opti->setOnProvedSAT([=](){this->onProvedSAT();});
 		opti->setOnProvedUNSAT([=](){this->onProvedUNSAT();});
+		opti->setOnBudgetExhausted([=](int lb, int ub, int obj_val){this->onBudgetExhausted(lb,ub,obj_val);});
 
 		Encoder * e = sargs->getEncoder(encoding);
 		if(minimize)
@@ -64,56 +71,66 @@ void BasicController::run() {
 
 
 
-void BasicController::afterSatisfiabilityCall(int lb, int ub, Encoder * encoder){
-	std::cout << "c stats ";
+void BasicController::afterSatisfiabilityCall(int lb, int ub, Encoder * encoder, std::ostream & os){
+	os << "c stats ";
 
 	//Bounds and time
-	std::cout << lb << ";";
-	std::cout << ub << ";";
-	std::cout << encoder->getCheckTime() << ";";
-	std::cout << encoder->getSolverCheckTime() << ";";
+	os << lb << ";";
+	os << ub << ";";
+	os << encoder->getCheckTime() << ";";
+	os << encoder->getSolverCheckTime() << ";";
 
 	//Formula sizes
-	std::cout << encoder->getNBoolVars() << ";";
-	std::cout << encoder->getNClauses() << ";";
+	os << encoder->getNBoolVars() << ";";
+	os << encoder->getNClauses() << ";";
 
 	//Solving statistics
-	std::cout << encoder->getNRestarts() << ";";
-	std::cout << encoder->getNSimplify() << ";";
-	std::cout << encoder->getNReduce() << ";";
-	std::cout << encoder->getNDecisions() << ";";
-	std::cout << encoder->getNPropagations() << ";";
-	std::cout << encoder->getNConflicts() << ";";
-	std::cout << encoder->getNTheoryPropagations() << ";";
-	std::cout << encoder->getNTheoryConflicts() << ";";
-
-	std::cout << std::endl;
+	os << encoder->getNRestarts() << ";";
+	os << encoder->getNSimplify() << ";";
+	os << encoder->getNReduce() << ";";
+	os << encoder->getNDecisions() << ";";
+	os << encoder->getNPropagations() << ";";
+	os << encoder->getNConflicts() << ";";
+	os << encoder->getNTheoryPropagations() << ";";
+	os << encoder->getNTheoryConflicts() << ";";
+
+	os << std::endl;
+}
+
+void BasicController::afterNativeOptimizationCall(int lb, int ub, Encoder * encoder, std::ostream & os){
+	afterSatisfiabilityCall(lb,ub,encoder,os);
 }
 
-void BasicController::afterNativeOptimizationCall(int lb, int ub, Encoder * encoder){
-	afterSatisfiabilityCall(lb,ub,encoder);
+void BasicController::onNewBoundsProved(int lb, int ub, std::ostream & os){
+	os << "c lb/ub " << lb << " " << ub << std::endl;
 }
 
-void BasicController::onNewBoundsProved(int lb, int ub){
-	std::cout << "c lb/ub " << lb << " " << ub << std::endl;
+void BasicController::onSATSolutionFound(int & lb, int & ub, int & obj_val, Encoding * encoding, std::ostream & os){
+	os << "v ";
+	if(!encoding->printSolution(os))
+		os << " [Solution printing not implemented]";
+	os << std::endl;
 }
 
-void BasicController::onSATSolutionFound(int & lb, int & ub, int & obj_val, Encoding * encoding){
-	std::cout << "v ";
-	if(!encoding->printSolution(std::cout))
-		std::cout << " [Solution printing not implemented]";
-	std::cout << std::endl;
+void BasicController::onProvedOptimum(int opt, std::ostream & os){
+	os << "s OPTIMUM FOUND" << std::endl;
+	os << "o " << opt << std::endl;
 }
 
-void BasicController::onProvedOptimum(int opt){
-	std::cout << "s OPTIMUM FOUND" << std::endl;
-	std::cout << "o " << opt << std::endl;
+void BasicController::onProvedSAT(std::ostream & os){
+	os << "s SATISFIABLE" << std::endl;
 }
 
-void BasicController::onProvedSAT(){
-	std::cout << "s SATISFIABLE" << std::endl;
+void BasicController::onProvedUNSAT(std::ostream & os){
+	os << "s UNSATISFIABLE" << std::endl;
 }
 
-void BasicController::onProvedUNSAT(){
-	std::cout << "s UNSATISFIABLE" << std::endl;
+void BasicController::onBudgetExhausted(int lb, int ub, int obj_val, std::ostream & os){
+	os << "c time limit reached, bounds " << lb << " " << ub << std::endl;
+	if(obj_val == INT_MIN)
+		os << "s UNKNOWN" << std::endl;
+	else{
+		os << "s SATISFIABLE" << std::endl;
+		os << "o " << obj_val << std::endl;
+	}
 }
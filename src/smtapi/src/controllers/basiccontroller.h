@@ -28,13 +28,14 @@ public:
 	BasicController(SolvingArguments * sargs, Encoding * enc, bool minimize, int lb, int ub);
 	virtual ~BasicController();
 
-	static void afterSatisfiabilityCall(int lb, int ub, Encoder * encoder);
-	static void afterNativeOptimizationCall(int lb, int ub, Encoder * encoder);
-	static void onNewBoundsProved(int lb, int ub);
-	static void onSATSolutionFound(int & lb, int & ub, int & obj_val, Encoding * encoding);
-	static void onProvedOptimum(int opt);
-	static void onProvedSAT();
-	static void onProvedUNSAT();
+	static void afterSatisfiabilityCall(int lb, int ub, Encoder * encoder, std::ostream & os = std::cout);
+	static void afterNativeOptimizationCall(int lb, int ub, Encoder * encoder, std::ostream & os = std::cout);
+	static void onNewBoundsProved(int lb, int ub, std::ostream & os = std::cout);
+	static void onSATSolutionFound(int & lb, int & ub, int & obj_val, Encoding * encoding, std::ostream & os = std::cout);
+	static void onProvedOptimum(int opt, std::ostream & os = std::cout);
+	static void onProvedSAT(std::ostream & os = std::cout);
+	static void onProvedUNSAT(std::ostream & os = std::cout);
+	static void onBudgetExhausted(int lb, int ub, int obj_val, std::ostream & os = std::cout);
 
 	virtual void run();
 };
@@ -0,0 +1,303 @@
+#include "solverdaemon.h"
+#include <csignal>
+#include <cerrno>
+#include <cstring>
+#include <sstream>
+#include <streambuf>
+#include <unistd.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+
+
+//Set by SIGINT and SIGTERM, which interrupt the accept loop
+static volatile sig_atomic_t stopRequested = 0;
+
+static void requestStop(int){
+	stopRequested = 1;
+}
+
+//Seconds a client has to send its request, and to read each part of the output
+#define CLIENT_TIMEOUT 30
+
+//Largest request accepted, in bytes
+#define MAX_REQUEST_SIZE (64*1024*1024)
+
+
+/*
+ * Output buffer of a connection. The buffered output is sent on each flush
+ * (e.g. std::endl), so that the client receives every line as soon as it is
+ * written. 'onFailure' is called once if the client cannot receive it.
+ */
+class SocketBuffer : public std::streambuf {
+
+private:
+
+	int fd;
+	char buffer[4096];
+	bool failed;
+	std::function<void()> onFailure;
+
+	bool send(){
+		const char * p = pbase();
+		while(!failed && p < pptr()){
+			ssize_t n = ::send(fd,p,pptr()-p,MSG_NOSIGNAL);
+			if(n < 0 && errno == EINTR)
+				continue;
+			if(n <= 0){
+				failed = true;
+				onFailure();
+			}
+			else
+				p += n;
+		}
+		setp(buffer,buffer+sizeof(buffer));
+		return !failed;
+	}
+
+protected:
+
+	int overflow(int c){
+		if(!send())
+			return traits_type::eof();
+		if(c != traits_type::eof()){
+			*pptr() = c;
+			pbump(1);
+		}
+		return traits_type::not_eof(c);
+	}
+
+	int sync(){
+		return send() ? 0 : -1;
+	}
+
+public:
+
+	SocketBuffer(int fd, std::function<void()> onFailure){
+		this->fd = fd;
+		this->failed = false;
+		this->onFailure = onFailure;
+		setp(buffer,buffer+sizeof(buffer));
+	}
+
+	~SocketBuffer(){
+		send();
+	}
+};
+
+
+SolverDaemon::SolverDaemon(const std::string & path, int nworkers, Handler handler){
+	this->path = path;
+	this->nworkers = std::max(1,nworkers);
+	this->handler = handler;
+	this->stopping = false;
+}
+
+bool SolverDaemon::run(){
+	sockaddr_un addr;
+	memset(&addr,0,sizeof(addr));
+	addr.sun_family = AF_UNIX;
+	if(path.size() >= sizeof(addr.sun_path)){
+		std::cerr << "Error: socket path too long: " << path << std::endl;
+		return false;
+	}
+	strcpy(addr.sun_path,path.c_str());
+
+	int sock = socket(AF_UNIX,SOCK_STREAM,0);
+	if(sock < 0){
+		std::cerr << "Error: could not create socket: " << strerror(errno) << std::endl;
+		return false;
+	}
+
+	//A socket left by a daemon that is not running anymore is replaced
+	struct stat st;
+	if(stat(path.c_str(),&st)==0 && S_ISSOCK(st.st_mode)){
+		if(connect(sock,(sockaddr *)&addr,sizeof(addr))==0){
+			std::cerr << "Error: another daemon is listening on " << path << std::endl;
+			close(sock);
+			return false;
+		}
+		close(sock);
+		unlink(path.c_str());
+		sock = socket(AF_UNIX,SOCK_STREAM,0);
+	}
+
+	if(bind(sock,(sockaddr *)&addr,sizeof(addr)) < 0 || listen(sock,64) < 0){
+		std::cerr << "Error: could not listen on " << path << ": " << strerror(errno) << std::endl;
+		close(sock);
+		return false;
+	}
+
+	//The workers block the stop signals, so that they interrupt the accept loop
+	sigset_t stopsignals, oldmask;
+	sigemptyset(&stopsignals);
+	sigaddset(&stopsignals,SIGINT);
+	sigaddset(&stopsignals,SIGTERM);
+	pthread_sigmask(SIG_BLOCK,&stopsignals,&oldmask);
+	std::vector<std::thread> workers;
+	for(int i = 0; i < nworkers; i++)
+		workers.push_back(std::thread([this](){work();}));
+
+	struct sigaction sa, oldint, oldterm;
+	memset(&sa,0,sizeof(sa));
+	sa.sa_handler = requestStop;
+	sigemptyset(&sa.sa_mask);
+	sa.sa_flags = 0; //No SA_RESTART, accept returns on the signal
+	stopRequested = 0;
+	sigaction(SIGINT,&sa,&oldint);
+	sigaction(SIGTERM,&sa,&oldterm);
+	pthread_sigmask(SIG_SETMASK,&oldmask,NULL);
+
+	while(!stopRequested){
+		int fd = accept(sock,NULL,NULL);
+		if(fd < 0){
+			if(errno == EINTR || errno == ECONNABORTED)
+				continue;
+			std::cerr << "Error: accept failed: " << strerror(errno) << std::endl;
+			break;
+		}
+		std::lock_guard<std::mutex> lock(m);
+		pending.push_back(fd);
+		cv.notify_one();
+	}
+
+	sigaction(SIGINT,&oldint,NULL);
+	sigaction(SIGTERM,&oldterm,NULL);
+
+	{
+		std::lock_guard<std::mutex> lock(m);
+		stopping = true;
+		for(Connection * c : connections)
+			if(c->running != NULL)
+				c->running->cancel();
+		for(int fd : pending)
+			close(fd);
+		pending.clear();
+	}
+	cv.notify_all();
+	for(std::thread & th : workers)
+		th.join();
+
+	close(sock);
+	unlink(path.c_str());
+	return true;
+}
+
+void SolverDaemon::work(){
+	while(true){
+		int fd;
+		{
+			std::unique_lock<std::mutex> lock(m);
+			cv.wait(lock,[this](){return stopping || !pending.empty();});
+			if(stopping)
+				return;
+			fd = pending.front();
+			pending.pop_front();
+		}
+		serve(fd);
+	}
+}
+
+void SolverDaemon::serve(int fd){
+	timeval timeout;
+	timeout.tv_sec = CLIENT_TIMEOUT;
+	timeout.tv_usec = 0;
+	setsockopt(fd,SOL_SOCKET,SO_RCVTIMEO,&timeout,sizeof(timeout));
+	setsockopt(fd,SOL_SOCKET,SO_SNDTIMEO,&timeout,sizeof(timeout));
+
+	Connection c;
+	c.fd = fd;
+	c.running = NULL;
+	c.failed = false;
+	{
+		std::lock_guard<std::mutex> lock(m);
+		connections.insert(&c);
+	}
+
+	{
+		SocketBuffer buffer(fd,[&](){onWriteFailure(&c);});
+		std::ostream os(&buffer);
+		Request request;
+		if(!readRequest(fd,request))
+			os << "c error: could not read the request" << std::endl;
+		else if(request.args.empty())
+			os << "c error: empty request" << std::endl;
+		else{
+			//The client may leave while no output is written, a closed connection is polled meanwhile
+			std::atomic<bool> done(false);
+			std::thread watcher([&](){
+				pollfd p;
+				p.fd = fd;
+				p.events = 0;
+				while(!done){
+					if(poll(&p,1,250) > 0 && (p.revents & (POLLHUP|POLLERR))){
+						onWriteFailure(&c);
+						return;
+					}
+				}
+			});
+			handler(request,os,[&](Encoder * e){setRunning(&c,e);});
+			done = true;
+			watcher.join();
+		}
+		os.flush();
+	}
+
+	{
+		std::lock_guard<std::mutex> lock(m);
+		connections.erase(&c);
+	}
+	close(fd);
+}
+
+void SolverDaemon::setRunning(Connection * c, Encoder * e){
+	std::lock_guard<std::mutex> lock(m);
+	c->running = e;
+	if(e != NULL && (stopping || c->failed))
+		e->cancel();
+}
+
+void SolverDaemon::onWriteFailure(Connection * c){
+	std::lock_guard<std::mutex> lock(m);
+	c->failed = true;
+	if(c->running != NULL)
+		c->running->cancel();
+}
+
+bool SolverDaemon::readRequest(int fd, Request & request){
+	std::string input;
+	char buf[4096];
+	while(input.find("\n\n") == std::string::npos && input.size() < MAX_REQUEST_SIZE){
+		ssize_t n = recv(fd,buf,sizeof(buf),0);
+		if(n < 0 && errno == EINTR)
+			continue;
+		if(n < 0)
+			return false;
+		if(n == 0)
+			break;
+		input.append(buf,n);
+	}
+	if(input.size() >= MAX_REQUEST_SIZE)
+		return false;
+
+	std::istringstream is(input);
+	std::string line;
+	bool first = true;
+	while(getline(is,line)){
+		if(!line.empty() && line.back() == '\r')
+			line.pop_back();
+		if(first){
+			std::istringstream ls(line);
+			std::string tok;
+			while(ls >> tok)
+				request.args.push_back(tok);
+			first = false;
+		}
+		else if(line.empty())
+			break;
+		else
+			request.data.push_back(line);
+	}
+	return true;
+}
@@ -0,0 +1,74 @@
+#ifndef SOLVERDAEMON_DEFINITION
+#define SOLVERDAEMON_DEFINITION
+
+#include <vector>
+#include <string>
+#include <set>
+#include <deque>
+#include <thread>
+#include <atomic>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+#include <iostream>
+#include "encoder.h"
+
+
+/*
+ * Server of solving requests on a Unix domain socket. Each connection
+ * carries one request: a first line with options and arguments as in the
+ * command line, optionally followed by data lines, until an empty line or
+ * the end of the input. A pool of worker threads serves the requests with
+ * the given handler, which writes its output to the connection as it is
+ * produced (e.g. from the Optimizer callbacks). The connection is closed
+ * when the handler returns. SIGINT and SIGTERM stop the daemon, cancelling
+ * the running searches. A search is also cancelled when its client closes
+ * the connection.
+ */
+class SolverDaemon {
+
+public:
+
+	struct Request{
+		std::vector<std::string> args; //Options and arguments of the first line
+		std::vector<std::string> data; //Remaining lines
+	};
+
+	//Serves 'request' writing to 'os'. 'setRunning' registers the encoder being solved, to be
+	//cancelled if the daemon stops or the client leaves, and NULL unregisters it
+	typedef std::function<void(const Request & request, std::ostream & os, std::function<void(Encoder *)> setRunning)> Handler;
+
+private:
+
+	struct Connection{
+		int fd;
+		Encoder * running;
+		bool failed; //The client is not reading the output anymore
+	};
+
+	std::string path;
+	int nworkers;
+	Handler handler;
+
+	std::mutex m;
+	std::condition_variable cv;
+	std::deque<int> pending; //Accepted connections waiting for a worker
+	std::set<Connection *> connections; //Connections being served
+	bool stopping;
+
+	void work();
+	void serve(int fd);
+	void setRunning(Connection * c, Encoder * e);
+	void onWriteFailure(Connection * c);
+	static bool readRequest(int fd, Request & request);
+
+public:
+
+	SolverDaemon(const std::string & path, int nworkers, Handler handler);
+
+	//Serves requests until SIGINT or SIGTERM. Returns false, with a message on cerr, if the socket cannot be opened
+	bool run();
+
+};
+
+#endif
@@ -3,6 +3,7 @@
 #include "buoptimizer.h"
 #include "singlecheck.h"
 #include "dicooptimizer.h"
+#include "coreoptimizer.h"
 #include "nativeoptimizer.h"
 #include "dimacsfileencoder.h"
 #include "smtlib2fileencoder.h"
@@ -86,7 +87,10 @@ std::map<std::string,PBEncoding> SolvingArguments::pbencodings = {
 	{"ggpw",AMOPB_GGPW},
 	{"glpw",AMOPB_GLPW},
 	{"ggbm",AMOPB_GGBM},
-	{"glbm",AMOPB_GLBM}
+	{"glbm",AMOPB_GLBM},
+	{"lazy",AMOPB_LAZY},
+	{"auto",AMOPB_AUTO},
+	{"dryrun",AMOPB_DRYRUN}
 };
 
 SolvingArguments::SolvingArguments() : Arguments<SolvingArg>(
@@ -98,7 +102,7 @@ SolvingArguments::SolvingArguments() : Arguments<SolvingArg>(
 	//Program solving options
 	{arguments::sop("s","solver",SOLVER,"yices",
 	{"yices","lingeling","openwbo","glucose","optimathsat","minisat"},
-	"Solver to use. API only available with yices and glucose. For SMT encodings, only yices. For MaxSAT encodings, only openwbo. For SAT: glucose, minisat. Default: yices."),
+	"Solver to use. API only available with yices and glucose. For SMT encodings, only yices, or glucose through its difference logic propagator (see --idl). For MaxSAT encodings, only openwbo. For SAT: glucose, minisat. Default: yices."),
 
 	arguments::bop("e","output-encoding",OUTPUT_ENCODING,false,
 	"If 1, the instance will not be solved but the encoding will be output in stdout. If the encoding does not contain a native optimization functionality, the encoding will correspond to the decision version of the problem with the given/computed bounds. Default: 0."),
@@ -108,8 +112,8 @@ SolvingArguments::SolvingArguments() : Arguments<SolvingArg>(
 	"Format to be used to output the encodings (if -E=1). Options: dimacs, smtlib2. For SMT encodings, smlib2 is required. Default: smtlib2."),
 
 	arguments::sop("o","optimizer",OPTIMIZER,"ub",
-	{"check","ub","bu","dico","native"},
-	"Optimization procedure to use. Check (no optimization), ub (ub to bottom), bu (bottom to up), dico (dicotomic), native (objective function included in the formulation, to be solved with a native optimization approach, e.g. MaxSAT or Optimization Modulo Theories). Default: ub."),
+	{"check","ub","bu","dico","core","native"},
+	"Optimization procedure to use. Check (no optimization), ub (ub to bottom), bu (bottom to up), dico (dicotomic), core (bottom to up, jumping to the lower bounds proved by the failed assumptions), native (objective function included in the formulation, to be solved with a native optimization approach, e.g. MaxSAT or Optimization Modulo Theories). Default: ub."),
 
 	arguments::iop("r","random-seed",RANDOM_SEED,-1,
 	"Random seed of the SAT/SMT solver. Default: default seed of the used solver."),
@@ -120,24 +124,38 @@ SolvingArguments::SolvingArguments() : Arguments<SolvingArg>(
 	arguments::bop("a","api",USE_API,true,
 	"If 1, use the SAT/SMT solver API. If 0,call the solver as an independent procedure through instance files. Only available with yices and glucose. Default: 1."),
 
+	arguments::bop("","smt-session",SMT_SESSION,false,
+	"If 1 and solving through SMT-LIB2 files (-a=0), the solver is launched once as an interactive session: the formula is sent once, and each check only sends the new clauses and its bounds between push/pop. Default: 0."),
+
+	arguments::bop("","simplify",SIMPLIFY,false,
+	"If 1, SAT formulas are simplified before being written, both when solving through DIMACS files (-a=0) and when outputting the encoding (-e=1): unit propagation, and removal of satisfied, duplicated and subsumed clauses. The remaining variables are renumbered. Default: 0."),
+
 	arguments::bop("","use-assumptions",USE_ASSUMPTIONS,true,
 	"If 1, use checks with assumptions in optimization procedures when applicable. Default: 1."),
 
 	arguments::bop("","narrow-bounds",NARROW_BOUNDS,true,
 	"If 1, when using optimization with assumptions, the new proved bounds will be asserted. Default: 1."),
 
+	arguments::bop("","solution-phase",SOLUTION_PHASE,false,
+	"If 1, before each check the solver prefers the values of the best schedule found so far in its decisions. Only available with the glucose API. Default: 0."),
+
 	arguments::iop("l","lower-bound",LOWER_BOUND,INT_MIN,
 	"Lower bound to be used when solving the instance. Default: problem specific lower bound."),
 
 	arguments::iop("u","upper-bound",UPPER_BOUND,INT_MIN,
 	"Upper bound to be used when solving the instance. Default: problem specific upper bound."),
 
+	arguments::iop("t","time-limit",TIME_LIMIT,0,
+	"Wall-clock time limit of the search, in seconds. When it is reached, the best solution found and the proved bounds are reported. 0 for no limit. Default: 0."),
+
+	arguments::iop("","probe-time-limit",PROBE_TIME_LIMIT,0,
+	"Wall-clock time limit of each satisfiability check, in seconds. The dicotomic optimizer retries timed out checks closer to the best solution found, down to a linear search, and the other optimizers stop. 0 for no limit. Default: 0."),
+
 	arguments::bop("m","output-models",PRODUCE_MODELS,true,
 	"If 1, models will be retrieved after each satisfiability/optimality call, and the SMTLIB2 file will contain a query of the model (in case -E=1). Required for optimization. Default: 1."),
 
-	/*arguments::bop("","idl",USE_IDL_SOVER,false,
-	"Use specific IDL theory solver. Default: 0."),
-	*/
+	arguments::bop("","idl",USE_IDL_SOVER,false,
+	"If 1, SMT encodings are solved in-process by glucose with a difference logic propagator, regardless of -s and -a. Requires a binary compiled with GLUCOSE=1. Default: 0."),
 
 	arguments::bop("","print-optimal",PRINT_OPTIMAL_SOLUTION,true,
 	"If 1, the optimal solution will be printed. If --print-nonoptimal=1, then --print-optimal=1 regardless the given value. Default: 1."),
@@ -177,7 +195,7 @@ SolvingArguments::SolvingArguments() : Arguments<SolvingArg>(
 
 	arguments::sop("","amopb",AMOPB_ENCODING,"amomdd",
 	util::extract_keys(amopbencodings),
-	"Encoding for AMOPB constraints. Default: amomdd.")
+	"Encoding for AMOPB constraints. With 'lazy', they are not encoded but checked during the search, and conflict clauses are only generated when a capacity is exceeded (requires the glucose API). With 'auto', each constraint uses the encoding of smallest predicted size among amomdd, gswc, ggt, ggpw and sorter. With 'dryrun', the instance is not solved, and the predicted sizes of the AMOPB constraints with each encoding are printed. Default: amomdd.")
 	},
 	""
 	)
@@ -206,6 +224,7 @@ Optimizer * SolvingArguments::getOptimizer(){
 	if(so == "ub") o = new UBOptimizer();
 	else if(so == "bu") o = new BUOptimizer();
 	else if(so == "dico") o = new DicoOptimizer();
+	else if(so == "core") o = new CoreOptimizer();
 	else if(so == "check") o = new SingleCheck();
 	else if(so == "native") o = new NativeOptimizer();
 
@@ -214,8 +233,16 @@ Optimizer * SolvingArguments::getOptimizer(){
 
 Encoder * SolvingArguments::getEncoder(Encoding * enc){
 	Encoder * e = NULL;
-	if(getBoolOption(USE_API)){
-		std::string solver = getStringOption(SOLVER);
+	if(getAMOPBEncoding()==AMOPB_DRYRUN){
+		std::cerr << "Error: AMOPB constraints are not encoded in a dry run. " << std::endl;
+		exit(BADARGUMENTS_ERROR);
+	}
+	if(getBoolOption(USE_API) || getBoolOption(USE_IDL_SOVER)){
+		std::string solver = getBoolOption(USE_IDL_SOVER) ? "glucose" : getStringOption(SOLVER);
+		if(getAMOPBEncoding()==AMOPB_LAZY && solver!="glucose"){
+			std::cerr << "Error: lazy AMOPB constraints are only supported by the glucose API. " << std::endl;
+			exit(BADARGUMENTS_ERROR);
+		}
 		if(solver=="yices"){
 		#ifndef USEYICES
 			std::cerr << "Error: this binary has been compiled without support for yices. " << std::endl;
@@ -234,6 +261,7 @@ Encoder * SolvingArguments::getEncoder(Encoding * enc){
 			exit(UNSUPPORTEDFUNC_ERROR);
 		#else
 			e = new GlucoseAPIEncoder(enc);
+			e->setUseSolutionPhase(getBoolOption(SOLUTION_PHASE));
 		#endif
 		}
 		else if(solver=="minisat"){
@@ -251,20 +279,80 @@ Encoder * SolvingArguments::getEncoder(Encoding * enc){
 	}
 	else
 		e = getFileEncoder(enc);
+
+	e->setTimeLimit(getIntOption(TIME_LIMIT));
+	e->setProbeTimeLimit(getIntOption(PROBE_TIME_LIMIT));
 	return e;
 }
 
+bool SolvingArguments::checkEncoder(std::string & error){
+	if(getAMOPBEncoding()==AMOPB_DRYRUN){
+		error = "AMOPB constraints are not encoded in a dry run";
+		return false;
+	}
+	if(getBoolOption(USE_API) || getBoolOption(USE_IDL_SOVER)){
+		std::string solver = getBoolOption(USE_IDL_SOVER) ? "glucose" : getStringOption(SOLVER);
+		if(getAMOPBEncoding()==AMOPB_LAZY && solver!="glucose"){
+			error = "lazy AMOPB constraints are only supported by the glucose API";
+			return false;
+		}
+	#ifndef USEYICES
+		if(solver=="yices"){
+			error = "this binary has been compiled without support for yices";
+			return false;
+		}
+	#endif
+	#ifndef USEGLUCOSE
+		if(solver=="glucose"){
+			error = "this binary has been compiled without support for glucose";
+			return false;
+		}
+	#endif
+	#ifndef USEMINISAT
+		if(solver=="minisat"){
+			error = "this binary has been compiled without support for minisat";
+			return false;
+		}
+	#endif
+		if(solver!="yices" && solver!="glucose" && solver!="minisat"){
+			error = "API interaction not supported for solver " + solver;
+			return false;
+		}
+	}
+	else if(getAMOPBEncoding()==AMOPB_LAZY){
+		error = "lazy AMOPB constraints cannot be written to a file";
+		return false;
+	}
+	else if(getStringOption(FILE_FORMAT)!="dimacs" && getStringOption(FILE_FORMAT)!="smtlib2"){
+		error = "Unsupported file format " + getStringOption(FILE_FORMAT);
+		return false;
+	}
+	return true;
+}
+
 FileEncoder * SolvingArguments::getFileEncoder(Encoding * enc){
 	FileEncoder * fe = NULL;
 	std::string fileformat = getStringOption(FILE_FORMAT);
 	std::string solver = getStringOption(SOLVER);
 	std::string fileprefix = getStringOption(FILE_PREFIX);
+	if(getAMOPBEncoding()==AMOPB_LAZY){
+		std::cerr << "Error: lazy AMOPB constraints cannot be written to a file. " << std::endl;
+		exit(BADARGUMENTS_ERROR);
+	}
+	if(getAMOPBEncoding()==AMOPB_DRYRUN){
+		std::cerr << "Error: AMOPB constraints are not encoded in a dry run. " << std::endl;
+		exit(BADARGUMENTS_ERROR);
+	}
 	if(fileformat=="dimacs"){
-		fe = new DimacsFileEncoder(enc,solver);
+		DimacsFileEncoder * de = new DimacsFileEncoder(enc,solver);
+		de->setSimplify(getBoolOption(SIMPLIFY));
+		fe = de;
 		fe->setTmpFileName(fileprefix +".dimacs");
 	}
 	else if(fileformat=="smtlib2"){
-		fe = new SMTLIB2FileEncoder(enc,solver);
+		SMTLIB2FileEncoder * se = new SMTLIB2FileEncoder(enc,solver);
+		se->setInteractive(getBoolOption(SMT_SESSION));
+		fe = se;
 		fe->setTmpFileName(fileprefix +".smt2");
 	}
 	else{
@@ -291,3 +379,10 @@ PBEncoding SolvingArguments::getPBEncoding(){
 AMOPBEncoding SolvingArguments::getAMOPBEncoding(){
 	return amopbencodings[getStringOption(AMOPB_ENCODING)];
 }
+
+std::string SolvingArguments::getAMOPBEncodingName(AMOPBEncoding encoding){
+	for(const std::pair<std::string,AMOPBEncoding> & p : amopbencodings)
+		if(p.second==encoding)
+			return p.first;
+	return "";
+}
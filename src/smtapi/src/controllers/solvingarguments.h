@@ -10,6 +10,7 @@
 #include <stdio.h>
 #include <iostream>
 #include <stdlib.h>
+#include <csignal>
 #include "encoder.h"
 #include "fileencoder.h"
 #include "encoding.h"
@@ -34,8 +35,11 @@ enum SolvingArg {
 	RANDOM_SEED,
 	FILE_PREFIX,
 	USE_API,
+	SMT_SESSION,
+	SIMPLIFY,
 	USE_ASSUMPTIONS,
 	NARROW_BOUNDS,
+	SOLUTION_PHASE,
 	USE_IDL_SOVER,
 	PRINT_NOOPTIMAL_SOLUTIONS,
 	PRINT_OPTIMAL_SOLUTION,
@@ -43,6 +47,8 @@ enum SolvingArg {
 	PRINT_CHECKS_STATISTICS,
 	LOWER_BOUND,
 	UPPER_BOUND,
+	TIME_LIMIT,
+	PROBE_TIME_LIMIT,
 
 	AMO_ENCODING,
 	CARDINALITY_ENCODING,
@@ -75,6 +81,11 @@ public:
 	template<class OptionT>
 	static SolvingArguments * readArguments(int argc, char ** argv, Arguments<OptionT> * pargs);
 
+	//As readArguments, but without exiting: returns NULL and sets 'error' if the arguments are not valid.
+	//Help and version options are not handled
+	template<class OptionT>
+	static SolvingArguments * parseArguments(int argc, char ** argv, Arguments<OptionT> * pargs, std::string & error);
+
 	void checkSolvingArguments();
 
 	void printVersion() const;
@@ -85,6 +96,7 @@ public:
 
 
 	Encoder * getEncoder(Encoding * enc);
+	bool checkEncoder(std::string & error); //False and 'error' set if getEncoder would fail with these options
 	FileEncoder * getFileEncoder(Encoding * enc);
 	Optimizer * getOptimizer();
 
@@ -94,12 +106,50 @@ public:
 	PBEncoding getPBEncoding();
 	AMOPBEncoding getAMOPBEncoding();
 
+	//Name of 'encoding' in the --amopb option
+	static std::string getAMOPBEncodingName(AMOPBEncoding encoding);
+
 
 };
 
 template<class OptionT>
 SolvingArguments * SolvingArguments::readArguments(int argc, char ** argv, Arguments<OptionT> * pargs){
 
+	for(int i = 1; i < argc; i++){
+		std::string argval = argv[i];
+
+		if(argval=="-h" || argval=="--help"){
+			SolvingArguments sargs;
+			sargs.addArgument(argv[0]);
+			sargs.printHelp(pargs);
+			exit(0);
+		}
+
+		if(argval=="-v" || argval=="--version"){
+			SolvingArguments sargs;
+			sargs.printVersion();
+			exit(0);
+		}
+	}
+
+	std::string error;
+	SolvingArguments * sargs = parseArguments(argc,argv,pargs,error);
+	if(sargs == NULL){
+		std::cerr << error << std::endl;
+		if(error.compare(0,15,"Extra arguments")==0 || error=="Missing arguments")
+			std::cerr << std::endl << "Run \"" << argv[0] << " -h\" for help" << std::endl;
+		exit(BADARGUMENTS_ERROR);
+	}
+
+	//A solver that stops reading its input must not kill this process (see SolverProcess)
+	signal(SIGPIPE,SIG_IGN);
+
+	return sargs;
+}
+
+template<class OptionT>
+SolvingArguments * SolvingArguments::parseArguments(int argc, char ** argv, Arguments<OptionT> * pargs, std::string & error){
+
 	SolvingArguments * sargs = new SolvingArguments();
 	sargs->addArgument(argv[0]);
 
@@ -113,23 +163,14 @@ SolvingArguments * SolvingArguments::readArguments(int argc, char ** argv, Argum
 		else{
 			std::string argval = argv[i];
 
-			if(argval=="-h" || argval=="--help"){
-				sargs->printHelp(pargs);
-				exit(0);
-			}
-
-			if(argval=="-v" || argval=="--version"){
-				sargs->printVersion();
-				exit(0);
-			}
-
 			std::string arg = argval;
 			int delpos = argval.find("=");
 			if(delpos==argval.size()-1)
 				arg = argval.substr(0,delpos);
 			if(delpos==std::string::npos || delpos==argval.size()-1){
-				std::cerr << "Missing value for argument " << arg << std::endl;
-				exit(BADARGUMENTS_ERROR);
+				error = "Missing value for argument " + arg;
+				delete sargs;
+				return NULL;
 			}
 
 			arg = argval.substr(0,delpos);
@@ -139,69 +180,23 @@ SolvingArguments * SolvingArguments::readArguments(int argc, char ** argv, Argum
 
 			if(sargs->hasOption(arg)){
 				knownarg = true;
-				SolvingArg sarg = sargs->getOptionRef(arg);
-				switch(sargs->getOptionType(sarg)){
-
-					case INT_TYPE:
-						if(!isInteger(val)){
-							std::cerr << arg << " must be an integer value, received: " << val << std::endl;
-							exit(BADARGUMENTS_ERROR);
-						}
-						sargs->setOption(sarg,stoi(val));
-						break;
-
-					case BOOL_TYPE:
-						if(!boolstring(val)){
-							std::cerr << arg << " must be either 0 or 1, received: " << val << std::endl;
-							exit(BADARGUMENTS_ERROR);
-						}
-						sargs->setOption(sarg,val == "1");
-						break;
-
-					case STRING_TYPE:
-						sargs->setOption(sarg,val);
-						break;
-
-					default:
-						std::cerr << "Undefined type for option " << arg << std::endl;
-						exit(BADARGUMENTS_ERROR);
-						break;
+				if(!sargs->setOption(arg,val,error)){
+					delete sargs;
+					return NULL;
 				}
 			}
 			if(pargs->hasOption(arg)){
 				knownarg = true;
-				OptionT parg = pargs->getOptionRef(arg);
-				switch(pargs->getOptionType(parg)){
-					case INT_TYPE:
-						if(!isInteger(val)){
-							std::cerr << arg << " must be an integer value, received: " << val << std::endl;
-							exit(BADARGUMENTS_ERROR);
-						}
-						pargs->setOption(parg,stoi(val));
-						break;
-
-					case BOOL_TYPE:
-						if(!boolstring(val)){
-							std::cerr << arg << " must be either 0 or 1, received: " << val << std::endl;
-							exit(BADARGUMENTS_ERROR);
-						}
-						pargs->setOption(parg,val == "1");
-						break;
-
-					case STRING_TYPE:
-						pargs->setOption(parg,val);
-						break;
-
-					default:
-						std::cerr << "Undefined type for option " << arg << std::endl;
-						exit(BADARGUMENTS_ERROR);
-						break;
+				if(!pargs->setOption(arg,val,error)){
+					delete sargs;
+					return NULL;
 				}
 			}
 
 			if(!knownarg){
-				std::cerr << "Undefined option " << arg << std::endl;
-				exit(BADARGUMENTS_ERROR);
+				error = "Undefined option " + arg;
+				delete sargs;
+				return NULL;
 			}
 		}
 	}
@@ -209,18 +204,16 @@ SolvingArguments * SolvingArguments::readArguments(int argc, char ** argv, Argum
 	sargs->checkSolvingArguments();
 
 	if(pargs->getNArguments() > pargs->getAllowedArguments()){
-		std::cerr << "Extra arguments:";
+		error = "Extra arguments:";
 		for(int i = pargs->getAllowedArguments(); i < pargs->getNArguments(); i++)
-			std::cerr << " " << pargs->getArgument(i);
-
-		std::cerr << std::endl << std::endl;
-		std::cerr << "Run \"" << argv[0] << " -h\" for help" << std::endl;
-		exit(BADARGUMENTS_ERROR);
+			error += " " + pargs->getArgument(i);
+		delete sargs;
+		return NULL;
 	}
 	else if(pargs->getNArguments() < pargs->getMinimumArguments()){
-		std::cerr << "Missing arguments" << std::endl << std::endl;
-		std::cerr << "Run \"" << argv[0] << " -h\" for help" << std::endl;
-		exit(BADARGUMENTS_ERROR);
+		error = "Missing arguments";
+		delete sargs;
+		return NULL;
 	}
 
 	return sargs;
@@ -11,6 +11,10 @@ void APIEncoder::initAssumptionOptimization(int lb, int ub){
 	lastUB = ub;
 }
 
+bool APIEncoder::supportsAssumptions() const{
+	return true;
+}
+
 APIEncoder::~APIEncoder(){
 
 }
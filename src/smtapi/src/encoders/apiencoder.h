@@ -18,6 +18,8 @@ public:
 
 	void initAssumptionOptimization(int lb, int ub);
 
+	bool supportsAssumptions() const;
+
 	//Destructor
 	virtual ~APIEncoder();
 
@@ -6,7 +6,7 @@
 #include <stdexcept>
 #include <array>
 #include "errors.h"
-#include <iterator>
+#include "solveroutputreader.h"
 
 
 using namespace smtapi;
@@ -22,27 +22,28 @@ DimacsFileEncoder::DimacsFileEncoder(Encoding * enc, const std::string & solver)
 		std::cerr << "Unsupported solver " << solver << std::endl;
 		exit(BADARGUMENTS_ERROR);
 	}
+	simplify = false;
 }
 
 DimacsFileEncoder::~DimacsFileEncoder(){
 
 }
 
-std::string DimacsFileEncoder::getCall() const{
+std::vector<std::string> DimacsFileEncoder::getCall(bool & pipeinput) const{
+	std::vector<std::string> args;
+	args.push_back(solver);
+	pipeinput = solver == "glucose_release";
 	if(produceModels()){
 		if(solver == "glucose_release")
-			return solver + " -model " + getTMPFileName() + " | grep -E '(^s )|(^v )'";
+			args.push_back("-model");
 		else if(solver == "yices-sat")
-			return solver + " -m " + getTMPFileName() + " | tail -n 2";
+			args.push_back("-m");
 	}
-	else if(solver == "glucose_release") //Apanyu momentani
-		return solver + " " + getTMPFileName() + " | grep -E '(^s )|(^c CPU time)' | cut -d ':' -f 2 | sed -e 's/s//g'";
-	else return solver + " " + getTMPFileName() + " | grep -E '(^s )|(^v )'";
+	return args;
 }
 
 bool DimacsFileEncoder::checkSAT(int lb, int ub){
 
-	std::string filename = getTMPFileName();
 	if(workingFormula.f==NULL){
 		workingFormula.f = enc->encode(lb, ub);
 		workingFormula.LB = lb;
@@ -61,66 +62,36 @@ bool DimacsFileEncoder::checkSAT(int lb, int ub){
 	lastLB = lb;
 	lastUB = ub;
 
-	std::ofstream os(filename.c_str());
-	if(!os.is_open()){
-		std::cerr << "Error: could not open temporary working file: " << filename << std::endl;
-		exit(BADFILE_ERROR);
-	}
-
-	createFile(os,workingFormula.f);
-
-	os.close();
-
-	std::array<char, 512> buffer;
-	std::string result;
 	clock_t begin_time = clock();
 
-   std::shared_ptr<FILE> pipe(popen(getCall().c_str(),"r"), pclose);
-   if (!pipe) throw std::runtime_error("popen() failed!");
-   while (!feof(pipe.get())) {
-        if (fgets(buffer.data(), 512, pipe.get()) != nullptr)
-            result += buffer.data();
-    }
-
-	lastchecktime = ((float)( clock() - begin_time )) /  CLOCKS_PER_SEC;
-	std::istringstream iss(result);
-	std::vector<std::string> results((std::istream_iterator<std::string>(iss)),
-                                 std::istream_iterator<std::string>());
-
-	int i = 1;
-	int j = 2;
-	bool sat;
-
-	if(!produceModels() && solver=="glucose_release"){
-		solverchecktime = stof(results[0]);
-		sat = results[1]=="SATISFIABLE";
-	}
-	else{
-		if(results[1]=="SATISFIABLE"){
-			sat = true;
-		}
-		else if(results[1]=="OPTIMUM"){
-			sat = true;
-			j++;
-		}
-		else
-			sat=false;
+	//The working formula is kept as encoded, since it is narrowed in the next checks
+	FormulaSimplifier * simplifier = NULL;
+	SMTFormula * f = workingFormula.f;
+	if(simplify && f->getType()==SATFORMULA){
+		simplifier = new FormulaSimplifier(f);
+		f = simplifier->getFormula();
 	}
 
+	bool pipeinput;
+	std::vector<std::string> args = getCall(pipeinput);
+	std::vector<bool> model;
+	bool sat = runSolver(args,f,pipeinput,
+		[&](FILE * out){return readSolverOutput(out,f->getNBoolVars(),model);});
 
+	//The model is only trusted if the solver was not interrupted
 	if(sat && produceModels()){
-		//Retrieve model
-		std::vector<bool> model(workingFormula.f->getNBoolVars() + 1);
-		while(j < results.size()){
-			if(results[j]!="v"){
-				model[i] = stoi(results[j]) > 0;
-				i++;
-			}
-			j++;
+		if(simplifier != NULL){
+			std::vector<bool> original;
+			simplifier->recoverModel(model,original);
+			model.swap(original);
 		}
 		enc->setModel(workingFormula,lb,ub,model,std::vector<int>());
 	}
-	remove(filename.c_str());
+
+	delete simplifier;
+
+	lastchecktime = ((float)( clock() - begin_time )) /  CLOCKS_PER_SEC;
+
 	return sat;
 
 }
@@ -134,55 +105,56 @@ bool DimacsFileEncoder::optimize(int lb, int ub){
 	workingFormula.LB = lb;
 	workingFormula.UB = ub;
 
-	std::string filename = getTMPFileName();
-
-	std::ofstream os(filename.c_str());
-	if(!os.is_open()){
-		std::cerr << "Error: could not open temporary working file: " << filename << std::endl;
-		exit(BADFILE_ERROR);
-	}
+	clock_t begin_time = clock();
 
-	createFile(os,workingFormula.f);
+	std::vector<std::string> args;
+	args.push_back(solver);
+	std::vector<bool> model;
+	bool sat = runSolver(args,workingFormula.f,false,
+		[&](FILE * out){return readSolverOutput(out,workingFormula.f->getNBoolVars(),model,true);});
 
-	std::array<char, 512> buffer;
-   std::string result;
-	clock_t begin_time = clock();
-    std::shared_ptr<FILE> pipe(popen((solver + " " + filename + " | grep -E '(^s )|(^v )'").c_str(),"r"), pclose);
-    if (!pipe) throw std::runtime_error("popen() failed!");
-    while (!feof(pipe.get())) {
-        if (fgets(buffer.data(), 512, pipe.get()) != nullptr)
-            result += buffer.data();
-    }
+	if(sat && produceModels())
+		enc->setModel(workingFormula,lb,ub,model,std::vector<int>());
 
 	lastchecktime = float( clock() - begin_time ) /  CLOCKS_PER_SEC;
 
+	return sat;
+}
 
-	std::istringstream iss(result);
-	std::vector<std::string> results((std::istream_iterator<std::string>(iss)),
-                                 std::istream_iterator<std::string>());
 
-	bool sat = results[1]=="OPTIMUM";
-	if(sat && produceModels()){
-		//Retrieve model
-		std::vector<bool> model(workingFormula.f->getNBoolVars() + 1);
-		int i = 1;
-		int j = 3;
-		while(j < results.size()){
-			if(results[j]!="v"){
-				model[i] = stoi(results[j]) > 0;
-				i++;
-			}
-			j++;
+bool DimacsFileEncoder::readSolverOutput(FILE * pipe, int nvars, std::vector<bool> & model, bool optimum){
+	SolverOutputReader reader(pipe);
+	std::string tok;
+	bool sat = false;
+
+	if(produceModels())
+		model.resize(nvars+1);
+
+	//Literals are written straight into the model as they are read
+	int v;
+	while(reader.next(tok)){
+		if(tok=="c"){
+			//Comment lines, only the CPU time reported by glucose is kept
+			reader.readLine(tok);
+			size_t p = tok.find("CPU time");
+			if(p != std::string::npos && (p = tok.find(':',p)) != std::string::npos)
+				solverchecktime = atof(tok.c_str()+p+1);
 		}
-		enc->setModel(workingFormula,lb,ub,model,std::vector<int>());
+		else if(tok=="o")
+			reader.skipLine();
+		else if(tok=="s"){
+			if(reader.next(tok))
+				sat = tok=="OPTIMUM" || (!optimum && tok=="SATISFIABLE");
+		}
+		else if(tok=="sat")
+			sat = !optimum;
+		else if(produceModels() && SolverOutputReader::toInt(tok,v) && v!=0 && abs(v)<=nvars)
+			model[abs(v)] = v > 0;
 	}
 
-	remove(filename.c_str());
-
 	return sat;
 }
 
-
 void DimacsFileEncoder::createFile(std::ostream & os, SMTFormula * f) const{
 
 	switch(f->getType()){
@@ -267,3 +239,7 @@ void DimacsFileEncoder::createMaxSATFile(std::ostream & os, SMTFormula * f) cons
 		os << "0" << std::endl;
 	}
 }
+
+void DimacsFileEncoder::setSimplify(bool simplify){
+	this->simplify = simplify;
+}
@@ -3,6 +3,7 @@
 
 #include "fileencoder.h"
 #include "smtformula.h"
+#include "formulasimplifier.h"
 #include <iostream>
 
 using namespace smtapi;
@@ -20,12 +21,20 @@ class DimacsFileEncoder : public FileEncoder {
 private:
 	
 	std::string solver;
+
+	bool simplify; //Simplify the SAT formulas before sending them to the solver
 	
 	void createSATFile(std::ostream & os, SMTFormula * f) const;
 
 	void createMaxSATFile(std::ostream & os, SMTFormula * f) const;
 	
-	std::string getCall() const;
+	//Arguments of the solver call. The formula is piped to the solver if 'pipeinput' is set,
+	//otherwise the working file is appended to the arguments
+	std::vector<std::string> getCall(bool & pipeinput) const;
+
+	//Parses the solver output from 'pipe', and the model of the 'nvars' variables into 'model' if required.
+	//Returns true if the solver reported a satisfiable result (an optimal one if 'optimum' is set)
+	bool readSolverOutput(FILE * pipe, int nvars, std::vector<bool> & model, bool optimum = false);
 	
 public:	
   
@@ -37,6 +46,10 @@ public:
 
 	virtual void createFile(std::ostream & os, SMTFormula * f) const;
 
+	//If set, SAT formulas are simplified with FormulaSimplifier before each check,
+	//and the models are mapped back to the variables of the encoding
+	void setSimplify(bool simplify);
+
 	bool checkSAT(int lb, int ub);
 	
 	bool optimize(int lb, int ub);
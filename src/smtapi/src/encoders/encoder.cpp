@@ -8,6 +8,7 @@ Encoder::Encoder(Encoding * encoding){
 	this->workingFormula = EncodedFormula();
 
 	createModel = true;
+	solutionPhase = false;
 
 	lastchecktime = -1;
 	solverchecktime = -1;
@@ -21,6 +22,10 @@ Encoder::Encoder(Encoding * encoding){
 	ntheorypropagations = -1;
 	ntheoryconflicts = -1;
 
+	probetimelimit = -1;
+	hasdeadline = false;
+	cancelled = false;
+	timedout = false;
 }
 
 Encoder::~Encoder(){
@@ -49,11 +54,64 @@ bool Encoder::checkSATAssuming(int lb, int ub){
 	return false;
 }
 
+bool Encoder::checkSATAssumingCore(int lb, int ub, int maxub, int & corelb){
+	corelb = ub+1;
+	return checkSATAssuming(lb,ub);
+}
+
 void Encoder::initAssumptionOptimization(int lb, int ub){
 	std::cerr << "The selected encoder does not support checks with assumptions" << std::endl;
 	exit(UNSUPPORTEDFUNC_ERROR);
 }
 
+bool Encoder::supportsAssumptions() const{
+	return false;
+}
+
+void Encoder::setProbeTimeLimit(float seconds){
+	probetimelimit = seconds > 0 ? seconds : -1;
+}
+
+void Encoder::setTimeLimit(float seconds){
+	hasdeadline = seconds > 0;
+	if(hasdeadline)
+		deadline = std::chrono::steady_clock::now() + std::chrono::duration_cast<std::chrono::steady_clock::duration>(std::chrono::duration<float>(seconds));
+}
+
+void Encoder::cancel(){
+	cancelled = true;
+	interruptProbe();
+}
+
+bool Encoder::timedOut() const{
+	return timedout;
+}
+
+bool Encoder::budgetExhausted() const{
+	return cancelled || (hasdeadline && std::chrono::steady_clock::now() >= deadline);
+}
+
+float Encoder::getProbeBudget() const{
+	float budget = probetimelimit;
+	if(hasdeadline){
+		float remaining = std::chrono::duration<float>(deadline - std::chrono::steady_clock::now()).count();
+		if(remaining < 0)
+			remaining = 0;
+		if(budget < 0 || remaining < budget)
+			budget = remaining;
+	}
+	return budget;
+}
+
+bool Encoder::startProbe(){
+	timedout = cancelled || getProbeBudget() == 0;
+	return !timedout;
+}
+
+void Encoder::interruptProbe(){
+
+}
+
 void Encoder::narrowBounds(int lb, int ub){
 	std::cerr << "The selected encoder does not support narrowing bounds" << std::endl;
 	exit(UNSUPPORTEDFUNC_ERROR);
@@ -67,6 +125,14 @@ bool Encoder::produceModels() const{
 	return createModel;
 }
 
+void Encoder::setUseSolutionPhase(bool b){
+	this->solutionPhase = b;
+}
+
+bool Encoder::useSolutionPhase() const{
+	return solutionPhase;
+}
+
 float Encoder::getCheckTime() const{
 	return lastchecktime;
 }
@@ -2,6 +2,8 @@
 #define ENCODER_DEFINITION
 
 #include "encoding.h"
+#include <atomic>
+#include <chrono>
 
 
 class Encoder {
@@ -9,6 +11,7 @@ class Encoder {
 
 protected:
 	bool createModel;
+	bool solutionPhase;
 
 	Encoding * enc;
 
@@ -16,6 +19,23 @@ protected:
 	int lastLB;
 	int lastUB;
 
+	//Wall-clock budgets
+	float probetimelimit;
+	bool hasdeadline;
+	std::chrono::steady_clock::time_point deadline;
+	std::atomic<bool> cancelled;
+	bool timedout;
+
+	//Seconds available for the next probe, negative if unlimited
+	float getProbeBudget() const;
+
+	//Resets the timeout flag of a new probe. False (and timed out) if no budget is left
+	bool startProbe();
+
+	//Interrupts the running probe, if any. Must be async-signal-safe,
+	//it is called from the probe watchdog and from cancel()
+	virtual void interruptProbe();
+
 
 	//Statistics
 	float lastchecktime;
@@ -42,10 +62,16 @@ public:
 
 	virtual bool checkSATAssuming(int lb, int ub);
 
+	//As checkSATAssuming, with 'lb' a proved lower bound. If unsatisfiable, 'corelb' is set to a
+	//lower bound of the objective proved by the failed assumptions, between ub+1 and maxub+1
+	virtual bool checkSATAssumingCore(int lb, int ub, int maxub, int & corelb);
+
 	virtual void narrowBounds(int lb, int ub);
 
 	virtual void initAssumptionOptimization(int lb, int ub);
 
+	virtual bool supportsAssumptions() const; //True if checkSATAssuming can be used on a single formula
+
 	virtual bool optimize(int lb, int ub);
 
 	virtual int getObjective() const;
@@ -53,6 +79,26 @@ public:
 	void setProduceModels(bool b);
 	bool produceModels() const;
 
+	//If true, the solver prefers the values of the best known solution of the encoding in its decisions
+	void setUseSolutionPhase(bool b);
+	bool useSolutionPhase() const;
+
+	//Wall-clock budget of each probe, in seconds. Non-positive values disable it
+	void setProbeTimeLimit(float seconds);
+
+	//Global wall-clock budget of all the remaining probes, counted from now
+	void setTimeLimit(float seconds);
+
+	//Cancels the running probe and all the following ones. Can be called
+	//from another thread or a signal handler
+	void cancel();
+
+	//True if the last probe was interrupted, so its result is unknown
+	bool timedOut() const;
+
+	//True if no more probes can be run, either by cancellation or global budget
+	bool budgetExhausted() const;
+
 
 	//Statistics
 	float getCheckTime() const;
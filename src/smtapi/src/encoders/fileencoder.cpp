@@ -6,16 +6,21 @@
 #include <stdexcept>
 #include <array>
 #include "errors.h"
+#include "probewatchdog.h"
 #include <iterator>
 #include <sys/types.h>
+#include <sys/stat.h>
+#include <cerrno>
 #include <dirent.h>
 #include <cstdlib>
+#include <csignal>
 
 
 
 FileEncoder::FileEncoder(Encoding * encoding) : Encoder(encoding){
 	tmpfilename = "aux.txt";
 	defaulttmpdir = true;
+	runningpid = -1;
 }
 
 FileEncoder::~FileEncoder(){
@@ -31,10 +36,16 @@ std::string FileEncoder::getTMPFileName() const{
 			closedir(dir);
 		else if (ENOENT == errno)
 		{
-			const int dir_err = system((std::string("mkdir -p ") + TMPFILESPATH).c_str());
-			if (-1 == dir_err){
-				std::cerr << "Could not create directory " << TMPFILESPATH << std::endl;
-				exit(1);
+			//Create every component of the path, tolerating concurrent creations
+			std::string path = TMPFILESPATH;
+			for(size_t p = path.find('/',1); ; p = path.find('/',p+1)){
+				std::string sub = path.substr(0,p);
+				if(mkdir(sub.c_str(),0777) != 0 && errno != EEXIST){
+					std::cerr << "Could not create directory " << TMPFILESPATH << std::endl;
+					exit(BADFILE_ERROR);
+				}
+				if(p == std::string::npos)
+					break;
 			}
 		}
 		else{
@@ -54,6 +65,66 @@ std::string FileEncoder::getTMPFileName() const{
 }
 
 
+bool FileEncoder::runSolver(const std::vector<std::string> & args, SMTFormula * f, bool pipeinput, std::function<bool(FILE *)> read){
+	if(!startProbe())
+		return false;
+
+	SolverProcess p;
+	bool res;
+	{
+		ProbeWatchdog wd(getProbeBudget(),[this](){interruptProbe();});
+		launchSolver(p,args,f,pipeinput);
+		if(wd.hasExpired()) //Expired before the process was known
+			p.kill();
+		res = read(p.output());
+		runningpid = -1;
+		p.wait();
+		timedout = wd.hasExpired() || cancelled;
+	}
+	return res && !timedout;
+}
+
+void FileEncoder::interruptProbe(){
+	pid_t pid = runningpid;
+	if(pid > 0)
+		kill(pid,SIGKILL);
+}
+
+void FileEncoder::launchSolver(SolverProcess & p, std::vector<std::string> args, SMTFormula * f, bool pipeinput){
+	if(pipeinput){
+		p.start(args,true);
+		runningpid = p.getPid();
+		if(cancelled)
+			p.kill();
+		createFile(p.input(),f);
+		p.closeInput();
+	}
+	else{
+		std::string name = getTMPFileName();
+		size_t dot = name.rfind('.');
+		size_t slash = name.rfind('/');
+		if(dot == std::string::npos || (slash != std::string::npos && dot < slash))
+			dot = name.size();
+
+		std::string filename = SolverProcess::createUniqueFile(name.substr(0,dot),name.substr(dot));
+		p.setWorkingFile(filename);
+
+		std::ofstream os(filename.c_str());
+		if(!os.is_open()){
+			std::cerr << "Error: could not open temporary working file: " << filename << std::endl;
+			exit(BADFILE_ERROR);
+		}
+		createFile(os,f);
+		os.close();
+
+		args.push_back(filename);
+		p.start(args,false);
+		runningpid = p.getPid();
+		if(cancelled)
+			p.kill();
+	}
+}
+
 void FileEncoder::setTmpFileName(const std::string & filename){
 	this->tmpfilename = filename;
 }
@@ -5,7 +5,9 @@
 #include <stdlib.h>
 #include "encoder.h"
 #include "encoding.h"
+#include "solverprocess.h"
 #include <cstring>
+#include <functional>
 
 using namespace smtapi;
 
@@ -18,9 +20,23 @@ private:
 	std::string tmpfilename;
 	bool defaulttmpdir;
 
+	//Launches the solver with 'args' and feeds it 'f'. If 'pipeinput', the formula is streamed
+	//to the standard input of the solver. Otherwise it is written to a unique working file
+	//(derived from the tmp file name) whose path is appended to 'args', and removed when 'p' is waited for
+	void launchSolver(SolverProcess & p, std::vector<std::string> args, SMTFormula * f, bool pipeinput);
+
 protected:
+	std::atomic<pid_t> runningpid; //Solver process killed by interruptProbe()
+
 	std::string getTMPFileName() const;
 
+	//Runs the solver on 'f' (see launchSolver) within the probe budget, and parses its output with 'read'.
+	//Returns the result of 'read', or false if the probe was interrupted (see timedOut())
+	bool runSolver(const std::vector<std::string> & args, SMTFormula * f, bool pipeinput, std::function<bool(FILE *)> read);
+
+	//Kills the running solver process
+	void interruptProbe();
+
 public:
 
 	//Default constructor
@@ -1,6 +1,8 @@
 #include "glucoseapiencoder.h"
 #include "errors.h"
+#include "probewatchdog.h"
 #include <iostream>
+#include <iterator>
 
 using namespace Glucose;
 
@@ -8,6 +10,30 @@ GlucoseAPIEncoder::GlucoseAPIEncoder(Encoding * enc) : APIEncoder(enc){
 
 	this->lastVar = 0;
 	this->lastClause = -1;
+	this->lastLazyAMOPB = -1;
+	this->solving = false;
+
+	s = NULL;
+	idl = NULL;
+	amopbs = NULL;
+	resetSolver();
+}
+
+GlucoseAPIEncoder::~GlucoseAPIEncoder(){
+	delete s;
+	delete idl;
+	delete amopbs;
+}
+
+void GlucoseAPIEncoder::resetSolver(){
+	delete s;
+	delete idl;
+	delete amopbs;
+	idl = NULL;
+	amopbs = NULL;
+	vars.clear();
+	atomlits.clear();
+	differences.clear();
 
 	s = new SimpSolver();
 	s->use_simplification = false;
@@ -17,12 +43,6 @@ GlucoseAPIEncoder::GlucoseAPIEncoder(Encoding * enc) : APIEncoder(enc){
 	s->vbyte = false;
 	s->certifiedUNSAT=false;
 	//s->setIncrementalMode();
-
-
-}
-
-GlucoseAPIEncoder::~GlucoseAPIEncoder(){
-	delete s;
 }
 
 bool GlucoseAPIEncoder::checkSATAssuming(int lb, int ub){
@@ -33,8 +53,49 @@ bool GlucoseAPIEncoder::checkSATAssuming(int lb, int ub){
 	return assertAndCheck(lb,ub,&assumptions);
 }
 
+bool GlucoseAPIEncoder::checkSATAssumingCore(int lb, int ub, int maxub, int & corelb){
+	std::vector<literal> assumptions;
+	std::vector<int> levels; //Upper bound that implies each assumption
+
+	//Loosest bounds first, halving the distance to ub
+	for(int d = maxub; d > ub; d = ub + (d-ub)/2){
+		if(!enc->assumeUpperBound(workingFormula,d,assumptions))
+			break;
+		levels.resize(assumptions.size(),d);
+	}
+	enc->assumeBounds(workingFormula,lb,ub,assumptions);
+	levels.resize(assumptions.size(),ub);
+
+	corelb = ub+1;
+	bool sat = assertAndCheck(lb,ub,&assumptions);
+	if(sat || timedout)
+		return sat;
+
+	//The same literal may have been assumed at several levels, the largest one holds
+	std::map<Lit,int> litlevel;
+	for(int i = 0; i < assumptions.size(); i++){
+		Lit p = getLiteral(assumptions[i],vars);
+		std::map<Lit,int>::iterator it = litlevel.find(p);
+		if(it == litlevel.end() || it->second < levels[i])
+			litlevel[p] = levels[i];
+	}
+
+	//The conflict contains the negation of the failed assumptions. If empty, no value is feasible
+	int minlevel = maxub;
+	for(int i = 0; i < s->conflict.size(); i++){
+		std::map<Lit,int>::iterator it = litlevel.find(~s->conflict[i]);
+		if(it != litlevel.end() && it->second < minlevel)
+			minlevel = it->second;
+	}
+	corelb = minlevel+1;
+	return false;
+}
+
 void GlucoseAPIEncoder::narrowBounds(int lb, int ub){
-	enc->narrowBounds(workingFormula,lastLB,lastUB,lb,ub);
+	if(enc->narrowBounds(workingFormula,lastLB,lastUB,lb,ub)){
+		lastLB = lb;
+		lastUB = ub;
+	}
 }
 
 bool GlucoseAPIEncoder::checkSAT(int lb, int ub){
@@ -47,12 +108,10 @@ bool GlucoseAPIEncoder::checkSAT(int lb, int ub){
 			delete workingFormula.f;
 			this->lastVar = 0;
 			this->lastClause = -1;
+			this->lastLazyAMOPB = -1;
 			workingFormula = EncodedFormula(enc->encode(lb, ub),lb,ub);
 
-			//Reset glucose solver
-			delete s;
-			s = new SimpSolver();
-			vars.clear();
+			resetSolver();
 		}
 	}
 
@@ -71,6 +130,15 @@ bool GlucoseAPIEncoder::assertAndCheck(int lb, int ub, std::vector<literal> * as
 	for(int i = lastVar+1; i <= workingFormula.f->getNBoolVars(); i++)
 		vars[i]=s->newVar();
 
+	//Integer variables are the nodes of the difference logic graph, node 0 is the constant 0
+	if(workingFormula.f->getNIntVars() > 0){
+		if(idl == NULL){
+			idl = new IDLPropagator();
+			s->addTheory(idl);
+		}
+		idl->setNNodes(workingFormula.f->getNIntVars()+1);
+	}
+
 
 	bool consistent = true;
 
@@ -87,18 +155,35 @@ bool GlucoseAPIEncoder::assertAndCheck(int lb, int ub, std::vector<literal> * as
 		consistent = s->simplify();
 	}
 
+	//Add the new lazy AMO-PB constraints
+	if(workingFormula.f->getNLazyAMOPBs() > 0 && amopbs == NULL){
+		amopbs = new AMOPBPropagator();
+		s->addTheory(amopbs);
+	}
+	for(int i = lastLazyAMOPB+1; consistent && i < workingFormula.f->getNLazyAMOPBs(); i++)
+		consistent = addLazyAMOPB(workingFormula.f->getLazyAMOPBs()[i]);
+
 	lastVar = workingFormula.f->getNBoolVars();
 	lastClause = workingFormula.f->getNClauses()-1;
+	lastLazyAMOPB = workingFormula.f->getNLazyAMOPBs()-1;
 
 
 	bool sat;
 	if(!consistent){
+		sat=false;
+		timedout=false;
+		lastchecktime=0;
+	}
+	else if(!startProbe()){
 		sat=false;
 		lastchecktime=0;
 	}
 	else{
 		clock_t begin_time = clock();
 
+		if(useSolutionPhase())
+			setSolutionPhase();
+
 		//Make the satisfiability check
 		int nassumptions = assumptions==NULL ? 0 : assumptions->size();
 		vec<Lit> dummy(nassumptions);
@@ -106,7 +191,19 @@ bool GlucoseAPIEncoder::assertAndCheck(int lb, int ub, std::vector<literal> * as
 		for(int i = 0; i < nassumptions; i++)
 			dummy[i]=getLiteral((*assumptions)[i],vars);
 
-		sat = s->solveLimited(dummy,false,true)==l_True;
+		lbool res;
+		{
+			//Glucose polls its interrupt flag, which the watchdog or cancel() raise
+			solving = true;
+			ProbeWatchdog wd(getProbeBudget(),[this](){interruptProbe();});
+			if(cancelled)
+				s->interrupt();
+			res = s->solveLimited(dummy,false,true);
+			solving = false;
+		}
+		s->clearInterrupt();
+		timedout = res==l_Undef;
+		sat = res==l_True;
 		lastchecktime = float( clock() - begin_time ) /  CLOCKS_PER_SEC;
 
 	}
@@ -114,25 +211,49 @@ bool GlucoseAPIEncoder::assertAndCheck(int lb, int ub, std::vector<literal> * as
 	//Retrieve the model
 	if(sat && produceModels()){
 		std::vector<bool> bmodel(workingFormula.f->getNBoolVars()+1);
-		std::vector<int> imodel;
+		std::vector<int> imodel(workingFormula.f->getNIntVars()+1);
 
 		int ntrue=0;
 		int nfalse=0;
 		for(int i = 1; i <= workingFormula.f->getNBoolVars(); i++){
-			bmodel[i]=s->model[i-1]==l_True;
+			//Atoms also create solver variables, so the ids are not consecutive
+			bmodel[i]=s->model[vars[i]]==l_True;
 			if(bmodel[i])ntrue++;
 			else nfalse++;
 		}
+		for(int i = 1; i <= workingFormula.f->getNIntVars(); i++)
+			imodel[i]=idl->getValue(i);
 		enc->setModel(workingFormula,lb,ub,bmodel,imodel);
 	}
 
 	return sat;
 }
 
+void GlucoseAPIEncoder::setSolutionPhase(){
+	std::vector<literal> phase;
+	if(!enc->getPhase(workingFormula,phase))
+		return;
+
+	for(const literal & l : phase){
+		Lit p = getLiteral(l,vars);
+		s->setPolarity(var(p),sign(p));
+		s->bumpActivity(var(p));
+	}
+}
+
+void GlucoseAPIEncoder::interruptProbe(){
+	if(solving)
+		s->interrupt();
+}
+
 Lit GlucoseAPIEncoder::getLiteral(const literal & l, const std::vector<Var> & vars){
 	if(l.arith){
-		std::cerr << "Error: Glucose cannot deal with arithmetic literals"<< std::endl;
-		exit(BADCODIFICATION_ERROR);
+		//Literals not added to the formula (e.g. assumptions) are interned here
+		literal a = l;
+		if(a.atom == 0)
+			workingFormula.f->internAtom(a);
+		Lit p = getAtomLiteral(a.atom);
+		return a.sign ? p : ~p;
 	}
 	else{
 		if(l.v.id<=0 || l.v.id > workingFormula.f->getNBoolVars()){
@@ -143,3 +264,93 @@ Lit GlucoseAPIEncoder::getLiteral(const literal & l, const std::vector<Var> & va
 			return mkLit(vars[l.v.id],!l.sign);
 	}
 }
+
+bool GlucoseAPIEncoder::addLazyAMOPB(const amopb & c){
+	//Repeated literals are merged, and those that alone exceed K are falsified
+	std::map<Lit,int> terms;
+	for(int i = 0; i < c.X.size(); i++)
+		for(int j = 0; j < c.X[i].size(); j++)
+			terms[getLiteral(c.X[i][j],vars)] += c.Q[i][j];
+
+	std::vector<Lit> x;
+	std::vector<int> q;
+	for(const std::pair<const Lit,int> & t : terms){
+		if(t.second > c.K){
+			if(!s->addClause(~t.first))
+				return false;
+		}
+		else if(t.second > 0){
+			x.push_back(t.first);
+			q.push_back(t.second);
+		}
+	}
+	amopbs->addConstraint(x,q,c.K);
+	return true;
+}
+
+Lit GlucoseAPIEncoder::getAtomLiteral(int id){
+	if(id < atomlits.size() && atomlits[id] != lit_Undef)
+		return atomlits[id];
+
+	const arithcmp & c = workingFormula.f->getAtoms()[id];
+	const std::vector<intprod> & v = c.s.v;
+	Lit p;
+
+	if(v.empty()){
+		//Constant comparison
+		p = mkLit(s->newVar());
+		s->addClause((c.eq ? 0 == c.k : 0 <= c.k) ? p : ~p);
+	}
+	else{
+		int x, y;
+		if(v.size()==1 && v[0].coef==1){
+			x = v[0].varid;
+			y = 0;
+		}
+		else if(v.size()==2 && v[0].coef==1 && v[1].coef==-1){
+			x = v[0].varid;
+			y = v[1].varid;
+		}
+		else{
+			std::cerr << "Error: Glucose can only deal with difference logic arithmetic literals"<< std::endl;
+			exit(BADCODIFICATION_ERROR);
+		}
+
+		if(!c.eq)
+			p = getDifference(x,y,c.k);
+		else{
+			//x - y == k  <=>  x - y <= k  and  !(x - y <= k-1)
+			Lit le = getDifference(x,y,c.k);
+			Lit lt = getDifference(x,y,c.k-1);
+			p = mkLit(s->newVar());
+			s->addClause(~p,le);
+			s->addClause(~p,~lt);
+			s->addClause(p,~le,lt);
+		}
+	}
+
+	if(id >= atomlits.size())
+		atomlits.resize(id+1,lit_Undef);
+	atomlits[id] = p;
+	return p;
+}
+
+Lit GlucoseAPIEncoder::getDifference(int x, int y, int k){
+	std::map<int,Lit> & bounds = differences[std::make_pair(x,y)];
+	std::map<int,Lit>::iterator it = bounds.find(k);
+	if(it != bounds.end())
+		return it->second;
+
+	Var v = s->newVar();
+	idl->addAtom(v,x,y,k);
+	Lit p = mkLit(v);
+	it = bounds.insert(std::make_pair(k,p)).first;
+
+	//x - y <= k' implies x - y <= k for k' < k
+	if(it != bounds.begin())
+		s->addClause(~std::prev(it)->second,p);
+	if(std::next(it) != bounds.end())
+		s->addClause(~p,std::next(it)->second);
+
+	return p;
+}
@@ -5,13 +5,20 @@
 #include "glucose/simp/SimpSolver.h"
 #include "glucose/core/SolverTypes.h"
 #include "glucose/mtl/Vec.h"
+#include "idlpropagator.h"
+#include "amopbpropagator.h"
+#include <map>
 
 using namespace smtapi;
 using namespace Glucose;
 
 
 /*
- * This class asserts an SMT formula to the Yices2 API.
+ * This class asserts an SMT formula to the Glucose API.
+ * Arithmetic literals must be difference constraints (x - y <= k,
+ * x <= k and equalities of them), which are solved in-process by
+ * an IDL propagator attached to glucose. Lazy AMO-PB constraints
+ * are checked during the search by an AMO-PB propagator.
  */
 class GlucoseAPIEncoder : public APIEncoder {
 
@@ -21,12 +28,39 @@ private:
 
 	std::vector<Glucose::Var> vars;
 
+	IDLPropagator * idl;
+	std::vector<Glucose::Lit> atomlits; //Literal of each atom of the formula, lit_Undef if not yet created
+	std::map<std::pair<int,int>,std::map<int,Glucose::Lit> > differences; //(x,y) -> k -> x - y <= k
+
+	AMOPBPropagator * amopbs;
+
 	int lastVar;
 	int lastClause;
+	int lastLazyAMOPB;
+
+	std::atomic<bool> solving;
+
+	//Creates a new glucose solver, discarding the current one
+	void resetSolver();
 
 	Glucose::Lit getLiteral(const literal & l, const std::vector<Glucose::Var> & boolvars);
+
+	//Adds the lazy AMO-PB constraint 'c' to the AMO-PB propagator. False if the formula becomes inconsistent
+	bool addLazyAMOPB(const amopb & c);
+
+	//Literal of the atom 'id' of the working formula
+	Glucose::Lit getAtomLiteral(int id);
+
+	//Literal equivalent to x - y <= k. New ones are linked to the closest bounds of the same difference
+	Glucose::Lit getDifference(int x, int y, int k);
 	bool assertAndCheck(int lb, int ub, std::vector<literal> * assumptions);
 
+	//Sets the polarities of the literals that determine the best known solution, and bumps their activity
+	void setSolutionPhase();
+
+	//Raises the asynchronous interrupt flag of glucose
+	void interruptProbe();
+
 public:
 	//Default constructor
 	GlucoseAPIEncoder(Encoding * enc);
@@ -36,6 +70,10 @@ public:
 
 	bool checkSAT(int lb, int ub);
 	bool checkSATAssuming(int lb, int ub);
+
+	//The window literals of a ladder of upper bounds in (ub,maxub] are also assumed, and the
+	//lower bound is the smallest of them whose literals appear in the final conflict, plus one
+	bool checkSATAssumingCore(int lb, int ub, int maxub, int & corelb);
 	void narrowBounds(int lb, int ub);
 
 };
@@ -0,0 +1,33 @@
+#include "probewatchdog.h"
+#include <chrono>
+
+
+ProbeWatchdog::ProbeWatchdog(float seconds, std::function<void()> onExpire){
+	done = false;
+	expired = false;
+	if(seconds < 0)
+		return;
+
+	th = std::thread([this,seconds,onExpire](){
+		std::unique_lock<std::mutex> lock(m);
+		if(!cv.wait_for(lock,std::chrono::duration<float>(seconds),[this](){return done;})){
+			expired = true;
+			onExpire();
+		}
+	});
+}
+
+ProbeWatchdog::~ProbeWatchdog(){
+	if(th.joinable()){
+		{
+			std::lock_guard<std::mutex> lock(m);
+			done = true;
+		}
+		cv.notify_one();
+		th.join();
+	}
+}
+
+bool ProbeWatchdog::hasExpired() const{
+	return expired;
+}
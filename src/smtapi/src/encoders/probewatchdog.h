@@ -0,0 +1,41 @@
+#ifndef PROBEWATCHDOG_DEFINITION
+#define PROBEWATCHDOG_DEFINITION
+
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <functional>
+
+
+/*
+ * Wall-clock timer guarding a single solver probe. If the probe
+ * is still running after the given budget, 'onExpire' is called
+ * from a helper thread, which is expected to interrupt the solver
+ * (e.g. killing its process or raising its interrupt flag).
+ * Destroying the watchdog before the budget is spent disarms it.
+ */
+class ProbeWatchdog {
+
+private:
+
+	std::thread th;
+	std::mutex m;
+	std::condition_variable cv;
+	bool done;
+	std::atomic<bool> expired;
+
+public:
+
+	//Constructor. A negative budget never expires
+	ProbeWatchdog(float seconds, std::function<void()> onExpire);
+
+	//Destructor. Disarms the watchdog and waits for the helper thread
+	~ProbeWatchdog();
+
+	//True if the budget was spent and 'onExpire' was called
+	bool hasExpired() const;
+
+};
+
+#endif
@@ -6,7 +6,8 @@
 #include <stdexcept>
 #include <array>
 #include "errors.h"
-#include <iterator>
+#include "solveroutputreader.h"
+#include "probewatchdog.h"
 
 using namespace smtapi;
 
@@ -14,15 +15,49 @@ SMTLIB2FileEncoder::SMTLIB2FileEncoder(Encoding * enc, const std::string & solve
 	logic = "QF_LIA";
 
 	this->solver = solver;
+
+	interactive = false;
+	session = NULL;
+	reader = NULL;
 }
 
 SMTLIB2FileEncoder::~SMTLIB2FileEncoder(){
+	closeSession();
+}
 
+void SMTLIB2FileEncoder::setInteractive(bool interactive){
+	this->interactive = interactive;
 }
 
-bool SMTLIB2FileEncoder::checkSAT(int lb, int ub){
+bool SMTLIB2FileEncoder::supportsAssumptions() const{
+	return interactive;
+}
+
+void SMTLIB2FileEncoder::initAssumptionOptimization(int lb, int ub){
+	closeSession();
+	if(workingFormula.f!=NULL)
+		delete workingFormula.f;
+	workingFormula = EncodedFormula(enc->encode(lb,ub),lb,ub);
+
+	lastLB = lb;
+	lastUB = ub;
+}
+
+bool SMTLIB2FileEncoder::checkSATAssuming(int lb, int ub){
+	std::vector<literal> assumptions;
+	enc->assumeBounds(workingFormula,lb,ub,assumptions);
+	return checkSession(lb,ub,assumptions);
+}
+
+void SMTLIB2FileEncoder::narrowBounds(int lb, int ub){
+	//The new clauses are streamed to the session before the next check
+	if(enc->narrowBounds(workingFormula,lastLB,lastUB,lb,ub)){
+		lastLB = lb;
+		lastUB = ub;
+	}
+}
 
-	std::string filename = getTMPFileName();
+bool SMTLIB2FileEncoder::checkSAT(int lb, int ub){
 
 	if(workingFormula.f==NULL){
 		workingFormula = EncodedFormula(enc->encode(lb, ub),lb,ub);
@@ -30,6 +65,7 @@ bool SMTLIB2FileEncoder::checkSAT(int lb, int ub){
 	else{
 		bool narrowed = enc->narrowBounds(workingFormula,lastLB, lastUB, lb, ub);
 		if(!narrowed){
+			closeSession();
 			delete workingFormula.f;
 			workingFormula = EncodedFormula(enc->encode(lb, ub),lb,ub);
 		}
@@ -38,95 +74,249 @@ bool SMTLIB2FileEncoder::checkSAT(int lb, int ub){
 	lastLB = lb;
 	lastUB = ub;
 
-	std::ofstream os(filename.c_str());
-	if(!os.is_open()){
-		std::cerr << "Could not open file: " << filename << std::endl;
-		std::cerr << "Aborted" << std::endl;
-		exit(BADFILE_ERROR);
-	}
-
-	createFile(os,workingFormula.f);
-
-	os.close();
-
+	if(interactive)
+		return checkSession(lb,ub,std::vector<literal>());
 
 	//Recover solution
-	std::array<char, 512> buffer;
-   std::string result;
 	clock_t begin_time = clock();
 
-	std::string sentence;
+	//The formula is streamed to the standard input of the solver
+	std::vector<std::string> args;
 	if(solver=="yices")
-		sentence = "yices-smt2 " + filename + " | sed -re '2,$s/([ ]*[(]*[ ]*[^ ]*[ ]*)//' -e '2,$s/[)]//' -e '2,$s/[)]$//'";
+		args.push_back("yices-smt2");
 	else if(solver == "optimathsat"){
+		args.push_back("optimathsat");
 		if(produceModels())
-			sentence = "optimathsat -model_generation=TRUE " + filename + " | sed -re '2,$s/([ ]*[(]*[ ]*[^ ]*[ ]*)//' -e '2,$s/[)]//' -e '2,$s/[)]$//'";
-		else
-			sentence = "optimathsat " + filename + " | sed -re '2,$s/([ ]*[(]*[ ]*[^ ]*[ ]*)//' -e '2,$s/[)]//' -e '2,$s/[)]$//'";
+			args.push_back("-model_generation=TRUE");
 	}
 	else{
 		std::cerr << "Unsupported solver " << solver << std::endl;
 		exit(BADARGUMENTS_ERROR);
 	}
 
-   std::shared_ptr<FILE> pipe(popen(sentence.c_str(),"r"), pclose);
-    if (!pipe) throw std::runtime_error("popen() failed!");
-    while (!feof(pipe.get())) {
-        if (fgets(buffer.data(), 512, pipe.get()) != nullptr)
-            result += buffer.data();
-    }
+	int nints = workingFormula.f->getNIntVars();
+	int nbools = workingFormula.f->getNBoolVars();
+	std::vector<int> imodel;
+	std::vector<bool> bmodel;
+	bool complete = true;
+
+	bool sat = runSolver(args,workingFormula.f,true,[&](FILE * out){
+		SolverOutputReader reader(out,true);
+		std::string tok;
+
+		bool sat = reader.next(tok) && tok=="sat";
+
+		if(sat && produceModels()){
+			//All the variables are requested, in order
+			std::vector<int> ivars, bvars;
+			for(int i = 1; i <= nints; i++)
+				ivars.push_back(i);
+			for(int i = 1; i <= nbools; i++)
+				bvars.push_back(i);
+			imodel.resize(nints+1);
+			bmodel.resize(nbools+1);
+			complete = readValues(reader,ivars,bvars,imodel,bmodel);
+		}
+		return sat;
+	});
+
+	if(sat && produceModels()){
+		if(!complete){
+			std::cerr << "Error retrieving the solution from the SMT solver" << std::endl;
+			exit(SOLVING_ERROR);
+		}
+		enc->setModel(workingFormula,lb,ub,bmodel,imodel);
+	}
 
 	lastchecktime = float( clock() - begin_time ) /  CLOCKS_PER_SEC;
 
-	std::istringstream iss(result);
-	std::vector<std::string> results((std::istream_iterator<std::string>(iss)),
-                                 std::istream_iterator<std::string>());
 
-	bool sat = results[0]=="sat";
+	return sat;
+}
 
-	if(sat && produceModels()){
-		std::vector<int> imodel(workingFormula.f->getNIntVars()+1);
-		std::vector<bool> bmodel(workingFormula.f->getNBoolVars()+1);
+void SMTLIB2FileEncoder::startSession(){
+	if(workingFormula.f->getType() != SMTFORMULA){
+		std::cerr << "Error: interactive SMT-LIB2 sessions only support satisfiability checks" << std::endl;
+		exit(UNSUPPORTEDFUNC_ERROR);
+	}
 
-		if(results.size() < workingFormula.f->getNIntVars() + workingFormula.f->getNBoolVars() + 1){
-			std::cerr << "Error retrieving the solution from the SMT solver";
-			exit(SOLVING_ERROR);
+	std::vector<std::string> args;
+	if(solver=="yices"){
+		args.push_back("yices-smt2");
+		args.push_back("--incremental");
+	}
+	else if(solver == "optimathsat")
+		args.push_back("optimathsat");
+	else{
+		std::cerr << "Unsupported solver " << solver << std::endl;
+		exit(BADARGUMENTS_ERROR);
+	}
+
+	session = new SolverProcess();
+	session->start(args,true);
+	runningpid = session->getPid();
+	reader = new SolverOutputReader(session->output(),true);
+
+	pheader(session->input());
+	sentintvars = 0;
+	sentboolvars = 0;
+	sentatoms = 0;
+	sentclauses = 0;
+	definedatoms.clear();
+}
+
+void SMTLIB2FileEncoder::closeSession(){
+	if(session!=NULL){
+		runningpid = -1;
+		session->input() << "(exit)" << std::endl;
+		session->wait();
+		delete reader;
+		delete session;
+		reader = NULL;
+		session = NULL;
+	}
+}
+
+bool SMTLIB2FileEncoder::checkSession(int lb, int ub, const std::vector<literal> & assumptions){
+	if(!startProbe())
+		return false;
+
+	clock_t begin_time = clock();
+
+	SMTFormula * f = workingFormula.f;
+	bool sat = false;
+	bool answered = false;
+	bool unknown = false;
+	bool killed;
+	std::vector<int> imodel;
+	std::vector<bool> bmodel;
+	{
+		ProbeWatchdog wd(getProbeBudget(),[this](){interruptProbe();});
+
+		if(session==NULL)
+			startSession();
+		std::ostream & os = session->input();
+
+		//Only the part of the formula not sent yet: the base formula
+		//on the first check, and the narrowing clauses afterwards
+		pdeclarations(f,os,sentintvars+1,sentboolvars+1);
+		pdefinitions(f,os,sentatoms+1);
+		passertions(f,os,sentclauses);
+		sentintvars = f->getNIntVars();
+		sentboolvars = f->getNBoolVars();
+		sentatoms = f->getNAtoms();
+		sentclauses = f->getNClauses();
+
+		if(!assumptions.empty()){
+			os << "(push 1)\n";
+			for(const literal & l : assumptions){
+				os << "(assert";
+				pliteral(f,l,os);
+				os << ")\n";
+			}
 		}
+		os << "(check-sat)" << std::endl;
 
-		int idx = 1;
-		for(int i = 1; i <= workingFormula.f->getNIntVars();i++){
-			imodel[i]=stoi(results[idx]);
-			idx++;
+		std::string tok;
+		answered = reader->next(tok);
+		if(answered && tok == "(" && !wd.hasExpired() && !cancelled){
+			reader->skipLine();
+			std::cerr << "Error: the SMT solver reported an error in the interactive session" << std::endl;
+			exit(SOLVING_ERROR);
 		}
-		for(int i = 1; i <= workingFormula.f->getNBoolVars();i++){
-			bmodel[i]=results[idx]=="true";
-			idx++;
+		sat = answered && tok == "sat";
+		unknown = answered && tok == "unknown";
+		answered = answered && (sat || unknown || tok == "unsat");
+
+		if(sat && produceModels()){
+			//Only the values required by the encoding, if it tells which ones
+			std::vector<int> ivars, bvars;
+			if(!enc->getModelVars(workingFormula,ivars,bvars)){
+				for(int i = 1; i <= f->getNIntVars(); i++)
+					ivars.push_back(i);
+				for(int i = 1; i <= f->getNBoolVars(); i++)
+					bvars.push_back(i);
+			}
+			os << "(get-value (";
+			for(int i : ivars)
+				os << " " << ivn(f->getIntVarNames()[i]);
+			for(int i : bvars)
+				os << " " << bvn(f->getBoolVarNames()[i]);
+			os << "))" << std::endl;
+
+			imodel.resize(f->getNIntVars()+1);
+			bmodel.resize(f->getNBoolVars()+1);
+			answered = readValues(*reader,ivars,bvars,imodel,bmodel);
 		}
 
-		enc->setModel(workingFormula,lb,ub,bmodel,imodel);
+		if(!assumptions.empty())
+			os << "(pop 1)" << std::endl;
+
+		killed = wd.hasExpired() || cancelled;
+	}
+
+	//A killed solver ends the session, the next check starts a new one
+	if(killed)
+		closeSession();
+	else if(!answered){
+		std::cerr << "Error: the SMT solver did not answer in the interactive session" << std::endl;
+		exit(SOLVING_ERROR);
 	}
 
-	remove(filename.c_str());
+	timedout = killed || unknown;
+	if(timedout)
+		sat = false;
+	else if(sat && produceModels())
+		enc->setModel(workingFormula,lb,ub,bmodel,imodel);
 
+	lastchecktime = float( clock() - begin_time ) /  CLOCKS_PER_SEC;
 
 	return sat;
 }
 
+bool SMTLIB2FileEncoder::readValues(SolverOutputReader & reader, const std::vector<int> & ivars, const std::vector<int> & bvars, std::vector<int> & imodel, std::vector<bool> & bmodel) const{
+	//The values come as ((name value) ...) in the same order as requested,
+	//negative integers as (- n). The whole answer is consumed
+	std::string tok;
+	if(!reader.next(tok) || tok != "(")
+		return false;
+
+	int n = ivars.size() + bvars.size();
+	for(int idx = 0; idx < n; idx++){
+		if(!reader.next(tok) || tok != "(" || !reader.next(tok) || !reader.next(tok))
+			return false;
+		bool neg = false;
+		if(tok=="("){
+			if(!reader.next(tok) || tok != "-" || !reader.next(tok))
+				return false;
+			neg = true;
+		}
+		if(idx < ivars.size()){
+			int v;
+			if(!SolverOutputReader::toInt(tok,v))
+				return false;
+			imodel[ivars[idx]] = neg ? -v : v;
+		}
+		else
+			bmodel[bvars[idx-ivars.size()]] = tok=="true";
+		if(neg && (!reader.next(tok) || tok != ")"))
+			return false;
+		if(!reader.next(tok) || tok != ")")
+			return false;
+	}
+	return reader.next(tok) && tok == ")";
+}
+
 bool SMTLIB2FileEncoder::optimize(int lb, int ub){
 	checkSAT(lb,ub);
 }
 
 void SMTLIB2FileEncoder::createFile(std::ostream & os, SMTFormula * f) const{
 
-	if(produceModels())
-		os << "(set-option :produce-models true)" << std::endl;
-
-	os << "(set-logic " << logic << ")" << std::endl;
-	for(int i = 1; i <= f->getNIntVars();i++)
-		if(f->isDeclareVar(i))
-			os << "(declare-fun " << ivn(f->getIntVarNames()[i]) << "() Int)" << std::endl;
-	for(int i = 1; i <= f->getNBoolVars();i++)
-			os << "(declare-fun " << bvn(f->getBoolVarNames()[i]) << "() Bool)" << std::endl;
+	pheader(os);
+	pdeclarations(f,os,1,1);
+	definedatoms.clear();
+	pdefinitions(f,os,1);
 
 	for(int i = 0; i < f->getSoftClauses().size(); i++){
 		const clause &c = f->getSoftClauses()[i];
@@ -140,11 +330,7 @@ void SMTLIB2FileEncoder::createFile(std::ostream & os, SMTFormula * f) const{
 		os << ")" << std::endl;
 	}
 
-	for(const clause &c : f->getClauses()){
-		os << "(assert";
-		pclause(f,c,os);
-		os << ")" << std::endl;
-	}
+	passertions(f,os,0);
  
 	if(f->getType() == OMTMINFORMULA || f->getType()==OMTMAXFORMULA){
 		if(f->getType() == OMTMINFORMULA)
@@ -183,6 +369,44 @@ void SMTLIB2FileEncoder::createFile(std::ostream & os, SMTFormula * f) const{
 	os << "(exit)" << std::endl;
 }
 
+void SMTLIB2FileEncoder::pheader(std::ostream & os) const{
+	if(produceModels())
+		os << "(set-option :produce-models true)" << std::endl;
+
+	os << "(set-logic " << logic << ")" << std::endl;
+}
+
+void SMTLIB2FileEncoder::pdeclarations(SMTFormula * f, std::ostream & os, int firstint, int firstbool) const{
+	for(int i = firstint; i <= f->getNIntVars();i++)
+		if(f->isDeclareVar(i))
+			os << "(declare-fun " << ivn(f->getIntVarNames()[i]) << "() Int)\n";
+	for(int i = firstbool; i <= f->getNBoolVars();i++)
+			os << "(declare-fun " << bvn(f->getBoolVarNames()[i]) << "() Bool)\n";
+}
+
+void SMTLIB2FileEncoder::pdefinitions(SMTFormula * f, std::ostream & os, int firstatom) const{
+	const std::vector<arithcmp> & atoms = f->getAtoms();
+	definedatoms.resize(atoms.size(),false);
+	for(int i = firstatom; i < atoms.size(); i++){
+		//An atom used once is shorter inline
+		if(f->getAtomOccurrences(i) > 1){
+			os << "(define-fun " << avn(i) << "() Bool";
+			pcmp(f,atoms[i],os);
+			os << ")\n";
+			definedatoms[i] = true;
+		}
+	}
+}
+
+void SMTLIB2FileEncoder::passertions(SMTFormula * f, std::ostream & os, int firstclause) const{
+	const std::vector<clause> & clauses = f->getClauses();
+	for(int i = firstclause; i < clauses.size(); i++){
+		os << "(assert";
+		pclause(f,clauses[i],os);
+		os << ")\n";
+	}
+}
+
 inline std::string SMTLIB2FileEncoder::ivn(const std::string &s) const{
 	return "i_"+s;
 }
@@ -191,6 +415,10 @@ inline std::string SMTLIB2FileEncoder::bvn(const std::string &s) const{
 	return "b_"+s;
 }
 
+inline std::string SMTLIB2FileEncoder::avn(int id) const{
+	return "a_"+std::to_string(id);
+}
+
 void SMTLIB2FileEncoder::pclause(SMTFormula * f, const clause & c, std::ostream & os) const{
 	if(c.v.size()==0)
 		os << " false";
@@ -209,16 +437,10 @@ void SMTLIB2FileEncoder::pliteral(SMTFormula * f, const literal & l, std::ostrea
 	if(!l.sign)
 		os << " (not";
 	if(l.arith){
-		if(l.cmp.eq)
-			os << " (=";
-		else
-			os << " (<=";
-		psum(f,l.cmp.s,os);
-		if(l.cmp.k >= 0)
-			os << " " << l.cmp.k;
+		if(l.atom > 0 && definedatoms[l.atom]) //Defined once by pdefinitions
+			os << " " << avn(l.atom);
 		else
-			os << " (- " << -l.cmp.k << ")";
-		os << ")";
+			pcmp(f,l.cmp,os);
 	}
 	else{
 		if(l.v.id<=0 || l.v.id>f->getNBoolVars()){
@@ -231,6 +453,19 @@ void SMTLIB2FileEncoder::pliteral(SMTFormula * f, const literal & l, std::ostrea
 		os << ")";
 }
 
+void SMTLIB2FileEncoder::pcmp(SMTFormula * f, const arithcmp & cmp, std::ostream & os) const{
+	if(cmp.eq)
+		os << " (=";
+	else
+		os << " (<=";
+	psum(f,cmp.s,os);
+	if(cmp.k >= 0)
+		os << " " << cmp.k;
+	else
+		os << " (- " << -cmp.k << ")";
+	os << ")";
+}
+
 void SMTLIB2FileEncoder::psum(SMTFormula * f, const intsum & s,std::ostream & os) const{
 	if(s.v.empty())
 			os << " 0";
@@ -2,6 +2,7 @@
 #define SMTLIB2FILEENCODER_DEFINITION
 
 #include "fileencoder.h"
+#include "solveroutputreader.h"
 
 using namespace smtapi;
 
@@ -19,18 +20,53 @@ private:
 	//Configuration parameters
 	std::string logic;
 
+	//Interactive session: the solver is launched once, the formula is sent
+	//incrementally and the bounds of each check are asserted between push/pop
+	bool interactive;
+	SolverProcess * session;
+	SolverOutputReader * reader;
+	int sentintvars;
+	int sentboolvars;
+	int sentatoms;
+	int sentclauses;
+
+	//Atoms written as named Booleans, the others are written inline
+	mutable std::vector<bool> definedatoms;
+
+	void startSession();
+	void closeSession();
+
+	//Checks the working formula in the session under 'assumptions', sending first the part not sent yet
+	bool checkSession(int lb, int ub, const std::vector<literal> & assumptions);
+
+	//Reads the answer of a (get-value ...) of the Int variables 'ivars' followed by the Boolean variables 'bvars'.
+	//False if the answer is malformed or incomplete
+	bool readValues(SolverOutputReader & reader, const std::vector<int> & ivars, const std::vector<int> & bvars, std::vector<int> & imodel, std::vector<bool> & bmodel) const;
+
 	//Functions to avoid conflicts between Int and Boolean
 	//unnamed variables:
 		//Concatenates "i_" at the begining of a variable name
 		inline std::string ivn(const std::string &s) const;
 		//Concatenates "i_" at the begining of a variable name
 		inline std::string bvn(const std::string &s) const;
-
-
+		//Name of the Boolean defined as the atom 'id'
+		inline std::string avn(int id) const;
+
+
+	//Writes the options and logic into 'os'
+	void pheader(std::ostream & os) const;
+	//Writes the declarations of the Int/Boolean variables of 'f' from 'firstint'/'firstbool' into 'os'
+	void pdeclarations(SMTFormula * f, std::ostream & os, int firstint, int firstbool) const;
+	//Writes the definitions of the atoms of 'f' from 'firstatom' occurring more than once into 'os'
+	void pdefinitions(SMTFormula * f, std::ostream & os, int firstatom) const;
+	//Writes the assertions of the clauses of 'f' from 'firstclause' into 'os'
+	void passertions(SMTFormula * f, std::ostream & os, int firstclause) const;
 	//Writes the codification of 'c' into 'os'
 	void pclause(SMTFormula * f, const clause & c,std::ostream & os) const;
 	//Writes the codification of 'l' into 'os'
 	void pliteral(SMTFormula * f, const literal & l,std::ostream & os) const;
+	//Writes the codification of 'cmp' into 'os'
+	void pcmp(SMTFormula * f, const arithcmp & cmp, std::ostream & os) const;
 	//Writes the codification of 's' into 'os'
 	void psum(SMTFormula * f, const intsum & s,std::ostream & os) const;
 	//Writes the codification of 'p' into 'os'
@@ -47,8 +83,17 @@ public:
 
 	void createFile(std::ostream & os, SMTFormula * f) const;
 
+	//If set, checks are run in a persistent interactive session of the solver
+	void setInteractive(bool interactive);
+
 	bool checkSAT(int lb, int ub);
 
+	//Only available in interactive sessions
+	bool supportsAssumptions() const;
+	void initAssumptionOptimization(int lb, int ub);
+	bool checkSATAssuming(int lb, int ub);
+	void narrowBounds(int lb, int ub);
+
 	bool optimize(int lb, int ub);
 
 };
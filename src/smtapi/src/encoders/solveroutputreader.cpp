@@ -0,0 +1,92 @@
+#include "solveroutputreader.h"
+#include <cctype>
+#include <cerrno>
+#include <unistd.h>
+
+
+SolverOutputReader::SolverOutputReader(FILE * f, bool parentheses){
+	this->f = f;
+	this->parentheses = parentheses;
+	this->pos = 0;
+	this->len = 0;
+}
+
+inline int SolverOutputReader::peek(){
+	if(pos == len){
+		//read() returns what is available, so interactive solvers never block the reader
+		do
+			len = read(fileno(f),buffer,BUFFERSIZE);
+		while(len < 0 && errno == EINTR);
+		pos = 0;
+		if(len <= 0){
+			len = 0;
+			return EOF;
+		}
+	}
+	return (unsigned char) buffer[pos];
+}
+
+bool SolverOutputReader::next(std::string & tok){
+	tok.clear();
+
+	int c = peek();
+	while(c != EOF && isspace(c)){
+		pos++;
+		c = peek();
+	}
+
+	if(c == EOF)
+		return false;
+
+	if(parentheses && (c == '(' || c == ')')){
+		pos++;
+		tok.push_back(c);
+		return true;
+	}
+
+	while(c != EOF && !isspace(c) && !(parentheses && (c == '(' || c == ')'))){
+		tok.push_back(c);
+		pos++;
+		c = peek();
+	}
+	return true;
+}
+
+void SolverOutputReader::skipLine(){
+	int c = peek();
+	while(c != EOF && c != '\n'){
+		pos++;
+		c = peek();
+	}
+}
+
+void SolverOutputReader::readLine(std::string & line){
+	line.clear();
+	int c = peek();
+	while(c != EOF && c != '\n'){
+		line.push_back(c);
+		pos++;
+		c = peek();
+	}
+}
+
+bool SolverOutputReader::toInt(const std::string & tok, int & v){
+	int i = 0;
+	bool neg = false;
+	if(!tok.empty() && (tok[0] == '-' || tok[0] == '+')){
+		neg = tok[0] == '-';
+		i++;
+	}
+	if(i == tok.size())
+		return false;
+
+	v = 0;
+	for(; i < tok.size(); i++){
+		if(!isdigit(tok[i]))
+			return false;
+		v = v*10 + (tok[i]-'0');
+	}
+	if(neg)
+		v = -v;
+	return true;
+}
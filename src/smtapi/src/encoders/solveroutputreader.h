@@ -0,0 +1,51 @@
+#ifndef SOLVEROUTPUTREADER_DEFINITION
+#define SOLVEROUTPUTREADER_DEFINITION
+
+#include <cstdio>
+#include <string>
+
+
+/*
+ * Incremental tokenizer of the output of an external solver.
+ * The stream is consumed through a fixed size buffer, so no copy
+ * of the whole output is ever stored. Only the available bytes are
+ * read, so it can be used on the pipe of an interactive session. Tokens are separated by
+ * white spaces. If 'parentheses' is set, '(' and ')' are also
+ * returned as single character tokens (for SMT-LIB2 outputs).
+ */
+class SolverOutputReader {
+
+private:
+
+	static const int BUFFERSIZE = 1 << 16;
+
+	FILE * f;
+	bool parentheses;
+
+	char buffer[BUFFERSIZE];
+	int pos;
+	int len;
+
+	//Returns the next character without consuming it, EOF at the end of the stream
+	inline int peek();
+
+public:
+
+	//Constructor
+	SolverOutputReader(FILE * f, bool parentheses = false);
+
+	//Reads the next token into 'tok'. False at the end of the stream
+	bool next(std::string & tok);
+
+	//Discards the rest of the current line
+	void skipLine();
+
+	//Reads the rest of the current line into 'line'
+	void readLine(std::string & line);
+
+	//Parses an integer token. False if 'tok' is not an integer
+	static bool toInt(const std::string & tok, int & v);
+
+};
+
+#endif
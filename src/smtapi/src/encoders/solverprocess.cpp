@@ -0,0 +1,187 @@
+#include "solverprocess.h"
+#include "errors.h"
+#include <cstdlib>
+#include <cstring>
+#include <cerrno>
+#include <csignal>
+#include <unistd.h>
+#include <fcntl.h>
+#include <sys/wait.h>
+
+
+FdOutBuf::FdOutBuf(int fd){
+	this->fd = fd;
+	this->failed = false;
+	setp(buffer,buffer+BUFFERSIZE);
+}
+
+FdOutBuf::~FdOutBuf(){
+	sync();
+}
+
+bool FdOutBuf::flushBuffer(){
+	const char * p = pbase();
+	int n = pptr() - pbase();
+	while(n > 0 && !failed){
+		ssize_t w = write(fd,p,n);
+		if(w < 0){
+			if(errno == EINTR)
+				continue;
+			failed = true; //The solver closed its input, the rest is discarded
+		}
+		else{
+			p += w;
+			n -= w;
+		}
+	}
+	setp(buffer,buffer+BUFFERSIZE);
+	return !failed;
+}
+
+int FdOutBuf::overflow(int c){
+	if(!flushBuffer())
+		return EOF;
+	if(c != EOF){
+		*pptr() = c;
+		pbump(1);
+	}
+	return c == EOF ? 0 : c;
+}
+
+int FdOutBuf::sync(){
+	return flushBuffer() ? 0 : -1;
+}
+
+
+SolverProcess::SolverProcess(){
+	pid = -1;
+	infd = -1;
+	out = NULL;
+	inbuf = NULL;
+	in = NULL;
+}
+
+SolverProcess::~SolverProcess(){
+	if(pid > 0)
+		wait();
+	else if(!workingfile.empty())
+		remove(workingfile.c_str());
+}
+
+std::string SolverProcess::createUniqueFile(const std::string & prefix, const std::string & suffix){
+	std::string s = prefix + "XXXXXX" + suffix;
+	std::vector<char> name(s.begin(),s.end());
+	name.push_back('\0');
+
+	int fd = mkstemps(name.data(),suffix.size());
+	if(fd < 0){
+		std::cerr << "Error: could not create temporary working file: " << s << std::endl;
+		exit(BADFILE_ERROR);
+	}
+	close(fd);
+	return std::string(name.data());
+}
+
+void SolverProcess::setWorkingFile(const std::string & filename){
+	workingfile = filename;
+}
+
+void SolverProcess::start(const std::vector<std::string> & args, bool pipeinput){
+	int inpipe[2];
+	int outpipe[2];
+
+	//The child of a multithreaded process may only make async-signal-safe calls,
+	//so everything it needs is prepared before the fork
+	std::vector<char *> argv;
+	for(const std::string & a : args)
+		argv.push_back(const_cast<char *>(a.c_str()));
+	argv.push_back(NULL);
+	std::string execerror = "Error: could not execute the solver " + args[0] + "\n";
+
+	//Close-on-exec, so that solvers launched concurrently do not inherit each other's pipes
+	if((pipeinput && pipe2(inpipe,O_CLOEXEC) < 0) || pipe2(outpipe,O_CLOEXEC) < 0){
+		std::cerr << "Error: could not create pipes to the solver" << std::endl;
+		exit(SOLVING_ERROR);
+	}
+
+	pid = fork();
+	if(pid < 0){
+		std::cerr << "Error: could not launch the solver " << args[0] << std::endl;
+		exit(SOLVING_ERROR);
+	}
+
+	//The pipes are close-on-exec, only their duplicates survive the exec
+	if(pid == 0){
+		if(pipeinput)
+			dup2(inpipe[0],STDIN_FILENO);
+		dup2(outpipe[1],STDOUT_FILENO);
+
+		execvp(argv[0],argv.data());
+		ssize_t ignored = write(STDERR_FILENO,execerror.data(),execerror.size());
+		(void)ignored;
+		_exit(127);
+	}
+
+	if(pipeinput){
+		close(inpipe[0]);
+		infd = inpipe[1];
+		inbuf = new FdOutBuf(infd);
+		in = new std::ostream(inbuf);
+	}
+	close(outpipe[1]);
+	out = fdopen(outpipe[0],"r");
+}
+
+std::ostream & SolverProcess::input(){
+	return *in;
+}
+
+void SolverProcess::closeInput(){
+	if(in != NULL){
+		in->flush();
+		delete in;
+		delete inbuf;
+		in = NULL;
+		inbuf = NULL;
+		close(infd);
+		infd = -1;
+	}
+}
+
+FILE * SolverProcess::output(){
+	return out;
+}
+
+int SolverProcess::wait(){
+	closeInput();
+
+	if(out != NULL){
+		//Drain the output so that the solver never blocks on a full pipe
+		char buffer[4096];
+		while(fread(buffer,1,sizeof(buffer),out) > 0);
+		fclose(out);
+		out = NULL;
+	}
+
+	int status = -1;
+	if(pid > 0){
+		while(waitpid(pid,&status,0) < 0 && errno == EINTR);
+		pid = -1;
+	}
+
+	if(!workingfile.empty()){
+		remove(workingfile.c_str());
+		workingfile.clear();
+	}
+
+	return WIFEXITED(status) ? WEXITSTATUS(status) : -1;
+}
+
+pid_t SolverProcess::getPid() const{
+	return pid;
+}
+
+void SolverProcess::kill(){
+	if(pid > 0)
+		::kill(pid,SIGKILL);
+}
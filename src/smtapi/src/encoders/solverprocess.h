@@ -0,0 +1,99 @@
+#ifndef SOLVERPROCESS_DEFINITION
+#define SOLVERPROCESS_DEFINITION
+
+#include <cstdio>
+#include <string>
+#include <vector>
+#include <iostream>
+#include <sys/types.h>
+
+
+/*
+ * Output stream buffer over a raw file descriptor, used to stream
+ * formulas to the standard input of a solver without an intermediate file.
+ */
+class FdOutBuf : public std::streambuf {
+
+private:
+
+	static const int BUFFERSIZE = 1 << 16;
+
+	int fd;
+	char buffer[BUFFERSIZE];
+	bool failed;
+
+	bool flushBuffer();
+
+protected:
+
+	int overflow(int c);
+	int sync();
+
+public:
+
+	FdOutBuf(int fd);
+	~FdOutBuf();
+
+};
+
+
+/*
+ * External solver child process. The solver is executed directly
+ * (no shell), its standard output is available through output(),
+ * and the formula is either written to its standard input through
+ * input() or passed as a working file. Working files are created
+ * with mkstemp, so any number of processes can run concurrently
+ * in the same directory.
+ */
+class SolverProcess {
+
+private:
+
+	pid_t pid;
+	int infd;
+	FILE * out;
+
+	FdOutBuf * inbuf;
+	std::ostream * in;
+
+	std::string workingfile;
+
+public:
+
+	//Default constructor
+	SolverProcess();
+
+	//Destructor. Waits for the child if still running and removes the working file
+	~SolverProcess();
+
+	//Creates a new unique empty file named 'prefix'XXXXXX'suffix' and returns its path
+	static std::string createUniqueFile(const std::string & prefix, const std::string & suffix);
+
+	//Removes 'filename' when the process is waited for
+	void setWorkingFile(const std::string & filename);
+
+	//Launches args[0] (searched in PATH) with the given arguments.
+	//If 'pipeinput', the standard input of the solver is available through input()
+	void start(const std::vector<std::string> & args, bool pipeinput);
+
+	//Stream to the standard input of the solver
+	std::ostream & input();
+
+	//Closes the standard input of the solver, signaling the end of the formula
+	void closeInput();
+
+	//Standard output of the solver
+	FILE * output();
+
+	//Waits for the solver to finish and returns its exit status
+	int wait();
+
+	//Process id of the solver, -1 if not running
+	pid_t getPid() const;
+
+	//Kills the solver. Its output is closed, so readers get an end of stream
+	void kill();
+
+};
+
+#endif
@@ -14,6 +14,14 @@ void Encoding::setModel(const EncodedFormula & ef, int lb, int ub, const std::ve
 
 }
 
+bool Encoding::getModelVars(const EncodedFormula & ef, std::vector<int> & ivars, std::vector<int> & bvars) const{
+	return false;
+}
+
+bool Encoding::getPhase(const EncodedFormula & ef, std::vector<literal> & phase) const{
+	return false;
+}
+
 int Encoding::getObjective() const{
 	return INT_MIN;
 }
@@ -23,6 +31,10 @@ void Encoding::assumeBounds(const EncodedFormula & ef, int LB, int UB, std::vect
 	exit(SOLVING_ERROR);
 }
 
+bool Encoding::assumeUpperBound(const EncodedFormula & ef, int UB, std::vector<literal> & assumptions){
+	return false;
+}
+
 bool Encoding::narrowBounds(const EncodedFormula & ef, int lastLB, int lastUB, int lb, int ub){
 	return false;
 }
@@ -39,8 +39,20 @@ public:
 
 	virtual bool narrowBounds(const EncodedFormula & ef, int lastLB, int lastUB, int lb, int ub);
 	virtual void assumeBounds(const EncodedFormula & ef, int LB, int UB, std::vector<literal> & assumptions);
+
+	//Adds to 'assumptions' literals that hold in every solution with objective value at most 'UB',
+	//e.g. the time windows of the activities, so that a core over them proves a lower bound.
+	//False if not supported
+	virtual bool assumeUpperBound(const EncodedFormula & ef, int UB, std::vector<literal> & assumptions);
 	virtual void setModel(const EncodedFormula & ef, int lb, int ub, const std::vector<bool> & bmodel, const std::vector<int> & imodel);
 
+	//Literals that determine the best known solution, to be preferred by the decisions of the solver.
+	//False if no solution is known
+	virtual bool getPhase(const EncodedFormula & ef, std::vector<literal> & phase) const;
+
+	//Ids of the Int/Boolean variables read by setModel. False if all of them are needed
+	virtual bool getModelVars(const EncodedFormula & ef, std::vector<int> & ivars, std::vector<int> & bvars) const;
+
 	virtual int getObjective() const;
 
 	virtual bool printSolution(std::ostream & os) const;
@@ -0,0 +1,220 @@
+#include "formulasimplifier.h"
+#include "errors.h"
+#include <iostream>
+#include <algorithm>
+
+using namespace smtapi;
+
+
+FormulaSimplifier::FormulaSimplifier(SMTFormula * f){
+	if(f->getType() != SATFORMULA){
+		std::cerr << "Only SAT formulas can be simplified" << std::endl;
+		exit(BADCODIFICATION_ERROR);
+	}
+
+	nvars = f->getNBoolVars();
+	value.resize(nvars+1,-1);
+	newid.resize(nvars+1,0);
+	simplified = NULL;
+	conflict = false;
+	nfixed = 0;
+	nremoved = 0;
+
+	//Clauses with repeated literals removed, and tautologies dropped
+	occs.resize(2*nvars+2);
+	for(const clause & c : f->getClauses()){
+		std::vector<int> ls;
+		for(const literal & l : c.v)
+			ls.push_back(l.sign ? l.v.id : -l.v.id);
+		std::sort(ls.begin(),ls.end());
+		ls.erase(std::unique(ls.begin(),ls.end()),ls.end());
+
+		bool taut = false;
+		for(int i = 0; i < ls.size() && !taut; i++)
+			taut = ls[i] < 0 && std::binary_search(ls.begin(),ls.end(),-ls[i]);
+		if(!taut){
+			for(int l : ls)
+				occurrences(l).push_back(cls.size());
+			cls.push_back(ls);
+		}
+	}
+	removed.resize(cls.size(),false);
+
+	conflict = !propagate();
+	if(!conflict){
+		removeSatisfiedAndDuplicates();
+		removeSubsumed();
+	}
+	buildFormula();
+	nremoved = f->getNClauses() - simplified->getNClauses();
+}
+
+FormulaSimplifier::~FormulaSimplifier(){
+	delete simplified;
+}
+
+std::vector<int> & FormulaSimplifier::occurrences(int l){
+	return occs[l > 0 ? 2*l : -2*l+1];
+}
+
+bool FormulaSimplifier::isTrue(int l) const{
+	return l > 0 ? value[l] == 1 : value[-l] == 0;
+}
+
+bool FormulaSimplifier::isFalse(int l) const{
+	return l > 0 ? value[l] == 0 : value[-l] == 1;
+}
+
+bool FormulaSimplifier::propagate(){
+	std::vector<int> units;
+	for(const std::vector<int> & c : cls){
+		if(c.empty())
+			return false;
+		if(c.size()==1)
+			units.push_back(c[0]);
+	}
+
+	for(int u = 0; u < units.size(); u++){
+		int l = units[u];
+		if(isTrue(l))
+			continue;
+		if(isFalse(l))
+			return false;
+		value[abs(l)] = l > 0 ? 1 : 0;
+		nfixed++;
+
+		//Only the clauses with the negation of 'l' can become unit
+		for(int i : occurrences(-l)){
+			int nfree = 0;
+			int free = 0;
+			bool sat = false;
+			for(int l2 : cls[i]){
+				if(isTrue(l2)){
+					sat = true;
+					break;
+				}
+				if(!isFalse(l2)){
+					nfree++;
+					free = l2;
+				}
+			}
+			if(sat)
+				continue;
+			if(nfree==0)
+				return false;
+			if(nfree==1)
+				units.push_back(free);
+		}
+	}
+	return true;
+}
+
+void FormulaSimplifier::removeSatisfiedAndDuplicates(){
+	//After a conflict-free propagation no clause is left empty
+	std::vector<int> order;
+	for(int i = 0; i < cls.size(); i++){
+		std::vector<int> & c = cls[i];
+		int n = 0;
+		for(int j = 0; j < c.size() && !removed[i]; j++){
+			if(isTrue(c[j]))
+				removed[i] = true;
+			else if(!isFalse(c[j]))
+				c[n++] = c[j];
+		}
+		if(!removed[i]){
+			c.resize(n);
+			order.push_back(i);
+		}
+	}
+
+	//Equal clauses end up adjacent, and the first one is kept
+	std::sort(order.begin(),order.end(),[&](int a, int b){
+		if(cls[a].size() != cls[b].size())
+			return cls[a].size() < cls[b].size();
+		if(cls[a] != cls[b])
+			return cls[a] < cls[b];
+		return a < b;
+	});
+	for(int i = 1; i < order.size(); i++)
+		if(cls[order[i]] == cls[order[i-1]])
+			removed[order[i]] = true;
+}
+
+void FormulaSimplifier::removeSubsumed(){
+	std::vector<int> order;
+	for(int i = 0; i < cls.size(); i++)
+		if(!removed[i] && cls[i].size() <= maxsubsumerlength)
+			order.push_back(i);
+	std::stable_sort(order.begin(),order.end(),[&](int a, int b){return cls[a].size() < cls[b].size();});
+
+	//Backward subsumption: the clauses containing a short clause are removed.
+	//Duplicates are already gone, so only longer clauses can be subsumed.
+	//The occurrence lists still have the satisfied clauses, which are skipped
+	for(int i : order){
+		if(removed[i])
+			continue;
+		const std::vector<int> * rarest = NULL;
+		for(int l : cls[i]){
+			const std::vector<int> & o = occurrences(l);
+			if(rarest == NULL || o.size() < rarest->size())
+				rarest = &o;
+		}
+		if(rarest->size() > maxsubsumptionoccs)
+			continue;
+		for(int j : *rarest)
+			if(!removed[j] && cls[j].size() > cls[i].size() &&
+				std::includes(cls[j].begin(),cls[j].end(),cls[i].begin(),cls[i].end()))
+				removed[j] = true;
+	}
+}
+
+void FormulaSimplifier::buildFormula(){
+	simplified = new SMTFormula();
+	if(conflict){
+		simplified->addEmptyClause();
+		return;
+	}
+
+	//Remaining variables renumbered in their original order
+	for(int i = 0; i < cls.size(); i++)
+		if(!removed[i])
+			for(int l : cls[i])
+				newid[abs(l)] = 1;
+	for(int v = 1; v <= nvars; v++)
+		if(newid[v])
+			newid[v] = simplified->newBoolVar().id;
+
+	for(int i = 0; i < cls.size(); i++){
+		if(removed[i])
+			continue;
+		clause c;
+		for(int l : cls[i]){
+			boolvar x;
+			x.id = newid[abs(l)];
+			c.v.push_back(l > 0 ? literal(x) : !literal(x));
+		}
+		simplified->addClause(c);
+	}
+}
+
+SMTFormula * FormulaSimplifier::getFormula() const{
+	return simplified;
+}
+
+void FormulaSimplifier::recoverModel(const std::vector<bool> & model, std::vector<bool> & original) const{
+	original.assign(nvars+1,false);
+	for(int v = 1; v <= nvars; v++){
+		if(value[v] != -1)
+			original[v] = value[v] == 1;
+		else if(newid[v] != 0 && newid[v] < model.size())
+			original[v] = model[newid[v]];
+	}
+}
+
+int FormulaSimplifier::getNFixedVars() const{
+	return nfixed;
+}
+
+int FormulaSimplifier::getNRemovedClauses() const{
+	return nremoved;
+}
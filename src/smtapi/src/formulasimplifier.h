@@ -0,0 +1,82 @@
+#ifndef FORMULASIMPLIFIER_DEFINITION
+#define FORMULASIMPLIFIER_DEFINITION
+
+#include <vector>
+#include "smtformula.h"
+
+
+namespace smtapi{
+
+/*
+ * Simplification of the hard clauses of a SAT formula before writing it.
+ * It propagates the unit clauses (among them the ones of trueVar() and
+ * falseVar()), removes the satisfied clauses and the false literals, the
+ * repeated literals, the tautologies and the duplicated clauses, and the
+ * clauses subsumed by short clauses whose rarest literal does not occur
+ * too often. The remaining variables are renumbered consecutively, and a
+ * model of the simplified formula is mapped back to the original variables.
+ * If the propagation finds a conflict, the simplified formula only contains
+ * the empty clause.
+ */
+class FormulaSimplifier{
+
+private:
+
+	int nvars; //Number of variables of the original formula
+	std::vector<int> value; //Value fixed by propagation of each original variable: 1, 0 or -1 if not fixed
+	std::vector<int> newid; //New id of each original variable, 0 if it does not occur in the simplified formula
+	SMTFormula * simplified;
+
+	bool conflict;
+	int nfixed;
+	int nremoved;
+
+	//Clauses as signed variable ids, and those already discarded
+	std::vector<std::vector<int> > cls;
+	std::vector<bool> removed;
+
+	//Clauses of each literal, at position 2*var for the positive one and 2*var+1 for the negative one
+	std::vector<std::vector<int> > occs;
+	std::vector<int> & occurrences(int l);
+
+	bool isTrue(int l) const;
+	bool isFalse(int l) const;
+
+	//Propagates the unit clauses. Returns false on conflict
+	bool propagate();
+
+	void removeSatisfiedAndDuplicates();
+
+	void removeSubsumed();
+
+	void buildFormula();
+
+public:
+
+	//Longest clauses checked as subsumers, and largest occurrence list scanned for each of them
+	static const int maxsubsumerlength = 4;
+	static const int maxsubsumptionoccs = 1000;
+
+	//Simplifies the hard clauses of 'f', which must be a SAT formula
+	FormulaSimplifier(SMTFormula * f);
+
+	~FormulaSimplifier();
+
+	//Simplified formula, owned by the simplifier
+	SMTFormula * getFormula() const;
+
+	//Assignment of the original variables (indexed by id) from a model of the simplified formula.
+	//Variables that no longer occur are given their propagated value, or false
+	void recoverModel(const std::vector<bool> & model, std::vector<bool> & original) const;
+
+	//Number of variables fixed by propagation
+	int getNFixedVars() const;
+
+	//Number of original clauses not in the simplified formula
+	int getNRemovedClauses() const;
+
+};
+
+}
+
+#endif
@@ -14,6 +14,7 @@ int BUOptimizer::maximize(Encoder * e, int lb, int ub, bool useAssumptions, bool
 	int obj_val;
 	int lastlb=lb;
 
+	interrupted = false;
 	while(satcheck && ub >= lb){
 
 		if(beforeSatisfiabilityCall)
@@ -24,6 +25,9 @@ int BUOptimizer::maximize(Encoder * e, int lb, int ub, bool useAssumptions, bool
 		if(afterSatisfiabilityCall)
 			afterSatisfiabilityCall(lb, ub,e);
 
+		if(e->timedOut())
+			return issat ? stopOnBudget(lastlb,ub,lastlb) : stopOnBudget(lb,ub,INT_MIN);
+
 		if(!issat)
 			issat = satcheck;
 
@@ -71,6 +75,8 @@ int BUOptimizer::minimize(Encoder * e, int lb, int ub, bool useAssumptions, bool
 	int obj_val;
 	int checkub=lb;
 
+	interrupted = false;
+	useAssumptions = useAssumptions && e->supportsAssumptions();
 	if(useAssumptions)
 		e->initAssumptionOptimization(lb,ub);
 
@@ -85,6 +91,9 @@ int BUOptimizer::minimize(Encoder * e, int lb, int ub, bool useAssumptions, bool
 		if(afterSatisfiabilityCall)
 			afterSatisfiabilityCall(checkub, checkub,e);
 
+		if(e->timedOut())
+			return stopOnBudget(checkub,ub,INT_MIN);
+
 		if(satcheck){
 			if(onNewBoundsProved)
 				onNewBoundsProved(checkub,checkub);
@@ -0,0 +1,69 @@
+#include "coreoptimizer.h"
+#include "errors.h"
+#include <iostream>
+
+
+CoreOptimizer::CoreOptimizer() : Optimizer(){
+
+}
+
+int CoreOptimizer::minimize(Encoder * e, int lb, int ub, bool useAssumptions, bool narrowBounds)
+{
+
+	bool satcheck = false;
+	int checkub=lb;
+	int corelb;
+
+	interrupted = false;
+	useAssumptions = useAssumptions && e->supportsAssumptions();
+	if(useAssumptions)
+		e->initAssumptionOptimization(lb,ub);
+
+	while(!satcheck && checkub <= ub){
+		if(beforeSatisfiabilityCall)
+			beforeSatisfiabilityCall(checkub, checkub);
+
+		corelb = checkub+1;
+		satcheck = useAssumptions ?
+				e->checkSATAssumingCore(checkub,checkub,ub,corelb):
+				e->checkSAT(checkub,checkub);
+
+		if(afterSatisfiabilityCall)
+			afterSatisfiabilityCall(checkub, checkub,e);
+
+		if(e->timedOut())
+			return stopOnBudget(checkub,ub,INT_MIN);
+
+		if(satcheck){
+			if(onNewBoundsProved)
+				onNewBoundsProved(checkub,checkub);
+			if(onSATSolutionFound)
+				onSATSolutionFound(checkub,checkub,checkub);
+		}
+		else{
+			if(narrowBounds && useAssumptions)
+				e->narrowBounds(corelb,ub);
+			if(onNewBoundsProved)
+				onNewBoundsProved(corelb,ub);
+			if(onUNSATBoundsDetermined)
+				onUNSATBoundsDetermined(checkub,checkub);
+			checkub = corelb;
+		}
+	}
+	if(satcheck){
+		if(onProvedOptimum)
+			onProvedOptimum(checkub);
+		return checkub;
+	}
+	else{
+		if(onProvedUNSAT)
+			onProvedUNSAT();
+		return INT_MIN;
+	}
+}
+
+
+
+CoreOptimizer::~CoreOptimizer() {
+
+}
@@ -0,0 +1,24 @@
+#ifndef COREOPTIMIZER_DEFINITION
+#define COREOPTIMIZER_DEFINITION
+
+#include "optimizer.h"
+
+
+/*
+ * Bottom-up minimization that jumps over the lower bounds proved by the
+ * failed assumptions of each unsatisfiable check, instead of increasing
+ * the bound by one. Without assumptions it behaves as BUOptimizer.
+ */
+class CoreOptimizer : public Optimizer{
+
+public:
+
+	CoreOptimizer();
+
+	~CoreOptimizer();
+
+	int minimize(Encoder * e, int LB, int UB, bool useAssumptions=false, bool narrowBounds=false);
+
+};
+
+#endif
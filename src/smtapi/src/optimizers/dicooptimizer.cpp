@@ -17,22 +17,40 @@ int DicoOptimizer::minimize(Encoder * e, int lb, int ub, bool useAssumptions, bo
 	int lastval=ub;
 
 	int checkbound;
+	int corelb;
 
+	//Maximum distance of the probes to the incumbent, shrunk by timed out probes
+	int maxstep = INT_MAX;
+
+	interrupted = false;
+	useAssumptions = useAssumptions && e->supportsAssumptions();
 	if(useAssumptions)
 		e->initAssumptionOptimization(lb,ub);
 
 	while(ub > lb | !satverified){
 		checkbound = (ub + lb)/2;
+		if(ub - checkbound > maxstep)
+			checkbound = ub - maxstep;
 		if(beforeSatisfiabilityCall)
 			beforeSatisfiabilityCall(lb, checkbound);
 
+		//The core of an unsatisfiable check may prove any bound below the incumbent
+		corelb = checkbound+1;
 		satcheck = useAssumptions ?
-					e->checkSATAssuming(lb,checkbound):
+					e->checkSATAssumingCore(lb,checkbound,satverified ? ub-1 : ub,corelb):
 					e->checkSAT(lb,checkbound);
 
 		if(afterSatisfiabilityCall)
 			afterSatisfiabilityCall(lb, checkbound,e);
 
+		if(e->timedOut()){
+			//Retry closer to the incumbent, down to a linear search
+			if(e->budgetExhausted() || ub - checkbound <= 1)
+				return issat ? stopOnBudget(lb,lastval,lastval) : stopOnBudget(lb,ub,INT_MIN);
+			maxstep = (ub - checkbound)/2;
+			continue;
+		}
+
 		if(!issat)
 			issat = satcheck;
 
@@ -56,16 +74,16 @@ int DicoOptimizer::minimize(Encoder * e, int lb, int ub, bool useAssumptions, bo
 			ub = obj_val;
 		}
 		else{
-			if(lb == firstub)
+			if(corelb > firstub)
 				satverified = true;
 
 			if(narrowBounds && useAssumptions)
-				e->narrowBounds(checkbound+1,ub);
+				e->narrowBounds(corelb,ub);
 
-			if(onNewBoundsProved) onNewBoundsProved(checkbound+1,ub);
+			if(onNewBoundsProved) onNewBoundsProved(corelb,ub);
 			if(onUNSATBoundsDetermined) onUNSATBoundsDetermined(lb,checkbound);
 
-			lb = checkbound+1;
+			lb = corelb;
 		}
 	}
 
@@ -93,11 +111,18 @@ int DicoOptimizer::maximize(Encoder * e, int lb, int ub, bool useAssumptions, bo
 
 	int checkbound;
 
+	//Maximum distance of the probes to the incumbent, shrunk by timed out probes
+	int maxstep = INT_MAX;
+
+	interrupted = false;
+	useAssumptions = useAssumptions && e->supportsAssumptions();
 	if(useAssumptions)
 		e->initAssumptionOptimization(lb,ub);
 
 	while(ub > lb | !satverified){
 		checkbound = (ub + lb + 1)/2;
+		if(checkbound - lb > maxstep)
+			checkbound = lb + maxstep;
 		if(beforeSatisfiabilityCall)
 			beforeSatisfiabilityCall(checkbound,ub);
 
@@ -108,6 +133,14 @@ int DicoOptimizer::maximize(Encoder * e, int lb, int ub, bool useAssumptions, bo
 		if(afterSatisfiabilityCall)
 			afterSatisfiabilityCall(checkbound,ub,e);
 
+		if(e->timedOut()){
+			//Retry closer to the incumbent, down to an upwards linear search
+			if(e->budgetExhausted() || checkbound - lb <= 1)
+				return issat ? stopOnBudget(lastval,ub,lastval) : stopOnBudget(lb,ub,INT_MIN);
+			maxstep = (checkbound - lb)/2;
+			continue;
+		}
+
 		if(!issat)
 			issat = satcheck;
 
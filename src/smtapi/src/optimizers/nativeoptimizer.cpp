@@ -12,11 +12,15 @@ int NativeOptimizer::minimize(Encoder * e, int lb, int ub, bool useAssumptions,
 	if(beforeNativeOptimizationCall)
 			beforeNativeOptimizationCall(lb, ub);
 
+	interrupted = false;
 	bool issat = e->optimize(lb,ub);
 
 	if(afterNativeOptimizationCall)
 			afterNativeOptimizationCall(lb, ub,e);
 
+	if(e->timedOut())
+		return stopOnBudget(lb,ub,INT_MIN);
+
 	if(issat){
 		int obj = e->getObjective();
 		if(obj==INT_MIN){
@@ -43,11 +47,15 @@ int NativeOptimizer::maximize(Encoder * e, int lb, int ub, bool useAssumptions,
 	if(beforeNativeOptimizationCall)
 			beforeNativeOptimizationCall(lb, ub);
 
+	interrupted = false;
 	bool issat = e->optimize(lb,ub);
 
 	if(afterNativeOptimizationCall)
 			afterNativeOptimizationCall(lb, ub,e);
 
+	if(e->timedOut())
+		return stopOnBudget(lb,ub,INT_MIN);
+
 	if(issat){
 		int obj = e->getObjective();
 		if(obj==INT_MIN){
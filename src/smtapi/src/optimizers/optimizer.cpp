@@ -14,6 +14,8 @@ Optimizer::Optimizer() {
 	onProvedOptimum = NULL;
 	onProvedSAT = NULL;
 	onProvedUNSAT = NULL;
+	onBudgetExhausted = NULL;
+	interrupted = false;
 }
 
 Optimizer::~Optimizer() {
@@ -30,6 +32,12 @@ bool Optimizer::checkSAT(Encoder * e, int lb, int ub){
 	if(afterSatisfiabilityCall != NULL)
 		afterSatisfiabilityCall(lb, ub,e);
 
+	interrupted = e->timedOut();
+	if(interrupted){
+		stopOnBudget(lb,ub,INT_MIN);
+		return false;
+	}
+
 
 	if(satcheck){
 		int obj;
@@ -94,3 +102,18 @@ void Optimizer::setOnProvedSAT(std::function<void()> callback_func){
 void Optimizer::setOnProvedUNSAT(std::function<void()> callback_func){
 	onProvedUNSAT=callback_func;
 }
+
+void Optimizer::setOnBudgetExhausted(std::function<void(int lb, int ub, int obj_val)> callback_func){
+	onBudgetExhausted=callback_func;
+}
+
+bool Optimizer::isInterrupted() const{
+	return interrupted;
+}
+
+int Optimizer::stopOnBudget(int lb, int ub, int obj_val){
+	interrupted = true;
+	if(onBudgetExhausted != NULL)
+		onBudgetExhausted(lb,ub,obj_val);
+	return obj_val;
+}
@@ -18,6 +18,13 @@ protected :
 	std::function<void(int opt)> onProvedOptimum;
 	std::function<void()> onProvedSAT;
 	std::function<void()> onProvedUNSAT;
+	std::function<void(int lb, int ub, int obj_val)> onBudgetExhausted;
+
+	bool interrupted;
+
+	//Stops the optimization after an interrupted probe: flags it and reports the proved
+	//bounds and the best objective value found (INT_MIN if none). Returns 'obj_val'
+	int stopOnBudget(int lb, int ub, int obj_val);
 
 public:
 
@@ -41,6 +48,11 @@ public:
 	void setOnProvedOptimum(std::function<void(int opt)> callback_func);
 	void setOnProvedSAT(std::function<void()> callback_func);
 	void setOnProvedUNSAT(std::function<void()> callback_func);
+	void setOnBudgetExhausted(std::function<void(int lb, int ub, int obj_val)> callback_func);
+
+	//True if the last optimization was stopped by a timed out or cancelled probe,
+	//and hence its result is the best value found rather than a proved optimum
+	bool isInterrupted() const;
 
 
 };
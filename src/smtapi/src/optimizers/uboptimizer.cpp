@@ -14,6 +14,8 @@ int UBOptimizer::maximize(Encoder * e, int lb, int ub, bool useAssumptions, bool
 	int obj_val;
 	int checklb=ub;
 
+	interrupted = false;
+	useAssumptions = useAssumptions && e->supportsAssumptions();
 	if(useAssumptions)
 		e->initAssumptionOptimization(lb,ub);
 
@@ -28,6 +30,9 @@ int UBOptimizer::maximize(Encoder * e, int lb, int ub, bool useAssumptions, bool
 		if(afterSatisfiabilityCall)
 			afterSatisfiabilityCall(checklb, ub,e);
 
+		if(e->timedOut())
+			return stopOnBudget(lb,ub,INT_MIN);
+
 		if(satcheck){
 			if(onNewBoundsProved) onNewBoundsProved(checklb,ub);
 			if(onSATSolutionFound) onSATSolutionFound(checklb,ub,checklb);
@@ -61,18 +66,26 @@ int UBOptimizer::minimize(Encoder * e, int lb, int ub, bool useAssumptions, bool
 	int obj_val;
 	int lastub=ub;
 
-
+	interrupted = false;
+	useAssumptions = useAssumptions && e->supportsAssumptions();
+	if(useAssumptions)
+		e->initAssumptionOptimization(lb,ub);
 
 	while(satcheck && ub >= lb){
 
 		if(beforeSatisfiabilityCall)
 			beforeSatisfiabilityCall(lb, ub);
 
-		satcheck = e->checkSAT(lb,ub);
+		satcheck = useAssumptions ?
+					e->checkSATAssuming(lb,ub):
+					e->checkSAT(lb,ub);
 
 		if(afterSatisfiabilityCall)
 			afterSatisfiabilityCall(lb, ub,e);
 
+		if(e->timedOut())
+			return issat ? stopOnBudget(lb,lastub,lastub) : stopOnBudget(lb,ub,INT_MIN);
+
 		if(!issat)
 			issat = satcheck;
 
@@ -89,6 +102,8 @@ int UBOptimizer::minimize(Encoder * e, int lb, int ub, bool useAssumptions, bool
 
 			lastub = obj_val;
 			ub=obj_val-1;
+			if(narrowBounds && useAssumptions && ub >= lb)
+				e->narrowBounds(lb,ub);
 		}
 		else{
 			if(onNewBoundsProved && issat) onNewBoundsProved(ub+1,lastub);
@@ -116,22 +116,26 @@ struct literal{
 	bool arith; //true if (in)equality, false if boolvar
 	boolvar v; //boolvar, only considered if arith==false
 	arithcmp cmp; //(in)equality, only considered if arith=true
-	literal(){}
+	int atom; //Id of 'cmp' among the atoms of the formula, 0 if not interned
+	literal(){atom=0;}
 	literal(const literal & l){
 			this->sign = l.sign;
 			this->arith = l.arith;
 			this->v = l.v;
 			this->cmp = l.cmp;
+			this->atom = l.atom;
 	}
 	literal(const boolvar &var){
 		sign=true;
 		arith=false;
 		v=var;
+		atom=0;
 	}
 	literal(const arithcmp &c){
 		sign=true;
 		arith=true;
 		cmp=c;
+		atom=0;
 	}
 };
 
@@ -157,6 +161,13 @@ struct clause{
 	}
 };
 
+//AMO-PB constraint sum(Q[i][j]*X[i][j]) <= K, where at most one literal of each group X[i] is true
+struct amopb{
+	std::vector<std::vector<int> > Q;
+	std::vector<std::vector<literal> > X;
+	int K;
+};
+
 intprod operator*(const intvar &v,int coef);
 intprod operator*(int coef, const intvar &v);
 intsum operator-(const intsum &e);
@@ -4,6 +4,8 @@
 #include "mdd.h"
 #include "errors.h"
 #include "util.h"
+#include "valueset.h"
+#include "amopbcost.h"
 #include <limits>
 #include <algorithm>
 #include <math.h>
@@ -36,6 +38,8 @@ SMTFormula::SMTFormula() {
 	nIntVars=0;
 	nClauses=0;
 
+	atoms.push_back(arithcmp());
+	atomOccurrences.push_back(0);
 	boolVarNames.push_back("");
 	intVarNames.push_back("");
 	declareVar.push_back(false);
@@ -123,6 +127,18 @@ int SMTFormula::getNClauses() const{
 	return clauses.size();
 }
 
+int SMTFormula::getNAtoms() const{
+	return atoms.size()-1;
+}
+
+const std::vector<arithcmp> & SMTFormula::getAtoms() const{
+	return atoms;
+}
+
+int SMTFormula::getAtomOccurrences(int id) const{
+	return atomOccurrences[id];
+}
+
 int SMTFormula::getNSoftClauses() const{
 	return softclauses.size();
 }
@@ -131,6 +147,32 @@ const std::vector<clause> & SMTFormula::getClauses() const{
 	return clauses;
 }
 
+int SMTFormula::getNLazyAMOPBs() const{
+	return lazyamopbs.size();
+}
+
+const std::vector<amopb> & SMTFormula::getLazyAMOPBs() const{
+	return lazyamopbs;
+}
+
+const std::map<AMOPBEncoding,AMOPBSize> & SMTFormula::getAMOPBPredictions() const{
+	return amopbpredictions;
+}
+
+const std::map<AMOPBEncoding,int> & SMTFormula::getAMOPBChoices() const{
+	return amopbchoices;
+}
+
+void SMTFormula::addAMOPBPrediction(AMOPBSize & total, const AMOPBSize & size) const{
+	total.vars += size.vars;
+	total.clauses += size.clauses;
+	if(size.truevar && !total.truevar && truevar.id==0){
+		total.vars++;
+		total.clauses++;
+		total.truevar = true;
+	}
+}
+
 const std::vector<clause> & SMTFormula::getSoftClauses() const{
 	return softclauses;
 }
@@ -404,23 +446,87 @@ void SMTFormula::addEmptyClause(){
 
 void SMTFormula::addClause(const clause &c) {
 	clauses.push_back(c);
+	internAtoms(clauses.back());
 }
 
 void SMTFormula::addSoftClause(const clause &c, int weight) {
 	softclauses.push_back(c);
+	internAtoms(softclauses.back());
 	weights.push_back(weight);
 	softclausevars.push_back(intvar());
 }
 
 void SMTFormula::addSoftClauseWithVar(const clause &c, int weight, const intvar & var) {
 	softclauses.push_back(c);
+	internAtoms(softclauses.back());
 	weights.push_back(weight);
 	softclausevars.push_back(var);
 	hassoftclauseswithvars = true;
 }
 
 void SMTFormula::addClauses(const std::vector<clause> &c) {
+	int first = clauses.size();
 	clauses.insert(clauses.end(),c.begin(),c.end());
+	for(int i = first; i < clauses.size(); i++)
+		internAtoms(clauses[i]);
+}
+
+void SMTFormula::internAtoms(clause & c){
+	for(literal & l : c.v)
+		if(l.arith && l.atom == 0)
+			internAtom(l);
+}
+
+void SMTFormula::internAtom(literal & l){
+	arithcmp & cmp = l.cmp;
+
+	//Sort the products by variable, merging repeated variables and dropping null coefficients
+	std::map<int,int> coefs;
+	for(const intprod & p : cmp.s.v)
+		coefs[p.varid] += p.coef;
+
+	std::vector<intprod> prods;
+	for(const std::pair<const int,int> & c : coefs){
+		if(c.second != 0){
+			intprod p;
+			p.varid = c.first;
+			p.coef = c.second;
+			prods.push_back(p);
+		}
+	}
+
+	//sum <= k  <=>  !(-sum <= -k-1), and sum == k  <=>  -sum == -k
+	if(!prods.empty() && prods[0].coef < 0){
+		for(intprod & p : prods)
+			p.coef = -p.coef;
+		if(cmp.eq)
+			cmp.k = -cmp.k;
+		else{
+			cmp.k = -cmp.k-1;
+			l.sign = !l.sign;
+		}
+	}
+	cmp.s.v = prods;
+
+	std::vector<int> key;
+	key.reserve(2*prods.size()+2);
+	key.push_back(cmp.eq);
+	key.push_back(cmp.k);
+	for(const intprod & p : prods){
+		key.push_back(p.varid);
+		key.push_back(p.coef);
+	}
+
+	std::map<std::vector<int>,int>::iterator it = mapAtoms.find(key);
+	if(it != mapAtoms.end())
+		l.atom = it->second;
+	else{
+		l.atom = atoms.size();
+		atoms.push_back(cmp);
+		atomOccurrences.push_back(0);
+		mapAtoms[key] = l.atom;
+	}
+	atomOccurrences[l.atom]++;
 }
 
 void SMTFormula::addALO(const std::vector<literal> & v) {
@@ -928,6 +1034,20 @@ void SMTFormula::addAMOPB(const std::vector<std::vector<int> > & Q, const std::v
 	if(N==1) //We have enforced that no AMO group contains a coefficient greater than K
 		return;
 
+	if(encoding==AMOPB_AUTO || encoding==AMOPB_DRYRUN){
+		AMOPBSize size;
+		AMOPBEncoding chosen = AMOPBCost::select(Q2,K,size);
+		amopbchoices[chosen]++;
+		if(encoding==AMOPB_AUTO)
+			encoding = chosen;
+		else{
+			addAMOPBPrediction(amopbpredictions[AMOPB_AUTO],size);
+			for(AMOPBEncoding enc : AMOPBCost::getPredictedEncodings())
+				addAMOPBPrediction(amopbpredictions[enc],AMOPBCost::predict(Q2,K,enc));
+			return;
+		}
+	}
+
 
 	switch(encoding){
 		case AMOPB_AMOMDD:
@@ -1018,6 +1138,16 @@ void SMTFormula::addAMOPB(const std::vector<std::vector<int> > & Q, const std::v
 			addAMOPBGlobalPolynomialWatchdog(Q2,X2,K,false);
 			break;
 
+		case AMOPB_LAZY:
+		{
+			amopb c;
+			c.Q = Q2;
+			c.X = X2;
+			c.K = K;
+			lazyamopbs.push_back(c);
+		}
+			break;
+
 		default:
 			std::cerr << "Wrong kind of AMOPB encoding" << std::endl;
 			exit(SOLVING_ERROR);
@@ -1287,15 +1417,14 @@ void SMTFormula::addAMOPBGeneralizedTotalizer(const std::vector<std::vector<int>
 
 	int n = X.size();
 
-	std::vector<int> * tree = new std::vector<int>[2*n-1];
-	std::vector<literal> * treevars = new std::vector<literal> [2*n-1];
-	std::map<int,literal> * treevarsmap = new std::map<int,literal> [n-1];
+	//Sets of values of the nodes, and the same values in the order of their variables
+	std::vector<ValueSet> tree(2*n-1,ValueSet(K+1));
+	std::vector<std::vector<int> > treevalues(2*n-1);
+	std::vector<std::vector<literal> > treevars(2*n-1);
 
 	//Fill tree nodes with coefficients
 	for(int i = 0; i < n; i++){
 		int idx = n-1+i;
-		tree[idx].clear();
-		treevars[idx].clear();
 		std::map<int,int> count;
 		std::map<int,literal> lit;
 		for(int j = 0; j < Q[i].size(); j++){
@@ -1318,51 +1447,51 @@ void SMTFormula::addAMOPBGeneralizedTotalizer(const std::vector<std::vector<int>
 			}
 		}
 		for(const std::pair<int,literal> & p : lit){
-			tree[idx].push_back(p.first);
+			tree[idx].insert(p.first);
+			treevalues[idx].push_back(p.first);
 			treevars[idx].push_back(p.second);
 		}
-		tree[idx].push_back(0);
+		tree[idx].insert(0);
+		treevalues[idx].push_back(0);
 	}
 
 	for(int i = n-2; i >= 0; i--){
-		tree[i].clear();
-		for(int j = 0; j < tree[lchild(i)].size(); j++){
-			for(int k = 0; k < tree[rchild(i)].size(); k++){
-				int x = std::min(tree[lchild(i)][j]+tree[rchild(i)][k],K+1);
-				util::insertSortedIfNotExists(tree[i],x);
-			}
-		}
+		tree[i].sum(tree[lchild(i)],tree[rchild(i)]);
+		tree[i].getValues(treevalues[i],true);
 	}
 
 	//Simplify the root
-	if(tree[0][0] <= K)
+	if(treevalues[0][0] <= K)
 		return;
 
-	tree[0].resize(2);
-	tree[0][1]=0;
+	treevalues[0].resize(2);
+	treevalues[0][1]=0;
+	tree[0].clear();
+	tree[0].insert(treevalues[0][0]);
+	tree[0].insert(0);
 
-	//Encode the tree
+	//Encode the tree. The values of internal nodes are decreasing, so the variable
+	//of value x is the one at position size-1-rank(x). Value 0 has no variable
 	for(int i = n-2; i >= 0; i--){
-		for(int j = 0; j < tree[i].size()-1; j++){
-			boolvar v = newBoolVar();
-			treevars[i].push_back(v);
-			treevarsmap[i][tree[i][j]] = v;
-		}
+		for(int j = 0; j < treevalues[i].size()-1; j++)
+			treevars[i].push_back(newBoolVar());
+		int nvals = treevalues[i].size();
 		int l = lchild(i);
 		int r = rchild(i);
-
-		for(int j = 0; j < tree[l].size(); j++){
-			for(int k = 0; k < tree[r].size(); k++){
-				int x = std::min(tree[l][j]+tree[r][k],K+1);
-				if(treevarsmap[i].find(x) != treevarsmap[i].end()){
-					if(j<tree[l].size()-1 || k < tree[r].size()-1){
-						if(j == tree[l].size()-1)
-							addClause(!treevars[r][k] | treevarsmap[i][x]);
-						else if(k == tree[r].size()-1)
-							addClause(!treevars[l][j] | treevarsmap[i][x]);
-						else
-							addClause(!treevars[l][j] | !treevars[r][k] | treevarsmap[i][x]);
-					}
+		const std::vector<int> & lvals = treevalues[l];
+		const std::vector<int> & rvals = treevalues[r];
+
+		for(int j = 0; j < lvals.size(); j++){
+			for(int k = 0; k < rvals.size(); k++){
+				int x = std::min(lvals[j]+rvals[k],K+1);
+				if(x != 0 && tree[i].contains(x)){
+					literal v = treevars[i][nvals-1-tree[i].rank(x)];
+					if(j == lvals.size()-1)
+						addClause(!treevars[r][k] | v);
+					else if(k == rvals.size()-1)
+						addClause(!treevars[l][j] | v);
+					else
+						addClause(!treevars[l][j] | !treevars[r][k] | v);
 				}
 			}
 		}
@@ -1370,12 +1499,8 @@ void SMTFormula::addAMOPBGeneralizedTotalizer(const std::vector<std::vector<int>
 
 
 	//Negate that the sum is greater than K
-	if(!tree[0].empty())
+	if(!treevalues[0].empty())
 		addClause(!treevars[0][0]);
-
-	delete [] tree;
-	delete [] treevars;
-	delete [] treevarsmap;
 }
 
 
@@ -1386,8 +1511,24 @@ void SMTFormula::addAMOPBModuloTotalizer(const std::vector<std::vector<int> > &
 	std::vector<int> moduli;
 	baseSelectionMTO(Q,K,moduli);
 
+	//Bound of the uppermost digit: its value at the leaves plus one carry per inner node
+	int modProd = 1;
+	for(int mo : moduli)
+		modProd*=mo;
+	int topcap = Q.size();
+	for(const std::vector<int> & q : Q){
+		int max = 0;
+		for(int x : q)
+			if(x > max)
+				max = x;
+		topcap += max/modProd;
+	}
+
 	//Fill tree with variables and add clauses
-	std::vector<std::map<int,literal> >  D(moduli.size()+1);
+	std::vector<ValueLiterals> D;
+	for(int mo : moduli)
+		D.push_back(ValueLiterals(mo-1));
+	D.push_back(ValueLiterals(topcap));
 	nLevelsMTO(Q,X,0,Q.size(),moduli,D);
 
 	//Ensure sum(Q*X <= k)
@@ -1438,7 +1579,7 @@ void SMTFormula::baseSelectionMTO(const std::vector<std::vector<int> > & Q, int
 
 
 void SMTFormula::nLevelsMTO(const std::vector<std::vector<int> > & Q, const std::vector<std::vector<literal> > & X, int lIndex, int partSize, 
-	const std::vector<int> & moduli, std::vector<std::map<int,literal> > & D){
+	const std::vector<int> & moduli, std::vector<ValueLiterals> & D){
 	int n = moduli.size(); //Number of modulo
 	int m = partSize; //Number of variables
 
@@ -1450,7 +1591,7 @@ void SMTFormula::nLevelsMTO(const std::vector<std::vector<int> > & Q, const std:
 
 		std::vector<int> w = Q[lIndex];
 		for(int i = n; i >= 0; i--){
-			D[i][0]=trueVar();
+			D[i].set(0,trueVar());
 
 			std::map<int,bool> varWithCoefCreated;
 
@@ -1458,18 +1599,18 @@ void SMTFormula::nLevelsMTO(const std::vector<std::vector<int> > & Q, const std:
 				int wmod = w[j]/modProd;
 
 				if(wmod!=0){
-					if(D[i].find(wmod) == D[i].end()){
-						D[i][wmod] = X[lIndex][j]; //Initialize with the original variable itself
+					if(!D[i].contains(wmod)){
+						D[i].set(wmod,X[lIndex][j]); //Initialize with the original variable itself
 						varWithCoefCreated[wmod]=false;
 					}
 					else{
 						if(!varWithCoefCreated[wmod]){ //Replace original variable by a half-reified aux variable
 							boolvar v = newBoolVar();
-							addClause(!D[i][wmod] | v);
-							D[i][wmod] = v;
+							addClause(!D[i].get(wmod) | v);
+							D[i].set(wmod,v);
 							varWithCoefCreated[wmod]=true;
 						}
-						addClause(!X[lIndex][j] | D[i][wmod]);
+						addClause(!X[lIndex][j] | D[i].get(wmod));
 					}
 				}
 			}
@@ -1484,8 +1625,12 @@ void SMTFormula::nLevelsMTO(const std::vector<std::vector<int> > & Q, const std:
 
 	//Recursive case, branch in the binary tree
 	else{
-		std::vector<std::map<int,literal> >  Dleft(n+1);
-		std::vector<std::map<int,literal> >  Dright(n+1);
+		std::vector<ValueLiterals> Dleft;
+		std::vector<ValueLiterals> Dright;
+		for(const ValueLiterals & d : D){
+			Dleft.push_back(ValueLiterals(d.getValues().getCap()));
+			Dright.push_back(ValueLiterals(d.getValues().getCap()));
+		}
 
 		int lSize = m/2;
 		int rSize = m - m/2;
@@ -1502,19 +1647,13 @@ void SMTFormula::nLevelsMTO(const std::vector<std::vector<int> > & Q, const std:
 		for(int h = 0; h < n; h++){
 			prevLevelHasCarry = thisLevelHasCarry;
 			thisLevelHasCarry = false;
-			D[h][0] = trueVar();
+			D[h].set(0,trueVar());
 			c[h] = newBoolVar();
 
-			std::map<int,literal>::iterator i, j;
-
-			for(i = Dleft[h].begin(); i != Dleft[h].end(); i++){
-				for(j = Dright[h].begin(); j != Dright[h].end(); j++){
-					int wi = i->first;
-					literal xi = i->second;
-
-
-					int wj = j->first;
-					literal xj = j->second;
+			for(int wi = Dleft[h].next(0); wi != -1; wi = Dleft[h].next(wi+1)){
+				for(int wj = Dright[h].next(0); wj != -1; wj = Dright[h].next(wj+1)){
+					literal xi = Dleft[h].get(wi);
+					literal xj = Dright[h].get(wj);
 
 					int sum = wi + wj; 
 
@@ -1559,15 +1698,11 @@ void SMTFormula::nLevelsMTO(const std::vector<std::vector<int> > & Q, const std:
 		prevLevelHasCarry = thisLevelHasCarry;
 
 		//Clauses of the uppermost digits
-		D[n][0] = trueVar();
-		std::map<int,literal>::iterator i, j;
-		for(i = Dleft[n].begin(); i != Dleft[n].end(); i++){
-			for(j = Dright[n].begin(); j != Dright[n].end(); j++){
-				int wi = i->first;
-				literal xi = i->second;
-
-				int wj = j->first;
-				literal xj = j->second;
+		D[n].set(0,trueVar());
+		for(int wi = Dleft[n].next(0); wi != -1; wi = Dleft[n].next(wi+1)){
+			for(int wj = Dright[n].next(0); wj != -1; wj = Dright[n].next(wj+1)){
+				literal xi = Dleft[n].get(wi);
+				literal xj = Dright[n].get(wj);
 
 				int sum = wi + wj; 
 
@@ -1588,18 +1723,18 @@ void SMTFormula::nLevelsMTO(const std::vector<std::vector<int> > & Q, const std:
 
 }
 
-literal SMTFormula::MTOVar(std::map<int,literal> & m, int w){
-	if(m.find(w)==m.end()){
+literal SMTFormula::MTOVar(ValueLiterals & m, int w){
+	if(!m.contains(w)){
 		boolvar x = newBoolVar();
-		m[w]=x;
+		m.set(w,x);
 		return x;
 	}
 	else
-		return m[w];
+		return m.get(w);
 }
 
 
-void SMTFormula::comtMTO(int K, const std::vector<int> & moduli, const std::vector<std::map<int,literal> > & D,  literal * localLit){
+void SMTFormula::comtMTO(int K, const std::vector<int> & moduli, const std::vector<ValueLiterals> & D,  literal * localLit){
 
 	int n = moduli.size();
 	std::vector<int> k(n+1);
@@ -1621,15 +1756,13 @@ void SMTFormula::comtMTO(int K, const std::vector<int> & moduli, const std::vect
 
 	for(int i = n; i >= 0; i--){
 		if(i<n && k[i+1]!=0){
-			std::map<int,literal>::const_iterator it = D[i+1].find(k[i+1]);
-			if(it==D[i+1].end())
+			if(!D[i+1].contains(k[i+1]))
 				break; //If not possible to be equal in this level, no need to look at the folowing levels
 			else
-				c|= !it->second;
+				c|= !D[i+1].get(k[i+1]);
 		}
-		for(const std::pair<int,literal> & p : D[i])
-			if(p.first > k[i])
-				addClause(c | !p.second);
+		for(int w = D[i].next(k[i]+1); w != -1; w = D[i].next(w+1))
+			addClause(c | !D[i].get(w));
 	}
 }
 
@@ -2019,13 +2152,13 @@ void SMTFormula::addAMOPBReducedGeneralizedGeneralizedTotalizer(std::vector<std:
 
 
         for(int i = 0; i < n; i++) {
-        	tree[i] = RGGTNode();           
-            tree[i].values.push_back(0);
+        	tree[i] = RGGTNode(K+1);
+            tree[i].values.insert(0);
             todo[i] = tree + i;
             for(int j = 0; j < Q[i].size(); j++) {
                 if(Q[i][j]!=0 && (j==0 || Q[i][j]!=Q[i][j-1])) {
                     //  Non-zero coeff and different to previous coeff.
-                    tree[i].values.push_back(Q[i][j]);
+                    tree[i].values.insert(Q[i][j]);
                 }
             }
         }
@@ -2040,8 +2173,8 @@ void SMTFormula::addAMOPBReducedGeneralizedGeneralizedTotalizer(std::vector<std:
             	//If first, time, compute all the ratios
             	if(first_pass){
 	                for(int j=i+1; j<todo.size(); j++) {
-	                    std::vector<int> testvals;
-	                    mergeValues(todo[i]->values, todo[j]->values, testvals, K);
+	                    ValueSet testvals;
+	                    testvals.sum(todo[i]->values, todo[j]->values);
 	                    double rat=((double)testvals.size())/(todo[i]->values.size()*todo[j]->values.size());
 	                    cached_rat[std::pair<RGGTNode *,RGGTNode *>(todo[i], todo[j])] = rat;
 	                }
@@ -2049,8 +2182,8 @@ void SMTFormula::addAMOPBReducedGeneralizedGeneralizedTotalizer(std::vector<std:
 	            //Otherwise, there is only need to compute the ratio w.r.t. the newly inserted node
 	            else{
 	            	int j = todo.size()-1;
-	            	std::vector<int> testvals;
-	                mergeValues(todo[i]->values, todo[j]->values, testvals, K);
+	            	ValueSet testvals;
+	                testvals.sum(todo[i]->values, todo[j]->values);
 	                double rat=((double)testvals.size())/(todo[i]->values.size()*todo[j]->values.size());
 	                cached_rat[std::pair<RGGTNode *,RGGTNode *>(todo[i], todo[j])] = rat;
 	            }
@@ -2081,7 +2214,7 @@ void SMTFormula::addAMOPBReducedGeneralizedGeneralizedTotalizer(std::vector<std:
             todo[i1]->parent=n3;
             todo[i2]->parent=n3;
             
-            mergeValues(todo[i1]->values, todo[i2]->values, n3->values, K);  // Populate n3.values
+            n3->values.sum(todo[i1]->values, todo[i2]->values);  // Populate n3.values
            
             todo.erase(todo.begin()+i2);
             todo.erase(todo.begin()+i1);
@@ -2098,13 +2231,15 @@ void SMTFormula::addAMOPBReducedGeneralizedGeneralizedTotalizer(std::vector<std:
         //  Check the tree is not trivial here...
         
         
-        long lb=root->values[0];
-        long ub=root->values[root->values.size()-1];
+        std::vector<int> rootvals;
+        root->values.getValues(rootvals);
+        long lb=rootvals[0];
+        long ub=rootvals[rootvals.size()-1];
         if(ub==K+1) {
-            ub=root->values[root->values.size()-2];
+            ub=rootvals[rootvals.size()-2];
         }
         root->intervals.push_back(std::pair<int,int>(lb, ub));
-        if(root->values[root->values.size()-1]==K+1) {
+        if(rootvals[rootvals.size()-1]==K+1) {
             root->intervals.push_back(std::pair<int,int>(K+1, K+1));
         }
         
@@ -2185,16 +2320,6 @@ void SMTFormula::addAMOPBReducedGeneralizedGeneralizedTotalizer(std::vector<std:
     //  SAT variables correspond to intervals (>= lower bound ofinterval).
     
 
-    //Prints JORDI
-    int maxdepth=1;
-   	for(int i=tree_size-1; i>=0; i--) {
-        int depth = tree[i].fuoGetDepth();
-        if(depth>maxdepth)
-        	maxdepth=depth;
-    }
-    std::cerr << n <<";" << maxdepth << std::endl;
-    return;
-
     for(int i=n; i<tree_size; i++) {
         //assert tree[i].intervals[0].lower==0;
         tree[i].literals.push_back(trueVar());
@@ -2295,17 +2420,6 @@ void SMTFormula::addAMOPBReducedGeneralizedGeneralizedTotalizer(std::vector<std:
 
 }
 
-void SMTFormula::mergeValues(const std::vector<int> & n1, const std::vector<int> & n2, std::vector<int> & n3, int K) {
-	std::set<int> s;
-	for(int j=0; j < n1.size(); j++)
-		for(int k = 0; k < n2.size(); k++) 
-			s.insert(std::min(n1[j]+n2[k], K+1));
-	n3.clear();
-	n3.insert(n3.begin(),s.begin(),s.end());
-}
-
-
-
 void SMTFormula::addOrderEncoding(int x, std::vector<literal> & lits){
 
 	lits.resize(x);
@@ -2355,189 +2469,44 @@ void SMTFormula::addQuadraticMerge(const std::vector<literal> &x1, const std::ve
 }
 
 void SMTFormula::addMerge(const std::vector<literal> &x1, const std::vector<literal> &x2, std::vector<literal> &y, bool leqclauses, bool geqclauses){
-	int a = x1.size();
-	int b = x2.size();
-
-	if(a==0 && b==0){
-		y.clear();
-		return;
-	}
-
-	y.resize(a+b);
-
-	if(a==1 && b==1)
-		addTwoComparator(x1[0],x2[0],y[0],y[1],leqclauses,geqclauses);
-	else if(a == 0)
-		y = x2;
-	else if(b == 0)
-		y = x1;
-	else{
-		std::vector<literal> x1even, x1odd, x2even, x2odd;
-		for(int i = 0; i < a-1; i+=2){
-				x1even.push_back(x1[i]);
-				x1odd.push_back(x1[i+1]);
-		}
-		if(a%2==1)
-			x1even.push_back(x1[a-1]);
-
-		for(int i = 0; i < b-1; i+=2){
-				x2even.push_back(x2[i]);
-				x2odd.push_back(x2[i+1]);
-		}
-		if(b%2==1)
-			x2even.push_back(x2[b-1]);
-
-		std::vector<literal> zeven;
-		std::vector<literal> zodd;
-
-		addMerge(x1even, x2even, zeven,leqclauses,geqclauses);
-		addMerge(x1odd, x2odd,zodd,leqclauses,geqclauses);
-
-		std::vector<literal> z(a+b);
-		if(a%2==0){
-			if(b%2==0){
-				for(int i = 0; i < (a+b)/2; i++)
-					z[2*i] = zeven[i];
-
-				for(int i = 0; i < (a+b)/2; i++)
-					z[2*i + 1] = zodd[i];
-
-				y[0] = z[0];
-				y[a+b-1] = z[a+b-1];
-				for(int i = 1; i < a+b-2; i+=2)
-					addTwoComparator(z[i],z[i+1],y[i],y[i+1],leqclauses,geqclauses);
-
-			}else{
-				for(int i = 0; i < (a+b)/2 + 1; i++)
-					z[2*i] = zeven[i];
-
-				for(int i = 0; i < (a+b)/2; i++)
-					z[2*i + 1] = zodd[i];
-
-				y[0] = z[0];
-				for(int i = 1; i < a+b-1; i+=2)
-					addTwoComparator(z[i],z[i+1],y[i],y[i+1],leqclauses,geqclauses);
-
-			}
-		}
-		else{ //a%2==1
-			if(b%2==0)
-				addMerge(x2,x1,y,leqclauses,geqclauses);
-			else{
-				for(int i = 0; i < (a+1)/2; i++)
-					z[2*i] = zeven[i];
-				for(int i = 0; i < (b+1)/2; i++)
-					z[a + 2*i] = zeven[(a+1)/2 + i];
-
-				for(int i = 0; i < a/2; i++)
-					z[2*i+1] = zodd[i];
-				for(int i = 0; i < b/2; i++)
-					z[a + 2*i+1] = zodd[a/2 + i];
-
-				y[0] = z[0];
-				y[a+b-1] = z[a+b-1];
-				for(int i = 1; i < a+b-2; i+=2)
-					addTwoComparator(z[i],z[i+1],y[i],y[i+1],leqclauses,geqclauses);
-
-			}
-		}
-	}
+	std::vector<literal> x(x1);
+	x.insert(x.end(),x2.begin(),x2.end());
+	addComparatorNetwork(ComparatorNetwork::merge(x1.size(),x2.size()),x,y,leqclauses,geqclauses);
 }
 
 
 void SMTFormula::addSimplifiedMerge(const std::vector<literal> &x1, const std::vector<literal> &x2, std::vector<literal> &y, int c, bool leqclauses, bool geqclauses){
-	int a = x1.size();
-	int b = x2.size();
-
-	if(a==0 && b==0){
-		y.clear();
-		return;
-	}
-
-	if(c==0){
-		y.clear();
-		return;
-	}
-
-
-	if(a==1 && b==1 && c==1){
-		y.resize(c);
-		y[0] = newBoolVar();
-		if(leqclauses){
-			addClause(!x1[0] | y[0]);
-			addClause(!x2[0] | y[0]);
-		}
-		if(geqclauses)
-			addClause(x1[0] | x2[0] | !y[0]);
-	}
-	else if(a > c)
-		addSimplifiedMerge(std::vector<literal>(x1.begin(),x1.begin()+c),x2,y,c,leqclauses,geqclauses);
-	else if(b > c)
-		addSimplifiedMerge(x1,std::vector<literal>(x2.begin(),x2.begin()+c),y,c,leqclauses,geqclauses);
-	else if(a+b<=c)
-		addMerge(x1,x2,y,leqclauses,geqclauses);
-	else{
-		y.resize(c);
-		std::vector<literal> x1even, x1odd, x2even, x2odd;
-		for(int i = 0; i < a-1; i+=2){
-				x1even.push_back(x1[i]);
-				x1odd.push_back(x1[i+1]);
-		}
-		if(a%2==1)
-			x1even.push_back(x1[a-1]);
-
-		for(int i = 0; i < b-1; i+=2){
-				x2even.push_back(x2[i]);
-				x2odd.push_back(x2[i+1]);
-		}
-		if(b%2==1)
-			x2even.push_back(x2[b-1]);
-
-		std::vector<literal> zeven;
-		std::vector<literal> zodd;
-		std::vector<literal> z;
+	std::vector<literal> x(x1);
+	x.insert(x.end(),x2.begin(),x2.end());
+	addComparatorNetwork(ComparatorNetwork::simplifiedMerge(x1.size(),x2.size(),c),x,y,leqclauses,geqclauses);
+}
 
-		if(c%2==0){
-			addSimplifiedMerge(x1even, x2even, zeven, c/2 + 1,leqclauses,geqclauses);
-			addSimplifiedMerge(x1odd, x2odd, zodd, c/2,leqclauses,geqclauses);
+void SMTFormula::addComparatorNetwork(const ComparatorNetwork & net, const std::vector<literal> &x, std::vector<literal> &y, bool leqclauses, bool geqclauses){
+	std::vector<literal> wires(net.getNWires());
+	for(int i = 0; i < net.getNInputs(); i++)
+		wires[i] = x[i];
 
-			z.resize(c+1);
-			for(int i = 0; i < c/2; i++){
-				z[2*i] = zeven[i];
-				z[2*i +1] = zodd[i];
-			}
-			z[c] = zeven[c/2];
-
-			y[0] = z[0];
-			for(int i = 1; i < c-2; i+=2)
-				addTwoComparator(z[i],z[i+1],y[i],y[i+1],leqclauses,geqclauses);
-			y[c-1]=newBoolVar();
+	for(const Comparator & c : net.getComparators()){
+		if(c.out2 >= 0)
+			addTwoComparator(wires[c.in1],wires[c.in2],wires[c.out1],wires[c.out2],leqclauses,geqclauses);
+		else{
+			wires[c.out1] = newBoolVar();
 			if(leqclauses){
-				addClause(!z[c-1] | y[c-1]);
-				addClause(!z[c] | y[c-1]);
+				addClause(!wires[c.in1] | wires[c.out1]);
+				addClause(!wires[c.in2] | wires[c.out1]);
 			}
 			if(geqclauses)
-				addClause(z[c-1] | z[c] | !y[c-1]);
-
-		}
-		else{ //c%2==1
-			addSimplifiedMerge(x1even, x2even, zeven, (c+1)/2,leqclauses,geqclauses);
-			addSimplifiedMerge(x1odd, x2odd, zodd, (c-1)/2,leqclauses,geqclauses);
-
-			z.resize(c);
-			for(int i = 0; i < (c-1)/2; i++){
-				z[2*i] = zeven[i];
-				z[2*i +1] = zodd[i];
-			}
-			z[c-1] = zeven[(c-1)/2];
-
-			y[0] = z[0];
-			for(int i = 1; i < c-1; i+=2)
-				addTwoComparator(z[i],z[i+1],y[i],y[i+1],leqclauses,geqclauses);
+				addClause(wires[c.in1] | wires[c.in2] | !wires[c.out1]);
 		}
 	}
+
+	const std::vector<int> & outputs = net.getOutputs();
+	y.resize(outputs.size());
+	for(int i = 0; i < outputs.size(); i++)
+		y[i] = wires[outputs[i]];
 }
 
+
 //Pre:: ommitted node is never alone in x
 void SMTFormula::addTotalizer(const std::vector<literal> &x, const std::vector<std::pair<int,std::set<int> > > &inputBits, std::vector<literal> &y, int lIndex, 
 	int partSize, int ommittedLeaf,
@@ -2697,56 +2666,12 @@ void SMTFormula::addTotalizer(const std::vector<literal> &x, std::vector<literal
 }
 
 void SMTFormula::addSorting(const std::vector<literal> &x, std::vector<literal> &y, bool leqclauses, bool geqclauses){
-	//Codifies a mergesort
-	int n = x.size();
-
-	if(n==0){
-		y.clear();
-		return;
-	}
-
-	if(n==1)
-		y=x;
-	else if(n==2){
-		y.resize(2);
-		addTwoComparator(x[0],x[1],y[0],y[1],leqclauses,geqclauses);
-	}
-	else{
-		std::vector<literal> z1,z2;
-
-		std::vector<literal> x1 = std::vector<literal>(x.begin(), x.begin() + n/2);
-		std::vector<literal> x2 = std::vector<literal>(x.begin() + n/2, x.end());
-
-		addSorting(x1,z1,leqclauses,geqclauses);
-		addSorting(x2,z2,leqclauses,geqclauses);
-		addMerge(z1,z2,y,leqclauses,geqclauses);
-	}
+	addComparatorNetwork(ComparatorNetwork::sorting(x.size()),x,y,leqclauses,geqclauses);
 }
 
 
 void SMTFormula::addMCardinality(const std::vector<literal> &x, std::vector<literal> &y, int m, bool leqclauses, bool geqclauses){
-	//Codifies a mergesort
-	int n = x.size();
-	
-
-	if(m==0){
-		y.clear();
-		return;
-	}
-
-	if(n<=m){
-		addSorting(x,y,leqclauses,geqclauses);
-		return;
-	}
-
-	std::vector<literal> z1,z2;
-
-	std::vector<literal> x1 = std::vector<literal>(x.begin(), x.begin() + n/2);
-	std::vector<literal> x2 = std::vector<literal>(x.begin() + n/2, x.end());
-
-	addMCardinality(x1,z1,std::min(n/2,m),leqclauses,geqclauses);
-	addMCardinality(x2,z2,std::min(n-(n/2),m),leqclauses,geqclauses);
-	addSimplifiedMerge(z1,z2,y,m,leqclauses,geqclauses);
+	addComparatorNetwork(ComparatorNetwork::mCardinality(x.size(),m),x,y,leqclauses,geqclauses);
 }
 
 
@@ -2897,7 +2822,7 @@ void SMTFormula::addQuadraticMergeCardinality(const std::vector<literal> &x1, co
 }
 
 
-RGGTNode::RGGTNode()
+RGGTNode::RGGTNode(int cap) : values(cap)
 {
 	this->left = NULL;
 	this->right = NULL;
@@ -2934,17 +2859,21 @@ void RGGTNode::makeIntervals(int K, bool reduce)
         // Assumes parent already has a set of intervals. 
         // Uses values of the sibling. 
         
+        std::vector<int> vals;
+        values.getValues(vals);
+        std::vector<int> siblingvals;
+        (parent->left==this ? parent->right->values : parent->left->values).getValues(siblingvals);
+
         //  Singleton interval to start with.
-        intervals.push_back(std::pair<int,int>(values[0], values[0]));
+        intervals.push_back(std::pair<int,int>(vals[0], vals[0]));
         
         //  Iterate through values, checking each one 
-        for(int i=0; i<values.size()-1; i++) {
-            int lower=values[i];
-            int upper=values[i+1];
+        for(int i=0; i<vals.size()-1; i++) {
+            int lower=vals[i];
+            int upper=vals[i+1];
             
             bool split=false;
             
-            const std::vector<int> & siblingvals=(parent->left==this ? parent->right->values : parent->left->values); 
             for(int j=0; j<siblingvals.size(); j++) {
                 int sibval=siblingvals[j];
                 
@@ -2987,8 +2916,8 @@ void RGGTNode::makeIntervals(int K, bool reduce)
     }
     else {
         // Don't do reduction -- one interval for each value. 
-        for(int i=0; i<values.size(); i++) {
-            intervals.push_back(std::pair<int,int>(values[i], values[i]));
+        for(int v = values.next(0); v != -1; v = values.next(v+1)) {
+            intervals.push_back(std::pair<int,int>(v, v));
         }
     }
 }
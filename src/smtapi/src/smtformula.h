@@ -10,6 +10,8 @@
 #include "mdd.h"
 #include "smtapi.h"
 #include "mddbuilder.h"
+#include "valueset.h"
+#include "comparatornetwork.h"
 
 
 namespace smtapi{
@@ -99,7 +101,21 @@ enum AMOPBEncoding {
 	AMOPB_GGPW,
 	AMOPB_GLPW,
 	AMOPB_GGBM,
-	AMOPB_GLBM
+	AMOPB_GLBM,
+	AMOPB_LAZY, //Not encoded, checked during the search by the solver
+	AMOPB_AUTO, //Encoding of smallest predicted size, chosen for each constraint
+	AMOPB_DRYRUN //Not encoded, only the sizes of the encodings are predicted
+};
+
+//Predicted size of an encoded constraint
+struct AMOPBSize{
+	long long vars;
+	long long clauses;
+	bool truevar; //Also uses the true variable of the formula, one variable and one unit clause created once per formula
+
+	AMOPBSize(){vars = 0; clauses = 0; truevar = false;}
+
+	long long cost() const {return vars + clauses;}
 };
 
 extern std::map<AMOPBEncoding,PBEncoding> amopb_pb_rel;
@@ -110,11 +126,11 @@ struct RGGTNode{
 	RGGTNode *right;
 	RGGTNode *parent;
 
-	std::vector<int> values;
+	ValueSet values;
 	std::vector<std::pair<int,int> > intervals;
 	std::vector<literal> literals;
 
-	RGGTNode();
+	RGGTNode(int cap = 0);
 	RGGTNode(RGGTNode * left, RGGTNode * right);
 	
 	~RGGTNode();
@@ -142,6 +158,13 @@ private:
 	std::vector<clause> softclauses; //Vector of soft clauses. If non-empty, is a partial MaxSat problem
 	std::vector<int> weights; //Vector of weights of the soft clauses.
 	std::vector<intvar> softclausevars; //Vector of soft clauses.
+	std::vector<amopb> lazyamopbs; //AMO-PB constraints added with AMOPB_LAZY, not encoded into clauses
+	std::map<AMOPBEncoding,AMOPBSize> amopbpredictions; //Total predicted sizes of the AMO-PB constraints added with AMOPB_DRYRUN
+	std::map<AMOPBEncoding,int> amopbchoices; //Number of AMO-PB constraints for which AMOPB_AUTO chose each encoding
+
+	std::vector<arithcmp> atoms; //Distinct (in)equalities occurring in the clauses, indexed by id. Position 0 is unused
+	std::map<std::vector<int>,int> mapAtoms; //Map of atom ids by normalized (in)equality
+	std::vector<int> atomOccurrences; //Number of literals of each atom
 
 	std::map<std::string,boolvar> mapBoolVars; //Map of Boolean variables identified by name
 	std::map<std::string,intvar> mapIntVars; //Map of Int variables identified by name
@@ -174,12 +197,18 @@ private:
 
 	void addOrderEncoding(int x, std::vector<literal> & lits);
 
+	//Interns the arithmetic literals of 'c'
+	void internAtoms(clause & c);
+
 	//Adds the codification of Sorter [x1,x2] -> [y1,y2]
 	void addTwoComparator(const literal &x1, const literal &x2, literal &y1, literal &y2, bool leqclauses, bool geqclauses);
 
 	//Adds the codification of "y is the result of merging x1,x2". Used in cardinality constraint
 	void addSimplifiedMerge(const std::vector<literal> &x1, const std::vector<literal> &x2, std::vector<literal> &y, int c, bool leqclauses, bool geqclauses);
 
+	//Instantiates the comparators of 'net' over the inputs x, giving the outputs y
+	void addComparatorNetwork(const ComparatorNetwork & net, const std::vector<literal> &x, std::vector<literal> &y, bool leqclauses, bool geqclauses);
+
 	void addQuadraticMerge(const std::vector<literal> &x1, const std::vector<literal> &x2, std::vector<literal> &y);
 
 	void addTotalizer(const std::vector<literal> &x, std::vector<literal> &y);
@@ -209,17 +238,14 @@ private:
 	void addAMOPBGeneralizedTotalizer(const std::vector<std::vector<int> > & Q, const std::vector<std::vector<literal> > & X, int K);
 
 	void addAMOPBReducedGeneralizedGeneralizedTotalizer(std::vector<std::vector<int> >  Q, std::vector<std::vector<literal> > X, int K, bool reduce);
-	void mergeValues(const std::vector<int> & n1, const std::vector<int> & n2, std::vector<int> & n3, int K);
 
 
 	
 
-	literal MTOVar(std::map<int,literal> & m, int w);
+	literal MTOVar(ValueLiterals & m, int w);
 
 	
 
-	void baseSelectionMTO(const std::vector<std::vector<int> > & Q, int K, std::vector<int> & moduli);
-
 	void baseSelectionMTO2(const std::vector<std::vector<int> > & Q, int K, std::vector<int> & moduli);
 
 	void addAMOPBModuloTotalizer(const std::vector<std::vector<int> > & Q, const std::vector<std::vector<literal> > & X, int K);
@@ -233,6 +259,9 @@ private:
 
 	void addAMOPBGlobalPolynomialWatchdog(const std::vector<std::vector<int> > & Q, const std::vector<std::vector<literal> > & X, int K, bool useSorter);
 
+	//Adds a predicted size to a total, counting the true variable once if the formula does not have it yet
+	void addAMOPBPrediction(AMOPBSize & total, const AMOPBSize & size) const;
+
 
 	std::string ssubs(const std::string & var, int i1) const;
 	std::string ssubs(const std::string & var, int i1, int i2) const;
@@ -241,10 +270,13 @@ private:
 
 public:
 
-	void comtMTO(int K, const std::vector<int> & moduli, const std::vector<std::map<int,literal> > & D, literal * localLit);
+	//Moduli of the digits of the modulo totalizer of sum(Q*X) <= K
+	static void baseSelectionMTO(const std::vector<std::vector<int> > & Q, int K, std::vector<int> & moduli);
+
+	void comtMTO(int K, const std::vector<int> & moduli, const std::vector<ValueLiterals> & D, literal * localLit);
 
 	void nLevelsMTO(const std::vector<std::vector<int> > & Q, const std::vector<std::vector<literal> > & X, int lIndex, int partSize, 
-	const std::vector<int> & moduli, std::vector<std::map<int,literal> > & D);
+	const std::vector<int> & moduli, std::vector<ValueLiterals> & D);
 
 	//Default constructor
 	SMTFormula();
@@ -263,10 +295,31 @@ public:
 
 	int getNClauses() const;
 
+	//Normalizes the (in)equality of the arithmetic literal 'l' (sorted variables, positive
+	//first coefficient, sign flipped if needed) and sets the id of its atom
+	void internAtom(literal & l);
+
+	int getNAtoms() const;
+
+	const std::vector<arithcmp> & getAtoms() const;
+
+	int getAtomOccurrences(int id) const;
+
 	int getNSoftClauses() const;
 
 	const std::vector<clause> & getClauses() const;
 
+	int getNLazyAMOPBs() const;
+
+	const std::vector<amopb> & getLazyAMOPBs() const;
+
+	//Total predicted sizes, by encoding, of the AMO-PB constraints added with AMOPB_DRYRUN.
+	//The entry of AMOPB_AUTO is the total of the encodings it would choose
+	const std::map<AMOPBEncoding,AMOPBSize> & getAMOPBPredictions() const;
+
+	//Number of AMO-PB constraints for which AMOPB_AUTO chose (or would choose) each encoding
+	const std::map<AMOPBEncoding,int> & getAMOPBChoices() const;
+
 	const std::vector<clause> & getSoftClauses() const;
 
 	const std::vector<int> & getWeights() const;
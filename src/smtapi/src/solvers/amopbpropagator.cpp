@@ -0,0 +1,146 @@
+#include "amopbpropagator.h"
+#include <algorithm>
+
+using namespace Glucose;
+
+
+static bool decreasingCoef(const std::pair<int,Lit> & a, const std::pair<int,Lit> & b){
+	return a.first > b.first;
+}
+
+AMOPBPropagator::AMOPBPropagator(){
+	impliedc = -1;
+	nextimplied = 0;
+}
+
+void AMOPBPropagator::addConstraint(const std::vector<Lit> & x, const std::vector<int> & q, int K){
+	int c = this->K.size();
+	this->K.push_back(K);
+	load.push_back(0);
+	trueterms.push_back(std::vector<std::pair<int,Lit> >());
+	terms.push_back(std::vector<std::pair<int,Lit> >());
+	isdirty.push_back(false);
+
+	for(int i = 0; i < x.size(); i++){
+		int l = toInt(x[i]);
+		if((l|1) >= occurrences.size()){
+			occurrences.resize((l|1)+1);
+			value.resize((l|1)+1,0);
+		}
+		Term t;
+		t.c = c;
+		t.q = q[i];
+		occurrences[l].push_back(t);
+		terms[c].push_back(std::make_pair(q[i],x[i]));
+	}
+	std::stable_sort(terms[c].begin(),terms[c].end(),decreasingCoef);
+}
+
+bool AMOPBPropagator::isAssigned(Lit l) const{
+	return value[toInt(l)] || value[toInt(~l)];
+}
+
+void AMOPBPropagator::explain(int c, int sum, const std::vector<std::pair<int,Lit> > & sortedtrue, vec<Lit> & clause){
+	for(int i = 0; i < sortedtrue.size() && sum <= K[c]; i++){
+		clause.push(~sortedtrue[i].second);
+		sum += sortedtrue[i].first;
+	}
+}
+
+bool AMOPBPropagator::assign(Lit p, int pos, vec<Lit> & explanation){
+	int l = toInt(p);
+	if(l >= occurrences.size())
+		return true;
+
+	const std::vector<Term> & occs = occurrences[l];
+
+	int overloaded = -1;
+	for(const Term & t : occs){
+		load[t.c] += t.q;
+		if(load[t.c] > K[t.c])
+			overloaded = t.c;
+	}
+
+	if(overloaded != -1){
+		for(const Term & t : occs)
+			load[t.c] -= t.q;
+
+		//'p' and the largest true terms that exceed the capacity together with it
+		int c = overloaded;
+		int sum = 0;
+		for(const Term & t : occs)
+			if(t.c == c)
+				sum += t.q;
+		std::vector<std::pair<int,Lit> > sorted(trueterms[c]);
+		std::sort(sorted.begin(),sorted.end(),decreasingCoef);
+		explanation.push(~p);
+		explain(c,sum,sorted,explanation);
+		return false;
+	}
+
+	value[l] = 1;
+	assignedlits.push_back(std::make_pair(pos,l));
+	for(const Term & t : occs){
+		trueterms[t.c].push_back(std::make_pair(t.q,p));
+		assigned.push_back(std::make_pair(pos,t.c));
+		if(!isdirty[t.c]){
+			isdirty[t.c] = true;
+			dirty.push_back(t.c);
+		}
+	}
+	return true;
+}
+
+bool AMOPBPropagator::nextImplication(vec<Lit> & clause){
+	while(nextimplied < implied.size() || !dirty.empty()){
+		if(nextimplied == implied.size()){
+			//Terms of the next constraint that no longer fit
+			int c = dirty.back();
+			dirty.pop_back();
+			isdirty[c] = false;
+
+			implied.clear();
+			nextimplied = 0;
+			int slack = K[c] - load[c];
+			for(const std::pair<int,Lit> & t : terms[c]){
+				if(t.first <= slack)
+					break;
+				if(!isAssigned(t.second))
+					implied.push_back(t);
+			}
+			if(!implied.empty()){
+				impliedc = c;
+				sortedtrue = trueterms[c];
+				std::sort(sortedtrue.begin(),sortedtrue.end(),decreasingCoef);
+			}
+			continue;
+		}
+
+		const std::pair<int,Lit> & t = implied[nextimplied++];
+		clause.clear();
+		clause.push(~t.second);
+		explain(impliedc,t.first,sortedtrue,clause);
+		return true;
+	}
+	return false;
+}
+
+void AMOPBPropagator::backtrack(int pos){
+	while(!assigned.empty() && assigned.back().first >= pos){
+		int c = assigned.back().second;
+		load[c] -= trueterms[c].back().first;
+		trueterms[c].pop_back();
+		assigned.pop_back();
+	}
+	while(!assignedlits.empty() && assignedlits.back().first >= pos){
+		value[assignedlits.back().second] = 0;
+		assignedlits.pop_back();
+	}
+
+	for(int c : dirty)
+		isdirty[c] = false;
+	dirty.clear();
+	implied.clear();
+	nextimplied = 0;
+}
+
@@ -0,0 +1,67 @@
+#ifndef AMOPBPROPAGATOR_DEFINITION
+#define AMOPBPROPAGATOR_DEFINITION
+
+#include "glucose/core/Theory.h"
+#include <vector>
+#include <utility>
+
+
+/*
+ * Lazy pseudo-Boolean constraints sum(q_i*x_i) <= K for glucose, e.g.
+ * the resource capacities of a timetable. No clause is generated up
+ * front: the load of each constraint is updated as its literals are
+ * assigned. The terms that no longer fit in the remaining capacity are
+ * propagated to false, and each propagation or conflict is explained
+ * by the largest true terms of the constraint that exceed the capacity.
+ */
+class AMOPBPropagator : public Glucose::Theory {
+
+private:
+
+	struct Term {
+		int c; //Constraint
+		int q; //Coefficient
+	};
+
+	std::vector<std::vector<Term> > occurrences; //Terms of each literal, indexed by toInt(lit)
+	std::vector<std::vector<std::pair<int,Glucose::Lit> > > terms; //(q,lit) terms of each constraint, decreasing q
+	std::vector<int> K;
+	std::vector<int> load; //Sum of the coefficients of the true terms of each constraint
+	std::vector<std::vector<std::pair<int,Glucose::Lit> > > trueterms; //(q,lit) true terms of each constraint
+	std::vector<std::pair<int,int> > assigned; //(trail position,constraint) of each true term, in trail order
+
+	std::vector<char> value; //1 iff the literal is assigned true, indexed by toInt(lit)
+	std::vector<std::pair<int,int> > assignedlits; //(trail position,toInt(lit)) of the literals set in 'value'
+
+	//Pending implications
+	std::vector<int> dirty; //Constraints whose load has increased
+	std::vector<char> isdirty;
+	int impliedc; //Constraint of the implied literals
+	std::vector<std::pair<int,Glucose::Lit> > implied; //(q,lit) terms to falsify
+	int nextimplied;
+	std::vector<std::pair<int,Glucose::Lit> > sortedtrue; //True terms of 'impliedc', decreasing q
+
+	//Adds to 'clause' the negation of the largest true terms of constraint 'c' until their sum
+	//plus 'sum' exceeds its capacity
+	void explain(int c, int sum, const std::vector<std::pair<int,Glucose::Lit> > & sortedtrue, Glucose::vec<Glucose::Lit> & clause);
+
+	bool isAssigned(Glucose::Lit l) const;
+
+public:
+
+	//Constructor
+	AMOPBPropagator();
+
+	//Adds the constraint sum(q[i]*x[i]) <= K, with 0 < q[i] <= K
+	void addConstraint(const std::vector<Glucose::Lit> & x, const std::vector<int> & q, int K);
+
+	bool assign(Glucose::Lit p, int pos, Glucose::vec<Glucose::Lit> & explanation);
+
+	bool nextImplication(Glucose::vec<Glucose::Lit> & clause);
+
+	void backtrack(int pos);
+
+};
+
+#endif
+
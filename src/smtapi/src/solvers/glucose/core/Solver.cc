@@ -175,6 +175,7 @@ verbosity(0)
 , watchesBin(WatcherDeleted(ca))
 , unaryWatches(WatcherDeleted(ca))
 , qhead(0)
+, theory_qhead(0)
 , simpDB_assigns(-1)
 , simpDB_props(0)
 , order_heap(VarOrderLt(activity))
@@ -260,6 +261,7 @@ Solver::Solver(const Solver &s) :
 , watchesBin(WatcherDeleted(ca))
 , unaryWatches(WatcherDeleted(ca))
 , qhead(s.qhead)
+, theory_qhead(0)
 , simpDB_assigns(s.simpDB_assigns)
 , simpDB_props(s.simpDB_props)
 , order_heap(VarOrderLt(activity))
@@ -666,6 +668,12 @@ void Solver::cancelUntil(int level) {
             insertVarOrder(x);
         }
         qhead = trail_lim[level];
+        // The theories before the one that failed may have seen trail[theory_qhead]
+        if(theory_qhead >= trail_lim[level]) {
+            for(int i = 0; i < theories.size(); i++)
+                theories[i]->backtrack(trail_lim[level]);
+            theory_qhead = trail_lim[level];
+        }
         trail.shrink(trail.size() - trail_lim[level]);
         trail_lim.shrink(trail_lim.size() - level);
     }
@@ -1152,6 +1160,112 @@ CRef Solver::propagate() {
 }
 
 
+/*_________________________________________________________________________________________________
+|
+|  propagateTheory : [void]  ->  [Clause*]
+|
+|  Description:
+|    Gives the literals of the trail not yet seen to the attached theories, and then enqueues the
+|    literals they imply, with their explanations learnt as reason clauses. On a theory conflict,
+|    the explanation is learnt as a clause and returned as the conflicting clause. If none of
+|    its literals is at the current decision level, the solver first backtracks to the highest
+|    level among them, so that it can be analyzed as any other conflict. Explanations of a single
+|    literal hold at every level: the solver backtracks to level 0 and enqueues that literal there,
+|    or becomes inconsistent ('ok = false') if it is already false at level 0.
+|
+|  Post-conditions:
+|    * the theories have seen the whole trail, unless a conflict is returned, literals have
+|      been enqueued (then 'qhead < trail.size()') or the solver is inconsistent.
+|________________________________________________________________________________________________@*/
+
+CRef Solver::propagateTheory() {
+    while(theory_qhead < trail.size()) {
+        bool consistent = true;
+        theory_expl.clear();
+        for(int i = 0; i < theories.size() && consistent; i++)
+            consistent = theories[i]->assign(trail[theory_qhead], theory_qhead, theory_expl);
+        if(consistent) {
+            theory_qhead++;
+            continue;
+        }
+        return theoryConflict(theory_expl);
+    }
+
+    for(int i = 0; i < theories.size(); i++) {
+        while(theories[i]->nextImplication(theory_expl)) {
+            vec<Lit> &c = theory_expl;
+            if(value(c[0]) == l_True)
+                continue;
+            if(value(c[0]) == l_False || c.size() == 1)
+                return theoryConflict(c);
+
+            // The implied literal is watched with the false literal of highest level
+            int max = 1;
+            for(int j = 2; j < c.size(); j++)
+                if(level(var(c[j])) > level(var(c[max])))
+                    max = j;
+            Lit tmp = c[1];
+            c[1] = c[max], c[max] = tmp;
+
+            uncheckedEnqueue(c[0], addTheoryClause(c));
+        }
+    }
+
+    return CRef_Undef;
+}
+
+
+CRef Solver::theoryConflict(vec<Lit> &c) {
+    // A unit explanation does not depend on the decisions, it is asserted at level 0
+    if(c.size() < 2) {
+        cancelUntil(0);
+        if(c.size() == 1 && value(c[0]) == l_Undef)
+            uncheckedEnqueue(c[0]);
+        else
+            ok = false;
+        return CRef_Undef;
+    }
+
+    // Watch the two literals of highest level
+    for(int i = 0; i < 2; i++) {
+        int max = i;
+        for(int j = i + 1; j < c.size(); j++)
+            if(level(var(c[j])) > level(var(c[max])))
+                max = j;
+        Lit tmp = c[i];
+        c[i] = c[max], c[max] = tmp;
+    }
+
+    if(level(var(c[0])) < decisionLevel())
+        cancelUntil(level(var(c[0])));
+
+    return addTheoryClause(c);
+}
+
+
+CRef Solver::addTheoryClause(const vec<Lit> &c) {
+    CRef cr = ca.alloc(c, true);
+    ca[cr].setLBD(computeLBD(ca[cr]));
+    ca[cr].setOneWatched(false);
+#ifdef INCREMENTAL
+    ca[cr].setSizeWithoutSelectors(c.size());
+#endif
+    learnts.push(cr);
+    attachClause(cr);
+    return cr;
+}
+
+
+void Solver::addTheory(Theory * t) {
+    // All the theories are given the trail again from the beginning
+    cancelUntil(0);
+    for(int i = 0; i < theories.size(); i++)
+        theories[i]->backtrack(0);
+    theories.push(t);
+    theory_qhead = 0;
+}
+
+
 /*_________________________________________________________________________________________________
 |
 |  propagateUnaryWatches : [Lit]  ->  [Clause*]
@@ -1487,7 +1601,15 @@ lbool Solver::search(int nof_conflicts) {
                 return l_False;
 
         }
-        CRef confl = propagate();
+        CRef confl;
+        do {
+            confl = propagate();
+            if(confl == CRef_Undef)
+                confl = propagateTheory();
+        } while(confl == CRef_Undef && qhead < trail.size() && ok);
+
+        if(!ok)
+            return l_False;
 
         if(confl != CRef_Undef) {
             newDescent = false;
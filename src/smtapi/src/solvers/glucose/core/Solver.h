@@ -58,6 +58,7 @@ OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWA
 #include "glucose/core/Constants.h"
 #include "glucose/mtl/Clone.h"
 #include "glucose/core/SolverStats.h"
+#include "glucose/core/Theory.h"
 
 
 namespace Glucose {
@@ -133,6 +134,10 @@ public:
     bool    solve        (Lit p);                   // Search for a model that respects a single assumption.
     bool    solve        (Lit p, Lit q);            // Search for a model that respects two assumptions.
     bool    solve        (Lit p, Lit q, Lit r);     // Search for a model that respects three assumptions.
+
+    // Theory reasoning:
+    //
+    void    addTheory    (Theory * t);              // Attach a theory propagator, checked after each unit propagation. Not owned.
     bool    okay         () const;                  // FALSE means solver is in a conflicting state
 
        // Convenience versions of 'toDimacs()':
@@ -153,6 +158,7 @@ public:
     // 
     void    setPolarity    (Var v, bool b); // Declare which polarity the decision heuristic should use for a variable. Requires mode 'polarity_user'.
     void    setDecisionVar (Var v, bool b); // Declare if a variable should be eligible for selection in the decision heuristic.
+    void    bumpActivity   (Var v);         // Increase the activity of a variable as if it took part in a conflict.
 
     // Read state:
     //
@@ -344,6 +350,9 @@ protected:
     vec<int>            trail_lim;        // Separator indices for different decision levels in 'trail'.
     vec<VarData>        vardata;          // Stores reason and level for each variable.
     int                 qhead;            // Head of queue (as index into the trail -- no more explicit propagation queue in MiniSat).
+    vec<Theory*>        theories;         // Attached theory propagators.
+    int                 theory_qhead;     // Head of the theory queue (as index into the trail).
+    vec<Lit>            theory_expl;      // Explanation of the last theory conflict.
     int                 simpDB_assigns;   // Number of top-level assignments since last execution of 'simplify()'.
     int64_t             simpDB_props;     // Remaining number of propagations that must be made before next execution of 'simplify()'.
     vec<Lit>            assumptions;      // Current set of assumptions provided to solve by the user.
@@ -403,6 +412,9 @@ protected:
     void     uncheckedEnqueue (Lit p, CRef from = CRef_Undef);                         // Enqueue a literal. Assumes value of literal is undefined.
     bool     enqueue          (Lit p, CRef from = CRef_Undef);                         // FileTest if fact 'p' contradicts current state, enqueue otherwise.
     CRef     propagate        ();                                                      // Perform unit propagation. Returns possibly conflicting clause.
+    CRef     propagateTheory  ();                                                      // Give the new trail literals to the theories and enqueue the implied ones. Returns possibly conflicting clause.
+    CRef     theoryConflict   (vec<Lit>& c);                                           // Learn the theory conflict 'c', backtracking to its highest level. Returns the conflicting clause.
+    CRef     addTheoryClause  (const vec<Lit>& c);                                     // Learn the theory clause 'c', watching its first two literals.
     CRef     propagateUnaryWatches(Lit p);                                                  // Perform propagation on unary watches of p, can find only conflicts
     void     cancelUntil      (int level);                                             // Backtrack until a certain level.
     void     analyze          (CRef confl, vec<Lit>& out_learnt, vec<Lit> & selectors, int& out_btlevel,unsigned int &nblevels,unsigned int &szWithoutSelectors);    // (bt = backtrack)
@@ -531,6 +543,7 @@ inline int      Solver::nFreeVars     ()         {
     int a = stats[dec_vars];
     return (int)(a) - (trail_lim.size() == 0 ? trail.size() : trail_lim[0]); }
 inline void     Solver::setPolarity   (Var v, bool b) { polarity[v] = b; }
+inline void     Solver::bumpActivity  (Var v)         { varBumpActivity(v); }
 inline void     Solver::setDecisionVar(Var v, bool b) 
 { 
     if      ( b && !decision[v]) stats[dec_vars]++;
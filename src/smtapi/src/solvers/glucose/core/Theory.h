@@ -0,0 +1,37 @@
+/***************************************************************************************[Theory.h]
+ Theory propagator interface. A theory attached to the solver is given every
+ literal of the trail after unit propagation, and is backtracked together
+ with the trail. On a theory conflict it explains it with a set of currently
+ false literals, that the solver learns as a clause. Implied literals are
+ explained in the same way, and their explanations become their reasons.
+ **************************************************************************************************/
+
+#ifndef Glucose_Theory_h
+#define Glucose_Theory_h
+
+#include "glucose/mtl/Vec.h"
+#include "glucose/core/SolverTypes.h"
+
+namespace Glucose {
+
+class Theory {
+public:
+    virtual ~Theory() {}
+
+    // Literal 'p' has been assigned at position 'pos' of the trail. Returns false if it is
+    // inconsistent with the theory, filling 'explanation' with literals that are false in the
+    // current assignment and such that at least one of them must hold. 'p' is then not asserted.
+    virtual bool assign(Lit p, int pos, vec<Lit> & explanation) = 0;
+
+    // Returns in 'clause' the next literal implied by the assignments so far, followed by
+    // false literals that explain it. False if there are no more implied literals.
+    virtual bool nextImplication(vec<Lit> & clause) { return false; }
+
+    // Undo the assignments at positions 'pos' and above of the trail, and discard the
+    // pending implications.
+    virtual void backtrack(int pos) = 0;
+};
+
+}
+
+#endif
@@ -0,0 +1,150 @@
+#include "idlpropagator.h"
+#include <algorithm>
+#include <functional>
+
+using namespace Glucose;
+
+
+IDLPropagator::IDLPropagator(){
+	setNNodes(1);
+}
+
+void IDLPropagator::setNNodes(int n){
+	if(n <= (int)pi.size())
+		return;
+	pi.resize(n,0);
+	out.resize(n);
+	gamma.resize(n,0);
+	newpi.resize(n,0);
+	pred.resize(n,-1);
+	done.resize(n,false);
+}
+
+void IDLPropagator::addAtom(Var v, int x, int y, int k){
+	if(v >= (int)atomOfVar.size())
+		atomOfVar.resize(v+1,-1);
+	atomOfVar[v] = atoms.size();
+	Atom a;
+	a.x = x;
+	a.y = y;
+	a.k = k;
+	atoms.push_back(a);
+	setNNodes(std::max(x,y)+1);
+}
+
+bool IDLPropagator::assign(Lit p, int pos, vec<Lit> & explanation){
+	Var v = var(p);
+	if(v >= (int)atomOfVar.size() || atomOfVar[v] < 0)
+		return true;
+
+	//x - y <= k, or y - x <= -k-1 if negated
+	const Atom & a = atoms[atomOfVar[v]];
+	Edge e;
+	e.lit = p;
+	e.pos = pos;
+	if(!sign(p)){
+		e.from = a.y;
+		e.to = a.x;
+		e.weight = a.k;
+	}
+	else{
+		e.from = a.x;
+		e.to = a.y;
+		e.weight = -a.k-1;
+	}
+	edges.push_back(e);
+
+	if(!activateLastEdge(explanation)){
+		edges.pop_back();
+		return false;
+	}
+	return true;
+}
+
+bool IDLPropagator::activateLastEdge(vec<Lit> & explanation){
+	int id = edges.size()-1;
+	const Edge & e = edges[id];
+
+	if(pi[e.to] <= pi[e.from] + e.weight){
+		out[e.from].push_back(id);
+		return true;
+	}
+
+	//Decrease the values reachable from e.to, most violated first.
+	//Reaching e.from again means a negative cycle through the new edge
+	std::greater<std::pair<int,int> > cmp;
+	bool conflict = false;
+
+	gamma[e.to] = pi[e.from] + e.weight - pi[e.to];
+	pred[e.to] = id;
+	touched.push_back(e.to);
+	heap.push_back(std::make_pair(gamma[e.to],e.to));
+
+	while(!heap.empty() && !conflict){
+		std::pop_heap(heap.begin(),heap.end(),cmp);
+		int s = heap.back().second;
+		int g = heap.back().first;
+		heap.pop_back();
+		if(done[s] || g != gamma[s])
+			continue;
+
+		done[s] = true;
+		newpi[s] = pi[s] + gamma[s];
+		for(int fid : out[s]){
+			const Edge & f = edges[fid];
+			int t = f.to;
+			if(done[t])
+				continue;
+			int d = newpi[s] + f.weight - pi[t];
+			if(d < gamma[t]){
+				if(gamma[t] == 0)
+					touched.push_back(t);
+				gamma[t] = d;
+				pred[t] = fid;
+				if(t == e.from){
+					conflict = true;
+					break;
+				}
+				heap.push_back(std::make_pair(d,t));
+				std::push_heap(heap.begin(),heap.end(),cmp);
+			}
+		}
+	}
+
+	if(conflict){
+		int n = e.from;
+		int fid;
+		do{
+			fid = pred[n];
+			explanation.push(~edges[fid].lit);
+			n = edges[fid].from;
+		}while(fid != id);
+	}
+
+	for(int n : touched){
+		if(!conflict && done[n])
+			pi[n] = newpi[n];
+		gamma[n] = 0;
+		done[n] = false;
+	}
+	touched.clear();
+	heap.clear();
+
+	if(!conflict)
+		out[e.from].push_back(id);
+	return !conflict;
+}
+
+void IDLPropagator::backtrack(int pos){
+	//Edges are removed in reverse order, so they are the last ones of their lists.
+	//Values remain feasible when constraints are removed
+	while(!edges.empty() && edges.back().pos >= pos){
+		out[edges.back().from].pop_back();
+		edges.pop_back();
+	}
+}
+
+int IDLPropagator::getValue(int node) const{
+	return pi[node] - pi[0];
+}
+
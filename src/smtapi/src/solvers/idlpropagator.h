@@ -0,0 +1,75 @@
+#ifndef IDLPROPAGATOR_DEFINITION
+#define IDLPROPAGATOR_DEFINITION
+
+#include "glucose/core/Theory.h"
+#include <vector>
+#include <utility>
+
+
+/*
+ * Integer difference logic theory for glucose. Each atom is a Boolean
+ * variable equivalent to x - y <= k between two nodes, node 0 being
+ * the constant 0. Assigned atoms are the edges of a constraint graph
+ * (y->x with weight k if true, x->y with weight -k-1 if false), and a
+ * feasible value of the nodes is kept incrementally as in Cotton and
+ * Maler: a new edge only relaxes the nodes whose value must decrease.
+ * A negative cycle is reported as the negation of its atoms.
+ */
+class IDLPropagator : public Glucose::Theory {
+
+private:
+
+	struct Edge {
+		int from;
+		int to;
+		int weight;
+		Glucose::Lit lit;
+		int pos; //Position of 'lit' in the trail
+	};
+
+	struct Atom {
+		int x;
+		int y;
+		int k;
+	};
+
+	std::vector<int> atomOfVar; //Index in 'atoms' of each glucose variable, -1 if not an atom
+	std::vector<Atom> atoms;
+
+	std::vector<int> pi; //Value of each node
+	std::vector<std::vector<int> > out; //Active edges leaving each node
+	std::vector<Edge> edges; //Active edges, in trail order
+
+	//Temporaries of the relaxation
+	std::vector<int> gamma;
+	std::vector<int> newpi;
+	std::vector<int> pred;
+	std::vector<bool> done;
+	std::vector<int> touched;
+	std::vector<std::pair<int,int> > heap; //(gamma,node), min-heap with outdated entries
+
+	//Activates edge edges.back(). False if it closes a negative cycle, whose atoms are added to 'explanation'
+	bool activateLastEdge(Glucose::vec<Glucose::Lit> & explanation);
+
+public:
+
+	//Constructor. Only the zero node exists
+	IDLPropagator();
+
+	//Ensures that nodes 0..n-1 exist
+	void setNNodes(int n);
+
+	//Declares variable 'v' equivalent to x - y <= k
+	void addAtom(Glucose::Var v, int x, int y, int k);
+
+	bool assign(Glucose::Lit p, int pos, Glucose::vec<Glucose::Lit> & explanation);
+
+	void backtrack(int pos);
+
+	//Value of 'node' in the last consistent assignment, relative to the zero node
+	int getValue(int node) const;
+
+};
+
+#endif
+
@@ -0,0 +1,133 @@
+#include "bitmatrix.h"
+#include <algorithm>
+#include <thread>
+
+
+BitMatrix::BitMatrix(int nrows, int ncols){
+	this->nrows = nrows;
+	this->ncols = ncols;
+	this->nwords = (ncols+63)/64;
+	words.resize((size_t)nrows*nwords,0);
+}
+
+int BitMatrix::getNRows() const{
+	return nrows;
+}
+
+int BitMatrix::getNCols() const{
+	return ncols;
+}
+
+int BitMatrix::getNWords() const{
+	return nwords;
+}
+
+bool BitMatrix::get(int i, int j) const{
+	return (words[(size_t)i*nwords + j/64] >> (j%64)) & 1;
+}
+
+void BitMatrix::set(int i, int j, bool b){
+	uint64_t & w = words[(size_t)i*nwords + j/64];
+	if(b)
+		w |= (uint64_t)1 << (j%64);
+	else
+		w &= ~((uint64_t)1 << (j%64));
+}
+
+void BitMatrix::clear(){
+	std::fill(words.begin(),words.end(),0);
+}
+
+long long BitMatrix::count() const{
+	long long n = 0;
+	for(uint64_t w : words)
+		n += __builtin_popcountll(w);
+	return n;
+}
+
+uint64_t * BitMatrix::getRow(int i){
+	return words.data() + (size_t)i*nwords;
+}
+
+const uint64_t * BitMatrix::getRow(int i) const{
+	return words.data() + (size_t)i*nwords;
+}
+
+long long BitMatrix::orColumnsAtLeast(const std::vector<int> & keys, const std::vector<int> & thresholds){
+	return orColumnsByThreshold(keys,thresholds,true);
+}
+
+long long BitMatrix::orColumnsBelow(const std::vector<int> & keys, const std::vector<int> & thresholds){
+	return orColumnsByThreshold(keys,thresholds,false);
+}
+
+long long BitMatrix::orColumnsByThreshold(const std::vector<int> & keys, const std::vector<int> & thresholds, bool atleast){
+	std::vector<int> cols(ncols);
+	for(int j = 0; j < ncols; j++)
+		cols[j] = j;
+	std::sort(cols.begin(),cols.end(),[&](int a, int b){return keys[a] < keys[b];});
+	std::vector<int> sorted(ncols);
+	for(int j = 0; j < ncols; j++)
+		sorted[j] = keys[cols[j]];
+
+	std::vector<int> ts(thresholds.begin(),thresholds.begin()+nrows);
+	std::sort(ts.begin(),ts.end());
+	ts.erase(std::unique(ts.begin(),ts.end()),ts.end());
+
+	//Column set of each distinct threshold. The sets grow along the sweep, from
+	//the largest threshold down for 'atleast', and from the smallest one up otherwise
+	std::vector<uint64_t> sets(ts.size()*nwords,0);
+	std::vector<uint64_t> acc(nwords,0);
+	int nts = ts.size();
+	int p = atleast ? ncols : 0;
+	for(int k = 0; k < nts; k++){
+		int t = atleast ? nts-1-k : k;
+		if(atleast){
+			for(; p > 0 && sorted[p-1] >= ts[t]; p--)
+				acc[cols[p-1]/64] |= (uint64_t)1 << (cols[p-1]%64);
+		}
+		else{
+			for(; p < ncols && sorted[p] < ts[t]; p++)
+				acc[cols[p]/64] |= (uint64_t)1 << (cols[p]%64);
+		}
+		std::copy(acc.begin(),acc.end(),sets.begin()+(size_t)t*nwords);
+	}
+
+	std::vector<long long> counts(nrows);
+	forRowBlocks(nrows,[&](int begin, int end){
+		for(int i = begin; i < end; i++){
+			int t = std::lower_bound(ts.begin(),ts.end(),thresholds[i]) - ts.begin();
+			const uint64_t * s = sets.data() + (size_t)t*nwords;
+			uint64_t * row = getRow(i);
+			for(int w = 0; w < nwords; w++)
+				row[w] |= s[w];
+
+			int first = std::lower_bound(sorted.begin(),sorted.end(),thresholds[i]) - sorted.begin();
+			counts[i] = atleast ? ncols - first : first;
+			if(i < ncols && (s[i/64] >> (i%64)) & 1){
+				row[i/64] &= ~((uint64_t)1 << (i%64));
+				counts[i]--;
+			}
+		}
+	});
+
+	long long n = 0;
+	for(long long c : counts)
+		n += c;
+	return n;
+}
+
+void BitMatrix::forRowBlocks(int nrows, const std::function<void(int,int)> & f){
+	int nthreads = std::thread::hardware_concurrency();
+	if(nrows < parallelrows || nthreads <= 1){
+		f(0,nrows);
+		return;
+	}
+
+	int block = (nrows + nthreads - 1) / nthreads;
+	std::vector<std::thread> threads;
+	for(int begin = 0; begin < nrows; begin += block)
+		threads.push_back(std::thread(f,begin,std::min(begin+block,nrows)));
+	for(std::thread & th : threads)
+		th.join();
+}
@@ -0,0 +1,68 @@
+#ifndef BITMATRIX_DEFINITION
+#define BITMATRIX_DEFINITION
+
+#include <vector>
+#include <functional>
+#include <stdint.h>
+
+
+/*
+ * Matrix of bits, stored by rows of 64-bit words. The threshold kernels
+ * set, in every row i, the columns j whose key is at least (or below)
+ * the threshold of row i. They sort the columns by key once, build the
+ * column set of each distinct threshold in a single sweep over the sorted
+ * keys, and OR it word by word into the rows, instead of comparing every
+ * pair. Large matrices are processed by blocks of rows in parallel.
+ */
+class BitMatrix{
+
+private:
+
+	int nrows;
+	int ncols;
+	int nwords; //Words per row
+	std::vector<uint64_t> words;
+
+	long long orColumnsByThreshold(const std::vector<int> & keys, const std::vector<int> & thresholds, bool atleast);
+
+public:
+
+	//Rows below which the kernels run in a single thread
+	static const int parallelrows = 2048;
+
+	//Matrix of 'nrows' x 'ncols' unset bits
+	BitMatrix(int nrows = 0, int ncols = 0);
+
+	int getNRows() const;
+	int getNCols() const;
+	int getNWords() const;
+
+	bool get(int i, int j) const;
+
+	void set(int i, int j, bool b = true);
+
+	//Unsets all the bits
+	void clear();
+
+	//Number of set bits
+	long long count() const;
+
+	//Words of row i. The bits beyond the last column must be kept unset
+	uint64_t * getRow(int i);
+	const uint64_t * getRow(int i) const;
+
+	//Sets, in each row i, the columns j != i with keys[j] >= thresholds[i].
+	//Returns the number of such pairs (i,j), whether or not they were already set
+	long long orColumnsAtLeast(const std::vector<int> & keys, const std::vector<int> & thresholds);
+
+	//Sets, in each row i, the columns j != i with keys[j] < thresholds[i].
+	//Returns the number of such pairs (i,j), whether or not they were already set
+	long long orColumnsBelow(const std::vector<int> & keys, const std::vector<int> & thresholds);
+
+	//Calls f(begin,end) on consecutive blocks of the rows [0,nrows), in parallel if
+	//there are at least 'parallelrows'. Each call must only write its own rows
+	static void forRowBlocks(int nrows, const std::function<void(int,int)> & f);
+
+};
+
+#endif
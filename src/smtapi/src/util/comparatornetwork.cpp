@@ -0,0 +1,327 @@
+#include "comparatornetwork.h"
+#include <map>
+#include <mutex>
+#include <algorithm>
+
+
+enum NetworkKind{
+	NET_SORTING,
+	NET_MCARDINALITY,
+	NET_MERGE,
+	NET_SIMPLIFIEDMERGE
+};
+
+ComparatorNetwork::ComparatorNetwork(int ninputs){
+	this->ninputs = ninputs;
+	this->nwires = ninputs;
+}
+
+int ComparatorNetwork::getNInputs() const{
+	return ninputs;
+}
+
+int ComparatorNetwork::getNWires() const{
+	return nwires;
+}
+
+const std::vector<Comparator> & ComparatorNetwork::getComparators() const{
+	return comparators;
+}
+
+const std::vector<int> & ComparatorNetwork::getOutputs() const{
+	return outputs;
+}
+
+int ComparatorNetwork::newWire(){
+	return nwires++;
+}
+
+void ComparatorNetwork::addComparator(int x1, int x2, int & y1, int & y2){
+	Comparator c;
+	c.in1 = x1;
+	c.in2 = x2;
+	c.out1 = y1 = newWire();
+	c.out2 = y2 = newWire();
+	comparators.push_back(c);
+}
+
+void ComparatorNetwork::addHalfComparator(int x1, int x2, int & y){
+	Comparator c;
+	c.in1 = x1;
+	c.in2 = x2;
+	c.out1 = y = newWire();
+	c.out2 = -1;
+	comparators.push_back(c);
+}
+
+const ComparatorNetwork & ComparatorNetwork::cached(int kind, int a, int b, int c){
+	static std::map<std::vector<int>, ComparatorNetwork *> networks;
+	static std::mutex mtx;
+
+	std::lock_guard<std::mutex> lock(mtx);
+	std::vector<int> key = {kind,a,b,c};
+	std::map<std::vector<int>, ComparatorNetwork *>::iterator it = networks.find(key);
+	if(it != networks.end())
+		return *(it->second);
+
+	ComparatorNetwork * net = new ComparatorNetwork(a+b);
+	std::vector<int> x1(a), x2(b);
+	for(int i = 0; i < a; i++)
+		x1[i] = i;
+	for(int i = 0; i < b; i++)
+		x2[i] = a+i;
+
+	switch(kind){
+		case NET_SORTING:
+			net->buildSorting(x1,net->outputs);
+			break;
+		case NET_MCARDINALITY:
+			net->buildMCardinality(x1,net->outputs,c);
+			break;
+		case NET_MERGE:
+			net->buildMerge(x1,x2,net->outputs);
+			break;
+		case NET_SIMPLIFIEDMERGE:
+			net->buildSimplifiedMerge(x1,x2,net->outputs,c);
+			break;
+	}
+
+	networks[key] = net;
+	return *net;
+}
+
+const ComparatorNetwork & ComparatorNetwork::sorting(int n){
+	return cached(NET_SORTING,n,0,0);
+}
+
+const ComparatorNetwork & ComparatorNetwork::mCardinality(int n, int m){
+	return cached(NET_MCARDINALITY,n,0,m);
+}
+
+const ComparatorNetwork & ComparatorNetwork::merge(int a, int b){
+	return cached(NET_MERGE,a,b,0);
+}
+
+const ComparatorNetwork & ComparatorNetwork::simplifiedMerge(int a, int b, int c){
+	return cached(NET_SIMPLIFIEDMERGE,a,b,c);
+}
+
+
+//The builders below follow the recursive constructions of the networks,
+//so the comparators are listed in the order the literals were created
+
+void ComparatorNetwork::buildSorting(const std::vector<int> & x, std::vector<int> & y){
+	//Codifies a mergesort
+	int n = x.size();
+
+	if(n==0){
+		y.clear();
+		return;
+	}
+
+	if(n==1)
+		y=x;
+	else if(n==2){
+		y.resize(2);
+		addComparator(x[0],x[1],y[0],y[1]);
+	}
+	else{
+		std::vector<int> z1,z2;
+
+		std::vector<int> x1 = std::vector<int>(x.begin(), x.begin() + n/2);
+		std::vector<int> x2 = std::vector<int>(x.begin() + n/2, x.end());
+
+		buildSorting(x1,z1);
+		buildSorting(x2,z2);
+		buildMerge(z1,z2,y);
+	}
+}
+
+void ComparatorNetwork::buildMCardinality(const std::vector<int> & x, std::vector<int> & y, int m){
+	int n = x.size();
+
+	if(m==0){
+		y.clear();
+		return;
+	}
+
+	if(n<=m){
+		buildSorting(x,y);
+		return;
+	}
+
+	std::vector<int> z1,z2;
+
+	std::vector<int> x1 = std::vector<int>(x.begin(), x.begin() + n/2);
+	std::vector<int> x2 = std::vector<int>(x.begin() + n/2, x.end());
+
+	buildMCardinality(x1,z1,std::min(n/2,m));
+	buildMCardinality(x2,z2,std::min(n-(n/2),m));
+	buildSimplifiedMerge(z1,z2,y,m);
+}
+
+void ComparatorNetwork::buildMerge(const std::vector<int> & x1, const std::vector<int> & x2, std::vector<int> & y){
+	int a = x1.size();
+	int b = x2.size();
+
+	if(a==0 && b==0){
+		y.clear();
+		return;
+	}
+
+	y.resize(a+b);
+
+	if(a==1 && b==1)
+		addComparator(x1[0],x2[0],y[0],y[1]);
+	else if(a == 0)
+		y = x2;
+	else if(b == 0)
+		y = x1;
+	else if(a%2==1 && b%2==0) //Swap the inputs, so that a is even or both are odd
+		buildMerge(x2,x1,y);
+	else{
+		std::vector<int> x1even, x1odd, x2even, x2odd;
+		for(int i = 0; i < a-1; i+=2){
+			x1even.push_back(x1[i]);
+			x1odd.push_back(x1[i+1]);
+		}
+		if(a%2==1)
+			x1even.push_back(x1[a-1]);
+
+		for(int i = 0; i < b-1; i+=2){
+			x2even.push_back(x2[i]);
+			x2odd.push_back(x2[i+1]);
+		}
+		if(b%2==1)
+			x2even.push_back(x2[b-1]);
+
+		std::vector<int> zeven;
+		std::vector<int> zodd;
+
+		buildMerge(x1even, x2even, zeven);
+		buildMerge(x1odd, x2odd, zodd);
+
+		std::vector<int> z(a+b);
+		if(a%2==0){
+			if(b%2==0){
+				for(int i = 0; i < (a+b)/2; i++)
+					z[2*i] = zeven[i];
+
+				for(int i = 0; i < (a+b)/2; i++)
+					z[2*i + 1] = zodd[i];
+
+				y[0] = z[0];
+				y[a+b-1] = z[a+b-1];
+				for(int i = 1; i < a+b-2; i+=2)
+					addComparator(z[i],z[i+1],y[i],y[i+1]);
+
+			}else{
+				for(int i = 0; i < (a+b)/2 + 1; i++)
+					z[2*i] = zeven[i];
+
+				for(int i = 0; i < (a+b)/2; i++)
+					z[2*i + 1] = zodd[i];
+
+				y[0] = z[0];
+				for(int i = 1; i < a+b-1; i+=2)
+					addComparator(z[i],z[i+1],y[i],y[i+1]);
+
+			}
+		}
+		else{ //a%2==1 && b%2==1
+			for(int i = 0; i < (a+1)/2; i++)
+				z[2*i] = zeven[i];
+			for(int i = 0; i < (b+1)/2; i++)
+				z[a + 2*i] = zeven[(a+1)/2 + i];
+
+			for(int i = 0; i < a/2; i++)
+				z[2*i+1] = zodd[i];
+			for(int i = 0; i < b/2; i++)
+				z[a + 2*i+1] = zodd[a/2 + i];
+
+			y[0] = z[0];
+			y[a+b-1] = z[a+b-1];
+			for(int i = 1; i < a+b-2; i+=2)
+				addComparator(z[i],z[i+1],y[i],y[i+1]);
+		}
+	}
+}
+
+void ComparatorNetwork::buildSimplifiedMerge(const std::vector<int> & x1, const std::vector<int> & x2, std::vector<int> & y, int c){
+	int a = x1.size();
+	int b = x2.size();
+
+	if(a==0 && b==0){
+		y.clear();
+		return;
+	}
+
+	if(c==0){
+		y.clear();
+		return;
+	}
+
+	if(a==1 && b==1 && c==1){
+		y.resize(c);
+		addHalfComparator(x1[0],x2[0],y[0]);
+	}
+	else if(a > c)
+		buildSimplifiedMerge(std::vector<int>(x1.begin(),x1.begin()+c),x2,y,c);
+	else if(b > c)
+		buildSimplifiedMerge(x1,std::vector<int>(x2.begin(),x2.begin()+c),y,c);
+	else if(a+b<=c)
+		buildMerge(x1,x2,y);
+	else{
+		y.resize(c);
+		std::vector<int> x1even, x1odd, x2even, x2odd;
+		for(int i = 0; i < a-1; i+=2){
+			x1even.push_back(x1[i]);
+			x1odd.push_back(x1[i+1]);
+		}
+		if(a%2==1)
+			x1even.push_back(x1[a-1]);
+
+		for(int i = 0; i < b-1; i+=2){
+			x2even.push_back(x2[i]);
+			x2odd.push_back(x2[i+1]);
+		}
+		if(b%2==1)
+			x2even.push_back(x2[b-1]);
+
+		std::vector<int> zeven;
+		std::vector<int> zodd;
+		std::vector<int> z;
+
+		if(c%2==0){
+			buildSimplifiedMerge(x1even, x2even, zeven, c/2 + 1);
+			buildSimplifiedMerge(x1odd, x2odd, zodd, c/2);
+
+			z.resize(c+1);
+			for(int i = 0; i < c/2; i++){
+				z[2*i] = zeven[i];
+				z[2*i +1] = zodd[i];
+			}
+			z[c] = zeven[c/2];
+
+			y[0] = z[0];
+			for(int i = 1; i < c-2; i+=2)
+				addComparator(z[i],z[i+1],y[i],y[i+1]);
+			addHalfComparator(z[c-1],z[c],y[c-1]);
+		}
+		else{ //c%2==1
+			buildSimplifiedMerge(x1even, x2even, zeven, (c+1)/2);
+			buildSimplifiedMerge(x1odd, x2odd, zodd, (c-1)/2);
+
+			z.resize(c);
+			for(int i = 0; i < (c-1)/2; i++){
+				z[2*i] = zeven[i];
+				z[2*i +1] = zodd[i];
+			}
+			z[c-1] = zeven[(c-1)/2];
+
+			y[0] = z[0];
+			for(int i = 1; i < c-1; i+=2)
+				addComparator(z[i],z[i+1],y[i],y[i+1]);
+		}
+	}
+}
@@ -0,0 +1,77 @@
+#ifndef COMPARATORNETWORK_DEFINITION
+#define COMPARATORNETWORK_DEFINITION
+
+#include <vector>
+
+
+/*
+ * Comparator of a network. Wires 'in1' and 'in2' are sorted decreasingly
+ * into the new wires 'out1' (their OR) and 'out2' (their AND). A half
+ * comparator only has the OR output, and 'out2' is -1.
+ */
+struct Comparator{
+	int in1;
+	int in2;
+	int out1;
+	int out2;
+};
+
+
+/*
+ * Layout of the odd-even sorting and merge networks used by the
+ * cardinality and AMO-PB encodings, as a flat list of comparators over
+ * integer wires. The first wires are the inputs, and every comparator
+ * defines one or two new wires, so instantiating a network is a single
+ * pass over its comparators. Layouts only depend on the shape of the
+ * network (its input and output sizes), not on the direction of the
+ * clauses, and are built once and cached for the whole execution.
+ */
+class ComparatorNetwork{
+
+private:
+
+	int ninputs;
+	int nwires;
+	std::vector<Comparator> comparators;
+	std::vector<int> outputs;
+
+	ComparatorNetwork(int ninputs);
+
+	int newWire();
+	void addComparator(int x1, int x2, int & y1, int & y2);
+	void addHalfComparator(int x1, int x2, int & y);
+
+	void buildSorting(const std::vector<int> & x, std::vector<int> & y);
+	void buildMCardinality(const std::vector<int> & x, std::vector<int> & y, int m);
+	void buildMerge(const std::vector<int> & x1, const std::vector<int> & x2, std::vector<int> & y);
+	void buildSimplifiedMerge(const std::vector<int> & x1, const std::vector<int> & x2, std::vector<int> & y, int c);
+
+	//Network of the given kind and sizes, built on the first request
+	static const ComparatorNetwork & cached(int kind, int a, int b, int c);
+
+public:
+
+	int getNInputs() const;
+
+	int getNWires() const;
+
+	const std::vector<Comparator> & getComparators() const;
+
+	//Wires of the outputs, sorted decreasingly. An output can be an input wire
+	const std::vector<int> & getOutputs() const;
+
+	//Sorts n inputs
+	static const ComparatorNetwork & sorting(int n);
+
+	//First m outputs of the sorting of n inputs. If n <= m, the n outputs
+	static const ComparatorNetwork & mCardinality(int n, int m);
+
+	//Merges the sorted inputs [0,a) and [a,a+b)
+	static const ComparatorNetwork & merge(int a, int b);
+
+	//First c outputs of the merge of the sorted inputs [0,a) and [a,a+b)
+	static const ComparatorNetwork & simplifiedMerge(int a, int b, int c);
+
+};
+
+#endif
@@ -0,0 +1,154 @@
+#include "valueset.h"
+#include <algorithm>
+
+
+ValueSet::ValueSet(int cap){
+	this->cap = cap;
+	words.resize(cap/64+1,0);
+	ranksvalid = false;
+}
+
+int ValueSet::getCap() const{
+	return cap;
+}
+
+void ValueSet::insert(int v){
+	if(v > cap)
+		v = cap;
+	words[v>>6] |= (uint64_t)1 << (v&63);
+	ranksvalid = false;
+}
+
+bool ValueSet::contains(int v) const{
+	if(v < 0 || v > cap)
+		return false;
+	return (words[v>>6] >> (v&63)) & 1;
+}
+
+void ValueSet::clear(){
+	for(uint64_t & w : words)
+		w = 0;
+	ranksvalid = false;
+}
+
+bool ValueSet::empty() const{
+	for(uint64_t w : words)
+		if(w)
+			return false;
+	return true;
+}
+
+int ValueSet::size() const{
+	int n = 0;
+	for(uint64_t w : words)
+		n += __builtin_popcountll(w);
+	return n;
+}
+
+int ValueSet::next(int v) const{
+	if(v < 0)
+		v = 0;
+	if(v > cap)
+		return -1;
+	int w = v>>6;
+	uint64_t bits = words[w] & (~(uint64_t)0 << (v&63));
+	while(!bits){
+		w++;
+		if(w == words.size())
+			return -1;
+		bits = words[w];
+	}
+	return (w<<6) + __builtin_ctzll(bits);
+}
+
+int ValueSet::max() const{
+	for(int w = words.size()-1; w >= 0; w--)
+		if(words[w])
+			return (w<<6) + 63 - __builtin_clzll(words[w]);
+	return -1;
+}
+
+int ValueSet::rank(int v) const{
+	if(v <= 0)
+		return 0;
+	if(v > cap)
+		return size();
+	if(!ranksvalid){
+		ranks.resize(words.size());
+		int n = 0;
+		for(int w = 0; w < words.size(); w++){
+			ranks[w] = n;
+			n += __builtin_popcountll(words[w]);
+		}
+		ranksvalid = true;
+	}
+	int w = v>>6;
+	return ranks[w] + __builtin_popcountll(words[w] & (((uint64_t)1 << (v&63)) - 1));
+}
+
+void ValueSet::orShifted(const ValueSet & s, int shift){
+	//Values that reach the cap
+	if(s.next(cap-shift) != -1)
+		words[cap>>6] |= (uint64_t)1 << (cap&63);
+
+	int ws = shift>>6;
+	int bs = shift&63;
+	int nwords = words.size();
+	for(int i = 0; i < s.words.size() && i+ws < nwords; i++){
+		uint64_t w = s.words[i];
+		if(!w)
+			continue;
+		words[i+ws] |= w << bs;
+		if(bs && i+ws+1 < nwords)
+			words[i+ws+1] |= w >> (64-bs);
+	}
+
+	//Discard the bits above the cap, already saturated
+	if((cap&63) != 63)
+		words[nwords-1] &= ((uint64_t)1 << ((cap&63)+1)) - 1;
+}
+
+void ValueSet::sum(const ValueSet & a, const ValueSet & b){
+	const ValueSet & small = a.size() <= b.size() ? a : b;
+	const ValueSet & large = a.size() <= b.size() ? b : a;
+
+	ValueSet res(a.cap);
+	for(int v = small.next(0); v != -1; v = small.next(v+1))
+		res.orShifted(large,v);
+	*this = res;
+}
+
+void ValueSet::getValues(std::vector<int> & v, bool decreasing) const{
+	v.clear();
+	for(int x = next(0); x != -1; x = next(x+1))
+		v.push_back(x);
+	if(decreasing)
+		for(int i = 0, j = v.size()-1; i < j; i++, j--)
+			std::swap(v[i],v[j]);
+}
+
+
+ValueLiterals::ValueLiterals(int cap) : values(cap){
+	lits.resize(cap+1);
+}
+
+const ValueSet & ValueLiterals::getValues() const{
+	return values;
+}
+
+bool ValueLiterals::contains(int v) const{
+	return values.contains(v);
+}
+
+const literal & ValueLiterals::get(int v) const{
+	return lits[v];
+}
+
+void ValueLiterals::set(int v, const literal & l){
+	values.insert(v);
+	lits[v] = l;
+}
+
+int ValueLiterals::next(int v) const{
+	return values.next(v);
+}
@@ -0,0 +1,96 @@
+#ifndef VALUESET_DEFINITION
+#define VALUESET_DEFINITION
+
+#include <vector>
+#include <stdint.h>
+#include "smtapi.h"
+
+using namespace smtapi;
+
+
+/*
+ * Set of the integer values in [0,cap], stored as a bitset. Inserting a
+ * value greater than cap inserts cap, as the sums of coefficients above
+ * the capacity K of a constraint are all equivalent to K+1. The sum set
+ * of two sets is computed word by word, with one shifted OR of the
+ * largest set for each value of the smallest one.
+ */
+class ValueSet{
+
+private:
+
+	int cap;
+	std::vector<uint64_t> words;
+
+	//Number of values in the words before each one, rebuilt on demand
+	mutable std::vector<int> ranks;
+	mutable bool ranksvalid;
+
+	//ORs into 'words' the values of 's' plus 'shift', saturated to cap
+	void orShifted(const ValueSet & s, int shift);
+
+public:
+
+	//Empty set of values in [0,cap]
+	ValueSet(int cap = 0);
+
+	int getCap() const;
+
+	void insert(int v);
+
+	bool contains(int v) const;
+
+	void clear();
+
+	bool empty() const;
+
+	int size() const;
+
+	//Smallest value >= v in the set, -1 if none
+	int next(int v) const;
+
+	//Largest value in the set, -1 if empty
+	int max() const;
+
+	//Number of values in the set smaller than v
+	int rank(int v) const;
+
+	//Replaces the set by {min(x+y,cap) : x in a, y in b}. The cap is the one of 'a'
+	void sum(const ValueSet & a, const ValueSet & b);
+
+	//Values in the set, in increasing or decreasing order
+	void getValues(std::vector<int> & v, bool decreasing = false) const;
+
+};
+
+
+/*
+ * Map from values in [0,cap] to literals, stored densely by value.
+ * Iteration over the defined values follows their increasing order.
+ */
+class ValueLiterals{
+
+private:
+
+	ValueSet values;
+	std::vector<literal> lits;
+
+public:
+
+	ValueLiterals(int cap = 0);
+
+	const ValueSet & getValues() const;
+
+	bool contains(int v) const;
+
+	//Literal of value 'v', which must be defined
+	const literal & get(int v) const;
+
+	void set(int v, const literal & l);
+
+	//Smallest defined value >= v, -1 if none
+	int next(int v) const;
+
+};
+
+#endif